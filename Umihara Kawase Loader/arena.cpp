@@ -0,0 +1,85 @@
+#include "includes.h"
+
+std::atomic< Arena * > Arena::s_current        = nullptr;
+std::atomic< ulong_t > Arena::s_current_thread = 0;
+
+NOINLINE Arena::Arena() : m_block{ nullptr }, m_cur{ nullptr }, m_end{ nullptr }, m_next_size{ MIN_BLOCK_SIZE }, m_alloc_count{ 0 }, m_alloc_size{ 0 }, m_block_count{ 0 }, m_block_size{ 0 } {
+
+}
+
+NOINLINE void Arena::add_block( size_t size, size_t align ) {
+    // room for the header and worst case alignment
+    const auto needed = sizeof( Block ) + size + align;
+
+    const auto block_size = std::max( m_next_size, needed );
+
+    // note: throws like any other heap allocation on failure
+    const auto block = (Block *)( std::pmr::new_delete_resource()->allocate( block_size, alignof( Block ) ) );
+
+    block->m_prev = m_block;
+    block->m_size = block_size;
+
+    m_block = block;
+    m_cur   = (uint8_t *)( block + 1 );
+    m_end   = (uint8_t *)block + block_size;
+
+    m_next_size = std::min( m_next_size * 2, MAX_BLOCK_SIZE );
+
+    ++m_block_count;
+    m_block_size += block_size;
+}
+
+NOINLINE void *Arena::do_allocate( size_t size, size_t align ) {
+    const auto aligned = []( uint8_t *ptr, size_t align ) {
+        return (uint8_t *)( ( (uintptr_t)ptr + ( align - 1 ) ) & ~(uintptr_t)( align - 1 ) );
+    };
+
+    auto out = aligned( m_cur, align );
+
+    // doesn't fit, get a new block
+    if( !m_block || out + size > m_end ) {
+        add_block( size, align );
+
+        out = aligned( m_cur, align );
+    }
+
+    m_cur = out + size;
+
+    ++m_alloc_count;
+    m_alloc_size += size;
+
+    return out;
+}
+
+NOINLINE void Arena::release() {
+    while( m_block ) {
+        const auto prev = m_block->m_prev;
+
+        std::pmr::new_delete_resource()->deallocate( m_block, m_block->m_size, alignof( Block ) );
+
+        m_block = prev;
+    }
+
+    m_cur       = nullptr;
+    m_end       = nullptr;
+    m_next_size = MIN_BLOCK_SIZE;
+}
+
+NOINLINE Arena::Scope::Scope( Arena &arena ) : m_prev{ s_current.load() }, m_prev_thread{ s_current_thread.load() } {
+    s_current_thread = GetCurrentThreadId();
+    s_current        = &arena;
+}
+
+NOINLINE Arena::Scope::~Scope() {
+    s_current        = m_prev;
+    s_current_thread = m_prev_thread;
+}
+
+NOINLINE std::pmr::memory_resource *Arena::get_current() {
+    const auto current = s_current.load();
+
+    if( current && s_current_thread.load() == GetCurrentThreadId() )
+        return current;
+
+    return std::pmr::get_default_resource();
+}
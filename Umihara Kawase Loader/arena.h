@@ -0,0 +1,105 @@
+#pragma once
+
+//
+// bump allocator for short-lived data
+// deallocations are ignored, everything is freed at once by release() or when the arena goes away
+//
+// note: not thread-safe, an arena belongs to the thread that made its Scope
+//
+
+class Arena : public std::pmr::memory_resource {
+private:
+    // first block size, each new block is twice as big as the last (up to MAX_BLOCK_SIZE)
+    static constexpr size_t MIN_BLOCK_SIZE = 64 * 1024;
+    static constexpr size_t MAX_BLOCK_SIZE = 1024 * 1024;
+
+    // block header, blocks are a singly-linked list
+    class Block {
+    public:
+        Block  *m_prev;
+        size_t m_size;
+    };
+
+    // current block and bump pointer
+    Block   *m_block;
+    uint8_t *m_cur;
+    uint8_t *m_end;
+
+    // next block size
+    size_t m_next_size;
+
+    // stats
+    size_t m_alloc_count;
+    size_t m_alloc_size;
+    size_t m_block_count;
+    size_t m_block_size;
+
+    // arena in scope and the thread that owns it
+    static std::atomic< Arena * > s_current;
+    static std::atomic< ulong_t > s_current_thread;
+
+    // get a new block that fits at least size bytes
+    NOINLINE void add_block( size_t size, size_t align );
+
+protected:
+    NOINLINE void *do_allocate( size_t size, size_t align ) override;
+
+    FORCEINLINE void do_deallocate( void *, size_t, size_t ) override {
+
+    }
+
+    FORCEINLINE bool do_is_equal( const std::pmr::memory_resource &other ) const noexcept override {
+        return this == &other;
+    }
+
+public:
+    NOINLINE Arena();
+
+    FORCEINLINE ~Arena() override {
+        release();
+    }
+
+    Arena( const Arena & )             = delete;
+    Arena &operator =( const Arena & ) = delete;
+
+    // free every block
+    NOINLINE void release();
+
+    // amount / bytes of allocations made
+    FORCEINLINE size_t get_alloc_count() const {
+        return m_alloc_count;
+    }
+
+    FORCEINLINE size_t get_alloc_size() const {
+        return m_alloc_size;
+    }
+
+    // amount / bytes of blocks taken from the heap
+    FORCEINLINE size_t get_block_count() const {
+        return m_block_count;
+    }
+
+    FORCEINLINE size_t get_block_size() const {
+        return m_block_size;
+    }
+
+    //
+    // makes an arena the current one for the calling thread while in scope
+    //
+
+    class Scope {
+    private:
+        Arena   *m_prev;
+        ulong_t m_prev_thread;
+
+    public:
+        NOINLINE Scope( Arena &arena );
+        NOINLINE ~Scope();
+
+        Scope( const Scope & )             = delete;
+        Scope &operator =( const Scope & ) = delete;
+    };
+
+    // arena in scope on the calling thread, or the default resource on other threads / with no scope
+    static NOINLINE std::pmr::memory_resource *get_current();
+};
@@ -8,18 +8,28 @@ namespace PatternScan {
 
     namespace Build {
 
-        Pattern::Pattern( std::string_view str ) : m_pattern{} {
-            std::string token;
-
+        Pattern::Pattern( std::string_view str, std::pmr::memory_resource *resource ) : m_pattern{ resource } {
             if( str.empty() )
                 return;
 
-            // construct str stream
-            auto sstream = std::istringstream( str.data() );
+            const auto is_hex = []( char c ) {
+                return std::isxdigit( (uint8_t)c ) != 0;
+            };
+
+            // every token is at least 2 chars with the space
+            m_pattern.reserve( ( str.size() + 1 ) / 2 );
 
             // iterate each token
             // split strings by space
-            while( std::getline( sstream, token, ' ' ) ) {
+            for( size_t pos = 0; pos < str.size(); ) {
+                auto end = str.find( ' ', pos );
+                if( end == std::string_view::npos )
+                    end = str.size();
+
+                const auto token = str.substr( pos, end - pos );
+
+                pos = end + 1;
+
                 // skip if byte / wildcard is too long
                 const auto size = token.size();
                 if( !size || size > 2 ) {
@@ -35,29 +45,20 @@ namespace PatternScan {
 
                 // check for byte
                 else {
-                    // not a valid byte yet
-                    auto is_valid_byte = false;
-
-                    // 1 char
-                    if( size == 1 && std::isxdigit( (uint8_t)token[ 0 ] ) )
-                        is_valid_byte = true;
-
-                    // 2 chars
-                    else if( size == 2 && std::isxdigit( (uint8_t)token[ 0 ] ) && std::isxdigit( (uint8_t)token[ 1 ] ) )
-                        is_valid_byte = true;
-
                     // not a valid byte
-                    if( !is_valid_byte ) {
+                    if( !std::all_of( token.begin(), token.end(), is_hex ) ) {
                         m_pattern.clear();
 
                         break;
                     }
 
                     // now put into the vector
-                    m_pattern.emplace_back(
-                        (uint8_t)( std::strtoul( token.c_str(), nullptr, 16 ) ),
-                        false
-                    );
+                    uint8_t byte = 0;
+
+                    for( const auto c : token )
+                        byte = (uint8_t)( ( byte << 4 ) | ( ( c <= '9' ) ? c - '0' : ( c | 0x20 ) - 'a' + 10 ) );
+
+                    m_pattern.emplace_back( byte, false );
                 }
             }
         }
@@ -48,7 +48,7 @@ namespace PatternScan {
         class Pattern {
         private:
             // types
-            using container_t       = std::vector< PatternByte >;
+            using container_t       = std::pmr::vector< PatternByte >;
             using container_citer_t = container_t::const_iterator;
 
             // vector for our pattern bytes
@@ -57,7 +57,8 @@ namespace PatternScan {
         public:
             Pattern() = default;
 
-            NOINLINE Pattern( std::string_view str );
+            // note: pattern bytes are allocated from the current arena (if any), copies use the heap
+            NOINLINE Pattern( std::string_view str, std::pmr::memory_resource *resource = Arena::get_current() );
 
             // returns pattern vector
             FORCEINLINE container_t get_vector() const {
@@ -79,6 +80,11 @@ namespace PatternScan {
                 return m_pattern[ idx ];
             }
 
+            // amount of bytes in pattern
+            FORCEINLINE size_t size() const {
+                return m_pattern.size();
+            }
+
             // is the pattern empty?
             FORCEINLINE bool empty() const {
                 return m_pattern.empty();
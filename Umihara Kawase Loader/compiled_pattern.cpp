@@ -0,0 +1,84 @@
+#include "compiled_pattern.h"
+
+namespace PatternScan {
+
+    namespace Build {
+
+        NOINLINE CompiledPattern::CompiledPattern( const Pattern &pattern ) : m_blocks{}, m_pattern{ pattern }, m_anchor_offset{ 0 }, m_anchor_byte{ 0 } {
+            alignas( 16 ) std::array< uint8_t, 16 > values;
+            alignas( 16 ) std::array< uint8_t, 16 > masks;
+
+            // find anchor byte
+            const auto it = std::find_if( pattern.cbegin(), pattern.cend(),
+                []( const PatternByte &b ) {
+                    return !b.is_wildcard();
+                }
+            );
+
+            // empty or wildcard-only pattern, can't be compiled
+            if( it == pattern.cend() )
+                return;
+
+            m_anchor_offset = (size_t)( it - pattern.cbegin() );
+            m_anchor_byte   = it->get_byte();
+
+            // fill blocks
+            for( size_t i = 0; i < pattern.size(); i += values.size() ) {
+                values.fill( 0 );
+                masks.fill( 0xFF );
+
+                for( size_t j = 0; j < values.size() && i + j < pattern.size(); ++j ) {
+                    const auto &b = pattern[ i + j ];
+                    if( b.is_wildcard() )
+                        continue;
+
+                    values[ j ] = b.get_byte();
+                    masks[ j ]  = 0;
+                }
+
+                m_blocks.push_back( CompiledBlock{ _mm_load_si128( (const __m128i *)values.data() ), _mm_load_si128( (const __m128i *)masks.data() ) } );
+            }
+        }
+
+        //
+        // compiled pattern cache
+        //
+
+        class CacheEntry {
+        public:
+            hash32_t       m_hash;
+            std::string    m_pattern_str;
+            compiled_ptr_t m_compiled;
+        };
+
+        static std::mutex                g_cache_mutex;
+        static std::vector< CacheEntry > g_cache;
+
+        NOINLINE compiled_ptr_t get_compiled( std::string_view pattern_str ) {
+            const auto hash = FNV1aHash::get_32( pattern_str );
+
+            std::lock_guard< std::mutex > lock( g_cache_mutex );
+
+            // already compiled?
+            for( const auto &e : g_cache ) {
+                if( e.m_hash == hash && e.m_pattern_str == pattern_str )
+                    return e.m_compiled;
+            }
+
+            // convert pattern string to pattern object
+            const auto pattern = Pattern( pattern_str );
+            if( !pattern )
+                return {};
+
+            auto compiled = std::make_shared< const CompiledPattern >( pattern );
+            if( !*compiled )
+                return {};
+
+            g_cache.push_back( CacheEntry{ hash, std::string( pattern_str ), compiled } );
+
+            return compiled;
+        }
+
+    } // namespace Build
+
+} // namespace PatternScan
\ No newline at end of file
@@ -0,0 +1,111 @@
+#pragma once
+
+#include "build_pattern.h"
+
+namespace PatternScan {
+
+    namespace Build {
+
+        //
+        // a pattern compiled to 16-byte value / mask blocks
+        // each block is checked with a single SSE2 compare, there's no branch per byte
+        // note: this is data, not generated code, the loader never maps executable memory
+        //
+
+        // 16 pattern bytes
+        class CompiledBlock {
+        public:
+            // pattern bytes, 0 for wildcards and padding
+            __m128i m_value;
+
+            // 0xFF for wildcards and padding, 0x00 for bytes that must match
+            __m128i m_mask;
+        };
+
+        class CompiledPattern {
+        private:
+            // types
+            using blocks_t = std::vector< CompiledBlock >;
+
+            // pattern, padded to a multiple of 16 bytes
+            blocks_t m_blocks;
+
+            // original pattern (used for the end of a range where 16-byte loads would read too far)
+            Pattern m_pattern;
+
+            // first non-wildcard byte, candidates are found with it
+            size_t  m_anchor_offset;
+            uint8_t m_anchor_byte;
+
+        public:
+            CompiledPattern() = default;
+
+            NOINLINE CompiledPattern( const Pattern &pattern );
+
+            // amount of bytes in pattern
+            FORCEINLINE size_t size() const {
+                return m_pattern.size();
+            }
+
+            // amount of bytes read by match(), always a multiple of 16
+            FORCEINLINE size_t read_size() const {
+                return m_blocks.size() * sizeof( __m128i );
+            }
+
+            // first non-wildcard byte
+            FORCEINLINE size_t get_anchor_offset() const {
+                return m_anchor_offset;
+            }
+
+            FORCEINLINE uint8_t get_anchor_byte() const {
+                return m_anchor_byte;
+            }
+
+            // match pattern at data
+            // note: reads read_size() bytes
+            FORCEINLINE bool match( const uint8_t *data ) const {
+                for( size_t i = 0; i < m_blocks.size(); ++i ) {
+                    const auto cur = _mm_loadu_si128( (const __m128i *)( data + i * sizeof( __m128i ) ) );
+                    const auto eq  = _mm_or_si128( _mm_cmpeq_epi8( cur, m_blocks[ i ].m_value ), m_blocks[ i ].m_mask );
+
+                    if( _mm_movemask_epi8( eq ) != 0xFFFF )
+                        return false;
+                }
+
+                return true;
+            }
+
+            // match pattern at data, byte by byte
+            // note: reads size() bytes
+            FORCEINLINE bool match_slow( const uint8_t *data ) const {
+                return std::equal( m_pattern.cbegin(), m_pattern.cend(), data,
+                    []( const PatternByte &b, const uint8_t &c ) {
+                        return b.compare( c );
+                    }
+                );
+            }
+
+            // is the pattern empty?
+            FORCEINLINE bool empty() const {
+                return m_blocks.empty();
+            }
+
+            // valid checks
+            FORCEINLINE operator bool() const {
+                return empty() != true;
+            }
+
+            FORCEINLINE bool operator !() const {
+                return empty() == true;
+            }
+        };
+
+        // shared compiled pattern ptr
+        using compiled_ptr_t = std::shared_ptr< const CompiledPattern >;
+
+        // get compiled pattern from cache, the pattern is compiled on first use
+        extern NOINLINE compiled_ptr_t get_compiled( std::string_view pattern_str );
+
+    } // namespace Build
+
+} // namespace PatternScan
\ No newline at end of file
@@ -0,0 +1,298 @@
+#include "config.h"
+#include "ini_reader.h"
+
+namespace Config {
+
+    // schema field names, every name is unique
+    static constexpr auto FIELD_NAMES = []() {
+        std::array< PerfectHash::Entry< wchar_t, int32_t >, SCHEMA.size() > entries{};
+
+        for( size_t i = 0; i < SCHEMA.size(); ++i )
+            entries[ i ] = { SCHEMA[ i ].m_name, (int32_t)i };
+
+        return PerfectHash::Map< wchar_t, int32_t, SCHEMA.size() >( entries );
+    }();
+
+    // find schema field for a value, -1 if it's unknown
+    static NOINLINE int32_t find_field( std::wstring_view section, hash32_t section_hash, const INIParser::ValueInfo &value ) {
+        const auto index = FIELD_NAMES.find( value.get_value_name(), value.get_value_name_hash() );
+        if( !index )
+            return -1;
+
+        const auto &f = SCHEMA[ *index ];
+        if( f.m_section_hash != section_hash || f.m_section != section )
+            return -1;
+
+        return *index;
+    }
+
+    NOINLINE void set_defaults( Settings &out ) {
+        const auto base = (uint8_t *)&out;
+
+        for( const auto &f : SCHEMA ) {
+            switch( f.m_type ) {
+                case FIELD_BOOL: {
+                    *(bool *)( base + f.m_offset ) = ( f.m_default != 0 );
+
+                    break;
+                }
+
+                case FIELD_UINT32: {
+                    *(uint32_t *)( base + f.m_offset ) = f.m_default;
+
+                    break;
+                }
+
+                case FIELD_KEYBIND: {
+                    auto &keybind = *(Keybind *)( base + f.m_offset );
+
+                    keybind                           = {};
+                    keybind.m_chords[ 0 ].m_keys[ 0 ] = (uint8_t)f.m_default;
+                    keybind.m_chords[ 0 ].m_size      = 1;
+                    keybind.m_size                    = 1;
+
+                    break;
+                }
+
+                default: {
+                    break;
+                }
+            }
+        }
+    }
+
+    NOINLINE bool parse_keybind( std::wstring_view str, Keybind &out ) {
+        out = {};
+
+        // iterate each chord
+        for( size_t pos = 0; pos <= str.size(); ) {
+            auto end = str.find( L',', pos );
+            if( end == std::wstring_view::npos )
+                end = str.size();
+
+            auto chord = str.substr( pos, end - pos );
+
+            pos = end + 1;
+
+            if( out.m_size >= out.m_chords.size() )
+                return false;
+
+            auto &cur_chord = out.m_chords[ out.m_size++ ];
+
+            // iterate each key in the chord
+            for( size_t key_pos = 0; key_pos <= chord.size(); ) {
+                auto key_end = chord.find( L'+', key_pos );
+                if( key_end == std::wstring_view::npos )
+                    key_end = chord.size();
+
+                const auto key = INIParser::parse_uint( chord.substr( key_pos, key_end - key_pos ) );
+
+                key_pos = key_end + 1;
+
+                // not a number or not a dinput key
+                if( !key || *key > 0xFF || cur_chord.m_size >= cur_chord.m_keys.size() )
+                    return false;
+
+                cur_chord.m_keys[ cur_chord.m_size++ ] = (uint8_t)*key;
+            }
+        }
+
+        return true;
+    }
+
+    NOINLINE void build_key_table( Settings &out ) {
+        out.m_key_table.fill( 0 );
+        out.m_key_rule_amt = 0;
+
+        for( size_t i = 0; i < out.m_keybinds.size(); ++i ) {
+            const auto &keybind = out.m_keybinds[ i ];
+            const auto state    = KEYBIND_STATES[ i ];
+
+            for( size_t j = 0; j < keybind.m_size; ++j ) {
+                const auto &chord = keybind.m_chords[ j ];
+
+                key_mask_t mask{};
+                size_t     key_amt = 0;
+
+                for( size_t k = 0; k < chord.m_size; ++k ) {
+                    const auto key = chord.m_keys[ k ];
+                    const auto bit = (uint8_t)( 1 << ( key & 7 ) );
+
+                    // same key twice in a chord
+                    if( mask[ key >> 3 ] & bit )
+                        continue;
+
+                    mask[ key >> 3 ] |= bit;
+                    ++key_amt;
+                }
+
+                // single key, several keybinds can share a key and all of their states are set
+                if( key_amt == 1 ) {
+                    out.m_key_table[ chord.m_keys[ 0 ] ] |= state;
+
+                    continue;
+                }
+
+                // same keys as an earlier chord? share its rule
+                const auto rules_end = out.m_key_rules.begin() + out.m_key_rule_amt;
+
+                const auto same_mask = [ & ]( const KeyRule &r ) {
+                    return r.m_mask == mask;
+                };
+
+                const auto rule_it = std::find_if( out.m_key_rules.begin(), rules_end, same_mask );
+                if( rule_it != rules_end )
+                    rule_it->m_state |= state;
+
+                else
+                    out.m_key_rules[ out.m_key_rule_amt++ ] = KeyRule{ mask, state };
+            }
+        }
+    }
+
+    //
+    // fills settings one value at a time
+    //
+
+    class Binder {
+    private:
+        // where a value came from, overlays always win over the base layer
+        enum Layer : uint8_t {
+            LAYER_BASE = 0,
+            LAYER_OVERLAY,
+            LAYER_MAX
+        };
+
+        uint8_t                                             *m_base;
+        int8_t                                              m_game_id;
+        BindResult                                          m_result;
+        std::array< std::bitset< SCHEMA.size() >, LAYER_MAX > m_seen;
+
+        NOINLINE void report_invalid( std::wstring_view section, const INIParser::ValueInfo &v ) {
+            g_log->warn( L"INI: invalid value \"{}\" for \"{}\" in [{}], using default", v.get_str(), v.get_value_name(), section );
+
+            ++m_result.m_invalid;
+        }
+
+    public:
+        FORCEINLINE Binder( Settings &out, int8_t game_id ) : m_base{ (uint8_t *)&out }, m_game_id{ game_id }, m_result{}, m_seen{} {
+            set_defaults( out );
+        }
+
+        NOINLINE void add( std::wstring_view section, hash32_t section_hash, const INIParser::ValueInfo &v ) {
+            auto base_section = section;
+            auto layer        = LAYER_BASE;
+
+            // overlay section? "[settings.UMI_GAME_KAWASE]" applies to "[settings]"
+            const auto dot = section.find_last_of( L'.' );
+            if( dot != std::wstring_view::npos ) {
+                const auto game_it = std::find( GAME_OVERLAYS.begin(), GAME_OVERLAYS.end(), section.substr( dot + 1 ) );
+                if( game_it != GAME_OVERLAYS.end() ) {
+                    // for another game
+                    if( game_it - GAME_OVERLAYS.begin() != m_game_id )
+                        return;
+
+                    base_section = section.substr( 0, dot );
+                    section_hash = FNV1aHash::get_32( base_section );
+                    layer        = LAYER_OVERLAY;
+                }
+            }
+
+            const auto idx = find_field( base_section, section_hash, v );
+            if( idx < 0 ) {
+                g_log->warn( L"INI: unknown value \"{}\" in [{}]", v.get_value_name(), section );
+
+                ++m_result.m_unknown;
+
+                return;
+            }
+
+            // first one wins within a layer, same as INIParser lookups
+            auto &seen = m_seen[ layer ];
+            if( seen.test( idx ) ) {
+                g_log->warn( L"INI: duplicate value \"{}\" in [{}]", v.get_value_name(), section );
+
+                ++m_result.m_duplicate;
+
+                return;
+            }
+
+            seen.set( idx );
+
+            // base value after an overlay value, still check it but keep the overlay
+            // this keeps the result the same no matter where the overlay is in the file
+            const auto write = layer == LAYER_OVERLAY || !m_seen[ LAYER_OVERLAY ].test( idx );
+
+            const auto &f = SCHEMA[ idx ];
+
+            switch( f.m_type ) {
+                case FIELD_BOOL: {
+                    const auto value = v.get_bool();
+                    if( !value )
+                        report_invalid( section, v );
+
+                    else if( write )
+                        *(bool *)( m_base + f.m_offset ) = *value;
+
+                    break;
+                }
+
+                case FIELD_UINT32: {
+                    const auto value = v.get_uint32();
+                    if( !value )
+                        report_invalid( section, v );
+
+                    else if( write )
+                        *(uint32_t *)( m_base + f.m_offset ) = *value;
+
+                    break;
+                }
+
+                case FIELD_KEYBIND: {
+                    Keybind value;
+                    if( !parse_keybind( v.get_str(), value ) )
+                        report_invalid( section, v );
+
+                    else if( write )
+                        *(Keybind *)( m_base + f.m_offset ) = value;
+
+                    break;
+                }
+
+                default: {
+                    break;
+                }
+            }
+        }
+
+        // every field has its final value, nothing later in the file can change the settings
+        // base values are only final if this game has no overlay, one further down would still win
+        FORCEINLINE bool is_done() const {
+            const auto has_overlay = m_game_id >= 0 && (size_t)m_game_id < GAME_OVERLAYS.size();
+
+            return m_seen[ LAYER_OVERLAY ].all() || ( !has_overlay && m_seen[ LAYER_BASE ].all() );
+        }
+
+        FORCEINLINE const BindResult &get_result() const {
+            return m_result;
+        }
+    };
+
+    NOINLINE BindResult bind( INIReader &reader, int8_t game_id, Settings &out ) {
+        auto binder = Binder( out, game_id );
+
+        reader.for_each(
+            [ & ]( const INIReader::Event &e ) {
+                binder.add( e.m_section, e.m_section_hash, *e.m_value );
+
+                // stop reading once nothing can change
+                return !binder.is_done();
+            }
+        );
+
+        build_key_table( out );
+
+        return binder.get_result();
+    }
+
+} // namespace Config
\ No newline at end of file
@@ -0,0 +1,222 @@
+#pragma once
+
+#include "includes.h"
+
+// fwd declare
+class INIReader;
+
+//
+// loader settings and the INI schema that fills them
+//
+
+namespace Config {
+
+    //
+    // settings
+    //
+
+    // keybind slots
+    // note: same order as KEYBIND_STATES
+    enum KeybindID : uint8_t {
+        KEYBIND_UP = 0,
+        KEYBIND_DOWN,
+        KEYBIND_LEFT,
+        KEYBIND_RIGHT,
+        KEYBIND_START,
+        KEYBIND_PAUSE,
+        KEYBIND_SELECT,
+        KEYBIND_RESTART,
+        KEYBIND_BACK,
+        KEYBIND_JUMP,
+        KEYBIND_HOOK,
+        KEYBIND_L,
+        KEYBIND_R,
+        KEYBIND_SKIP,
+        KEYBIND_MAX
+    };
+
+    // game key state for each keybind
+    constexpr std::array< uint32_t, KEYBIND_MAX > KEYBIND_STATES = {
+        // movement and move UI selection keys
+        UMI_KEY_UP,
+        UMI_KEY_DOWN,
+        UMI_KEY_LEFT,
+        UMI_KEY_RIGHT,
+
+        // menu related
+        UMI_KEY_START,
+        UMI_KEY_PAUSE,
+        UMI_KEY_SELECT, // NOTE: this key is only valid on the first game (UmiharaKawase)
+        UMI_KEY_RESTART,
+        UMI_KEY_BACK,
+
+        // gameplay
+        UMI_KEY_JUMP,
+        UMI_KEY_HOOK,
+        UMI_KEY_L,
+        UMI_KEY_R,
+
+        // misc
+        UMI_KEY_SKIP
+    };
+
+    // keybind limits
+    constexpr size_t MAX_CHORD_KEYS     = 4; // keys held together, "0x1D+0x2C"
+    constexpr size_t MAX_KEYBIND_CHORDS = 8; // chords per keybind, "0x2C,0x39"
+
+    // dinput keys that must all be held
+    class KeyChord {
+    public:
+        std::array< uint8_t, MAX_CHORD_KEYS > m_keys;
+        uint8_t                               m_size;
+    };
+
+    // a keybind is pressed if any of its chords is
+    class Keybind {
+    public:
+        std::array< KeyChord, MAX_KEYBIND_CHORDS > m_chords;
+        uint8_t                                    m_size;
+    };
+
+    // game key state bits for each dinput key
+    using key_table_t = std::array< uint32_t, 256 >;
+
+    // one bit per dinput key, bit n is byte n / 8 bit n % 8
+    using key_mask_t = std::array< uint8_t, 32 >;
+
+    // chord compiled for evaluation, chords with the same keys share a rule
+    class KeyRule {
+    public:
+        key_mask_t m_mask;  // keys that must be held
+        uint32_t   m_state; // game key state bits
+    };
+
+    class Settings {
+    public:
+        bool                               m_rebind_keys;
+        bool                               m_signature_report;
+        bool                               m_hot_reload;
+        bool                               m_record_input;
+        bool                               m_record_raw_input;
+        bool                               m_replay_input;
+        uint32_t                           m_replay_start_key;   // dinput key, 0 to start right away
+        uint32_t                           m_replay_start_frame;
+        std::array< Keybind, KEYBIND_MAX > m_keybinds;
+
+        // built from m_keybinds after binding
+        // single keys go in the table, chords of 2+ keys are rules
+        key_table_t                                          m_key_table;
+        std::array< KeyRule, KEYBIND_MAX * MAX_KEYBIND_CHORDS > m_key_rules;
+        uint32_t                                             m_key_rule_amt;
+    };
+
+    //
+    // schema
+    //
+
+    enum FieldType : uint8_t {
+        FIELD_BOOL = 0,
+        FIELD_UINT32,
+        FIELD_KEYBIND  // Keybind, default is a single key
+    };
+
+    class Field {
+    public:
+        std::wstring_view m_section;
+        hash32_t          m_section_hash;
+        std::wstring_view m_name;
+        hash32_t          m_name_hash;
+        FieldType         m_type;
+        size_t            m_offset;  // offset into Settings
+        uint32_t          m_default;
+    };
+
+    // schema entry, hashes are computed at compile-time
+    #define CONFIG_FIELD( section, name, type, offset, default_value ) \
+        Config::Field{ L"" section, CT_HASH_32( L"" section ), L"" name, CT_HASH_32( L"" name ), type, offset, default_value }
+
+    #define CONFIG_KEYBIND( name, id, default_value ) \
+        CONFIG_FIELD( "settings", name, Config::FIELD_KEYBIND, offsetof( Config::Settings, m_keybinds ) + ( id ) * sizeof( Config::Keybind ), default_value )
+
+    constexpr std::array< Field, 8 + KEYBIND_MAX > SCHEMA = {
+        // misc
+        CONFIG_FIELD( "settings", "rebind_keys",      FIELD_BOOL, offsetof( Settings, m_rebind_keys ),      false ),
+        CONFIG_FIELD( "settings", "signature_report", FIELD_BOOL, offsetof( Settings, m_signature_report ), false ),
+        CONFIG_FIELD( "settings", "hot_reload",       FIELD_BOOL, offsetof( Settings, m_hot_reload ),       false ),
+
+        // input recording
+        CONFIG_FIELD( "settings", "record_input",     FIELD_BOOL, offsetof( Settings, m_record_input ),     false ),
+        CONFIG_FIELD( "settings", "record_raw_input", FIELD_BOOL, offsetof( Settings, m_record_raw_input ), false ),
+
+        // input replay
+        CONFIG_FIELD( "settings", "replay_input",       FIELD_BOOL,   offsetof( Settings, m_replay_input ),       false ),
+        CONFIG_FIELD( "settings", "replay_start_key",   FIELD_UINT32, offsetof( Settings, m_replay_start_key ),   0     ),
+        CONFIG_FIELD( "settings", "replay_start_frame", FIELD_UINT32, offsetof( Settings, m_replay_start_frame ), 0     ),
+
+        // movement and move UI selection keybinds
+        CONFIG_KEYBIND( "KEY_UP",    KEYBIND_UP,    DIK_UP    ),
+        CONFIG_KEYBIND( "KEY_DOWN",  KEYBIND_DOWN,  DIK_DOWN  ),
+        CONFIG_KEYBIND( "KEY_LEFT",  KEYBIND_LEFT,  DIK_LEFT  ),
+        CONFIG_KEYBIND( "KEY_RIGHT", KEYBIND_RIGHT, DIK_RIGHT ),
+
+        // menu related keybinds
+        CONFIG_KEYBIND( "KEY_START",   KEYBIND_START,   DIK_SPACE  ),
+        CONFIG_KEYBIND( "KEY_PAUSE",   KEYBIND_PAUSE,   DIK_RETURN ),
+        CONFIG_KEYBIND( "KEY_SELECT",  KEYBIND_SELECT,  DIK_TAB    ),
+        CONFIG_KEYBIND( "KEY_RESTART", KEYBIND_RESTART, DIK_S      ),
+        CONFIG_KEYBIND( "KEY_BACK",    KEYBIND_BACK,    DIK_ESCAPE ),
+
+        // gameplay keybinds
+        CONFIG_KEYBIND( "KEY_JUMP", KEYBIND_JUMP, DIK_Z     ),
+        CONFIG_KEYBIND( "KEY_HOOK", KEYBIND_HOOK, DIK_A     ),
+        CONFIG_KEYBIND( "KEY_L",    KEYBIND_L,    DIK_PRIOR ),
+        CONFIG_KEYBIND( "KEY_R",    KEYBIND_R,    DIK_NEXT  ),
+
+        // misc keybinds
+        CONFIG_KEYBIND( "KEY_SKIP", KEYBIND_SKIP, DIK_X )
+    };
+
+    #undef CONFIG_KEYBIND
+    #undef CONFIG_FIELD
+
+    // per-game overlay section suffixes, indexed by GameVersion
+    // values in "[settings.UMI_GAME_KAWASE]" override "[settings]" for that game only
+    constexpr std::array< std::wstring_view, 3 > GAME_OVERLAYS = {
+        L"UMI_GAME_KAWASE",
+        L"UMI_GAME_KAWASE_SHUN",
+        L"UMI_GAME_SAYONARA_KAWASE"
+    };
+
+    //
+    // binding
+    //
+
+    // what went wrong while binding, nothing here is fatal
+    class BindResult {
+    public:
+        size_t m_unknown;   // values not in the schema
+        size_t m_duplicate; // values set more than once, the first one is used
+        size_t m_invalid;   // values that couldn't be converted, the default is used
+    };
+
+    //
+    // funcs in source file
+    //
+
+    // fill settings with schema defaults
+    extern NOINLINE void set_defaults( Settings &out );
+
+    // parse a keybind value, chords are split by "," and keys in a chord by "+"
+    // note: the INI parser strips whitespace, "0x1D + 0x2C, 0x39" reaches us as "0x1D+0x2C,0x39"
+    extern NOINLINE bool parse_keybind( std::wstring_view str, Keybind &out );
+
+    // build key table and rules from keybinds
+    extern NOINLINE void build_key_table( Settings &out );
+
+    // fill settings from a streaming reader in a single pass, every problem is logged
+    // overlays for game_id are merged on top of the base values, overlays for other games are skipped
+    // reading stops once every field has its final value, problems after that aren't reported
+    // check reader.has_error() afterwards
+    extern NOINLINE BindResult bind( INIReader &reader, int8_t game_id, Settings &out );
+
+} // namespace Config
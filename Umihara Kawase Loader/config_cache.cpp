@@ -0,0 +1,132 @@
+#include "config_cache.h"
+
+namespace Config {
+
+    //
+    // cache file layout
+    //
+
+    // "UMIC"
+    constexpr uint32_t CACHE_MAGIC = 0x43494D55;
+
+    // INI content hash, the whole file is hashed on every load so it should be fast
+    using ini_hasher_t = WordHash::Hasher64;
+
+    class CacheHeader {
+    public:
+        uint32_t m_magic;
+        uint32_t m_version;
+        uint32_t m_schema_hash;    // settings layout this cache was made for
+        int32_t  m_game_id;        // overlays are already merged for this game
+        uint64_t m_ini_hash;       // INI content hash
+        uint64_t m_ini_size;
+        uint64_t m_ini_write_time;
+    };
+
+    // settings follow the header
+    constexpr size_t CACHE_SIZE = sizeof( CacheHeader ) + sizeof( Settings );
+
+    // hash a 32-bit value byte by byte
+    static FORCEINLINE constexpr uint32_t hash_uint32( uint32_t value, uint32_t hash ) {
+        for( size_t i = 0; i < sizeof( value ); ++i )
+            hash = FNV1aHash::hash_byte_32( (uint8_t)( value >> ( i * 8 ) ), hash );
+
+        return hash;
+    }
+
+    // hash of the schema and settings layout, a cache made with another layout (or other defaults) is stale
+    constexpr uint32_t SCHEMA_HASH = []() {
+        auto out = hash_uint32( (uint32_t)sizeof( Settings ), FNV1aHash::T::FNV_BASIS_32 );
+
+        for( const auto &f : SCHEMA ) {
+            out = hash_uint32( f.m_section_hash, out );
+            out = hash_uint32( f.m_name_hash, out );
+            out = hash_uint32( f.m_type, out );
+            out = hash_uint32( (uint32_t)f.m_offset, out );
+            out = hash_uint32( f.m_default, out );
+        }
+
+        return out;
+    }();
+
+    // fill header for the INI as it is on disk right now
+    static NOINLINE bool make_header( const std_fs::path &ini_file, int8_t game_id, CacheHeader &out ) {
+        if( !Utils::get_file_info( ini_file, out.m_ini_write_time, out.m_ini_size ) )
+            return false;
+
+        // hash raw INI contents, no parsing needed
+        const auto ini = MappedFile( ini_file );
+        if( !ini.is_open() || ini.get_size() != out.m_ini_size )
+            return false;
+
+        out.m_magic       = CACHE_MAGIC;
+        out.m_version     = CACHE_VERSION;
+        out.m_schema_hash = SCHEMA_HASH;
+        out.m_game_id     = game_id;
+        out.m_ini_hash    = ini_hasher_t::get( ini.get_data(), ini.get_size() );
+
+        return true;
+    }
+
+    NOINLINE bool load_cache( const std_fs::path &ini_file, const std_fs::path &cache_file, int8_t game_id, Settings &out ) {
+        CacheHeader expected{};
+
+        const auto cache = MappedFile( cache_file );
+        if( !cache.is_mapped() || cache.get_size() != CACHE_SIZE )
+            return false;
+
+        const auto header = (const CacheHeader *)cache.get_data();
+
+        // cheap checks first
+        if( header->m_magic != CACHE_MAGIC || header->m_version != CACHE_VERSION || header->m_schema_hash != SCHEMA_HASH || header->m_game_id != game_id )
+            return false;
+
+        uint64_t write_time, size;
+        if( !Utils::get_file_info( ini_file, write_time, size ) || write_time != header->m_ini_write_time || size != header->m_ini_size )
+            return false;
+
+        // write time and size match, make sure the contents do too
+        if( !make_header( ini_file, game_id, expected ) || expected.m_ini_hash != header->m_ini_hash )
+            return false;
+
+        std::memcpy( &out, cache.get_data() + sizeof( CacheHeader ), sizeof( Settings ) );
+
+        // rule count is used as a bound every frame, don't trust it blindly
+        return out.m_key_rule_amt <= out.m_key_rules.size();
+    }
+
+    NOINLINE bool store_cache( const std_fs::path &ini_file, const std_fs::path &cache_file, int8_t game_id, const Settings &settings ) {
+        std::array< uint8_t, CACHE_SIZE > buffer{};
+        CacheHeader                       header{};
+        DWORD                             written = 0;
+
+        if( !make_header( ini_file, game_id, header ) )
+            return false;
+
+        std::memcpy( buffer.data(), &header, sizeof( header ) );
+        std::memcpy( buffer.data() + sizeof( header ), &settings, sizeof( settings ) );
+
+        auto tmp_file = cache_file;
+        tmp_file += L".tmp";
+
+        // write temp file, flushed so the move below can't reach the disk before the contents do
+        const auto write_tmp_file = [ & ]() {
+            const auto file = SHandleI( CreateFileW( tmp_file.c_str(), GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr ) );
+            if( !file )
+                return false;
+
+            return WriteFile( file, buffer.data(), (DWORD)buffer.size(), &written, nullptr ) && written == buffer.size() && FlushFileBuffers( file );
+        };
+
+        // ... and swap it in, readers never see a partial cache
+        // don't leave a temp file behind if either fails
+        if( !write_tmp_file() || !MoveFileExW( tmp_file.c_str(), cache_file.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH ) ) {
+            DeleteFileW( tmp_file.c_str() );
+
+            return false;
+        }
+
+        return true;
+    }
+
+} // namespace Config
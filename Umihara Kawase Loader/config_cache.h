@@ -0,0 +1,29 @@
+#pragma once
+
+#include "includes.h"
+
+//
+// binary cache of bound settings, so later starts don't have to parse the INI
+// the cache is only used if the INI's size, write time and content hash all match
+//
+
+namespace Config {
+
+    // fwd declare
+    class Settings;
+
+    // bump this when the cache layout or value decoding changes
+    constexpr uint32_t CACHE_VERSION = 4;
+
+    //
+    // funcs in source file
+    //
+
+    // load settings from cache, false if the cache is missing or stale (or was made for another game)
+    extern NOINLINE bool load_cache( const std_fs::path &ini_file, const std_fs::path &cache_file, int8_t game_id, Settings &out );
+
+    // write settings to cache
+    // the file is written to a temp file first and then moved over the old cache
+    extern NOINLINE bool store_cache( const std_fs::path &ini_file, const std_fs::path &cache_file, int8_t game_id, const Settings &settings );
+
+} // namespace Config
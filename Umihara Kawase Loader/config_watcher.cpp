@@ -0,0 +1,107 @@
+#include "config_watcher.h"
+
+//
+// portable part of the watcher, the OS backends are in config_watcher_win32.cpp / config_watcher_inotify.cpp
+//
+
+namespace Config {
+
+    NOINLINE Watcher::Watcher() : m_file{}, m_callback{ nullptr }, m_write_time{ 0 }, m_size{ 0 }, m_dir{}, m_thread{ nullptr } {
+
+    }
+
+    NOINLINE ulong_t __stdcall Watcher::thread_func( void *arg ) {
+        const auto watcher = (Watcher *)arg;
+
+        watcher->run();
+
+        return 0;
+    }
+
+    NOINLINE void Watcher::run() {
+        using clock_t = std::chrono::steady_clock;
+
+        auto result = DirWatch::RESULT_TIMEOUT;
+
+        while( true ) {
+            result = m_dir.wait( INFINITE );
+
+            if( result == DirWatch::RESULT_STOP || result == DirWatch::RESULT_ERROR )
+                break;
+
+            // something else in the directory changed?
+            if( result != DirWatch::RESULT_FILE )
+                continue;
+
+            // let writes settle, every change to the file meanwhile restarts the wait
+            auto settled = clock_t::now() + std::chrono::milliseconds( SETTLE_TIME );
+
+            while( true ) {
+                const auto left = std::chrono::ceil< std::chrono::milliseconds >( settled - clock_t::now() ).count();
+
+                result = m_dir.wait( left > 0 ? (ulong_t)left : 0 );
+
+                if( result == DirWatch::RESULT_FILE )
+                    settled = clock_t::now() + std::chrono::milliseconds( SETTLE_TIME );
+
+                else if( result != DirWatch::RESULT_OTHER )
+                    break;
+            }
+
+            if( result != DirWatch::RESULT_TIMEOUT )
+                break;
+
+            if( check_changed() )
+                m_callback( m_file );
+        }
+
+        if( result == DirWatch::RESULT_ERROR )
+            g_log->error( L"Config watcher: stopped watching \"{}\"", m_file.wstring() );
+    }
+
+    NOINLINE bool Watcher::check_changed() {
+        uint64_t write_time, size;
+
+        if( !Utils::get_file_info( m_file, write_time, size ) || ( write_time == m_write_time && size == m_size ) )
+            return false;
+
+        m_write_time = write_time;
+        m_size       = size;
+
+        return true;
+    }
+
+    NOINLINE bool Watcher::start( const std_fs::path &file, callback_t callback ) {
+        if( is_running() || !callback )
+            return false;
+
+        m_file     = file;
+        m_callback = callback;
+
+        // current state, so the first change notification isn't a false positive
+        if( !Utils::get_file_info( m_file, m_write_time, m_size ) )
+            return false;
+
+        if( !m_dir.open( m_file ) ) {
+            g_log->error( L"Config watcher: failed to watch \"{}\"", m_file.parent_path().wstring() );
+
+            return false;
+        }
+
+        m_thread.reset( CreateThread( nullptr, 0, thread_func, this, 0, nullptr ) );
+
+        return is_running();
+    }
+
+    NOINLINE void Watcher::stop() {
+        if( !is_running() )
+            return;
+
+        m_dir.stop();
+
+        WaitForSingleObject( m_thread, INFINITE );
+
+        m_thread.reset();
+    }
+
+} // namespace Config
\ No newline at end of file
@@ -0,0 +1,118 @@
+#pragma once
+
+#include "includes.h"
+
+namespace Config {
+
+    //
+    // change notifications for a single file, OS backend for the watcher below
+    // it watches the file's directory, so the file itself can be replaced
+    // win32: ReadDirectoryChangesW (config_watcher_win32.cpp), linux: inotify (config_watcher_inotify.cpp)
+    //
+
+    class DirWatch {
+    public:
+        enum Result : uint8_t {
+            RESULT_FILE = 0, // the file (maybe) changed
+            RESULT_OTHER,    // something else in the directory changed
+            RESULT_TIMEOUT,
+            RESULT_STOP,     // stop() was called, every wait after it returns this too
+            RESULT_ERROR
+        };
+
+    private:
+        std_fs::path m_file;
+
+#ifdef _WIN32
+        SHandleI   m_dir;
+        SHandle    m_event;
+        SHandle    m_stop_event;
+        OVERLAPPED m_overlapped;
+        bool       m_pending;
+
+        // changed names, FILE_NOTIFY_INFORMATION entries are DWORD aligned
+        alignas( DWORD ) std::array< uint8_t, 4096 > m_changes;
+
+        // does a ReadDirectoryChangesW result name our file?
+        NOINLINE bool has_file_name( ulong_t size ) const;
+#else
+        int m_fd;
+        int m_stop_fd;
+
+        // inotify_event entries
+        alignas( int ) std::array< uint8_t, 4096 > m_changes;
+#endif
+
+    public:
+        NOINLINE DirWatch();
+        NOINLINE ~DirWatch();
+
+        DirWatch( const DirWatch & )             = delete;
+        DirWatch &operator =( const DirWatch & ) = delete;
+
+        // start watching the file's directory
+        NOINLINE bool open( const std_fs::path &file );
+
+        // wait for the next change, timeout in ms (or INFINITE)
+        // only call this from one thread
+        NOINLINE Result wait( ulong_t timeout );
+
+        // wake up wait() for good, can be called from any thread
+        NOINLINE void stop();
+    };
+
+    //
+    // watches a file for changes on a background thread
+    // the OS only says something happened, this debounces the notifications and checks if the file really changed
+    //
+
+    class Watcher {
+    public:
+        // called from the watcher thread after the file changed
+        using callback_t = void (*)( const std_fs::path &file );
+
+        // no changes to the file for this long and it's done being written
+        // editors tend to write files in multiple steps, changes to other files don't extend the wait
+        static constexpr ulong_t SETTLE_TIME = 100;
+
+    private:
+        std_fs::path m_file;
+        callback_t   m_callback;
+
+        // last seen write time / size
+        uint64_t m_write_time;
+        uint64_t m_size;
+
+        DirWatch m_dir;
+        SHandle  m_thread;
+
+        // thread entry
+        static NOINLINE ulong_t __stdcall thread_func( void *arg );
+
+        // wait for changes until stopped
+        NOINLINE void run();
+
+    public:
+        NOINLINE Watcher();
+
+        Watcher( const Watcher & )             = delete;
+        Watcher &operator =( const Watcher & ) = delete;
+
+        // start watching a file
+        NOINLINE bool start( const std_fs::path &file, callback_t callback );
+
+        // stop watching and wait for the thread to exit
+        // note: don't call this from DllMain
+        NOINLINE void stop();
+
+        // did the file's write time or size change since the last call (or start)?
+        // touched but unchanged files are skipped this way
+        NOINLINE bool check_changed();
+
+        // is the watcher thread running?
+        FORCEINLINE bool is_running() const {
+            return m_thread.get() != nullptr;
+        }
+    };
+
+} // namespace Config
\ No newline at end of file
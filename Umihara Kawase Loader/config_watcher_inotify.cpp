@@ -0,0 +1,99 @@
+#include "config_watcher.h"
+
+//
+// inotify backend of the config watcher, for the tests (and anything else not built for windows)
+// stop() signals an eventfd that is polled next to the inotify fd
+//
+
+#ifndef _WIN32
+
+#include <poll.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+
+namespace Config {
+
+    NOINLINE DirWatch::DirWatch() : m_file{}, m_fd{ -1 }, m_stop_fd{ -1 }, m_changes{} {
+
+    }
+
+    NOINLINE DirWatch::~DirWatch() {
+        if( m_fd != -1 )
+            close( m_fd );
+
+        if( m_stop_fd != -1 )
+            close( m_stop_fd );
+    }
+
+    NOINLINE bool DirWatch::open( const std_fs::path &file ) {
+        m_file = file;
+
+        m_fd      = inotify_init1( IN_NONBLOCK | IN_CLOEXEC );
+        m_stop_fd = eventfd( 0, EFD_NONBLOCK | EFD_CLOEXEC );
+
+        if( m_fd == -1 || m_stop_fd == -1 )
+            return false;
+
+        // watch the whole directory, the file itself might be replaced
+        constexpr uint32_t MASK = IN_MODIFY | IN_CLOSE_WRITE | IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO;
+
+        return inotify_add_watch( m_fd, m_file.parent_path().c_str(), MASK ) != -1;
+    }
+
+    NOINLINE DirWatch::Result DirWatch::wait( ulong_t timeout ) {
+        std::array< pollfd, 2 > fds = { { { m_stop_fd, POLLIN, 0 }, { m_fd, POLLIN, 0 } } };
+
+        const auto ready = poll( fds.data(), (nfds_t)fds.size(), ( timeout == INFINITE ) ? -1 : (int)timeout );
+
+        if( ready < 0 )
+            return RESULT_ERROR;
+
+        if( !ready )
+            return RESULT_TIMEOUT;
+
+        // never read, so every wait after stop() returns here too
+        if( fds[ 0 ].revents )
+            return RESULT_STOP;
+
+        const auto file_name = m_file.filename().native();
+
+        auto result = RESULT_OTHER;
+
+        // everything queued, the next wait blocks again
+        while( true ) {
+            const auto size = read( m_fd, m_changes.data(), m_changes.size() );
+
+            if( size <= 0 )
+                break;
+
+            for( ssize_t offset = 0; offset < size; ) {
+                const auto event = (const inotify_event *)( m_changes.data() + offset );
+
+                // the directory is gone
+                if( event->mask & IN_IGNORED )
+                    return RESULT_ERROR;
+
+                // dropped events, the file might have been one of them
+                if( ( event->mask & IN_Q_OVERFLOW ) || ( event->len && file_name == event->name ) )
+                    result = RESULT_FILE;
+
+                offset += sizeof( inotify_event ) + event->len;
+            }
+        }
+
+        return result;
+    }
+
+    NOINLINE void DirWatch::stop() {
+        const uint64_t value = 1;
+
+        // only fails if the counter is full, it's signaled either way
+        const auto written = write( m_stop_fd, &value, sizeof( value ) );
+
+        (void)written;
+    }
+
+} // namespace Config
+
+#endif
\ No newline at end of file
@@ -0,0 +1,98 @@
+#include "config_watcher.h"
+
+//
+// ReadDirectoryChangesW backend of the config watcher
+// the read stays pending across timeouts, so no change is missed between waits
+//
+
+#ifdef _WIN32
+
+namespace Config {
+
+    NOINLINE DirWatch::DirWatch() : m_file{}, m_dir{ INVALID_HANDLE_VALUE }, m_event{ nullptr }, m_stop_event{ nullptr }, m_overlapped{}, m_pending{ false }, m_changes{} {
+
+    }
+
+    NOINLINE DirWatch::~DirWatch() {
+        // the read still writes into m_changes until it's cancelled
+        if( m_pending ) {
+            DWORD size = 0;
+
+            CancelIo( m_dir );
+            GetOverlappedResult( m_dir, &m_overlapped, &size, TRUE );
+        }
+    }
+
+    NOINLINE bool DirWatch::has_file_name( ulong_t size ) const {
+        const auto file_name = m_file.filename().wstring();
+
+        for( ulong_t offset = 0; offset < size; ) {
+            const auto info = (const FILE_NOTIFY_INFORMATION *)( m_changes.data() + offset );
+            const auto name = std::wstring_view( info->FileName, info->FileNameLength / sizeof( wchar_t ) );
+
+            // windows file names aren't case sensitive
+            if( FNV1aHash::equals_fold( name, std::wstring_view( file_name ) ) )
+                return true;
+
+            if( !info->NextEntryOffset )
+                break;
+
+            offset += info->NextEntryOffset;
+        }
+
+        return false;
+    }
+
+    NOINLINE bool DirWatch::open( const std_fs::path &file ) {
+        m_file = file;
+
+        // watch the whole directory, the file itself might be replaced
+        m_dir.reset( CreateFileW( m_file.parent_path().c_str(), FILE_LIST_DIRECTORY, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, nullptr ) );
+        m_event.reset( CreateEventW( nullptr, TRUE, FALSE, nullptr ) );
+        m_stop_event.reset( CreateEventW( nullptr, TRUE, FALSE, nullptr ) );
+
+        m_overlapped        = {};
+        m_overlapped.hEvent = m_event;
+
+        return m_dir && m_event && m_stop_event;
+    }
+
+    NOINLINE DirWatch::Result DirWatch::wait( ulong_t timeout ) {
+        if( !m_pending ) {
+            ResetEvent( m_event );
+
+            if( !ReadDirectoryChangesW( m_dir, m_changes.data(), (DWORD)m_changes.size(), FALSE, FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_SIZE, nullptr, &m_overlapped, nullptr ) )
+                return RESULT_ERROR;
+
+            m_pending = true;
+        }
+
+        const std::array< HANDLE, 2 > handles = { m_stop_event.get(), m_event.get() };
+
+        const auto wait = WaitForMultipleObjects( (DWORD)handles.size(), handles.data(), FALSE, timeout );
+
+        // still pending, picked up by the next wait
+        if( wait == WAIT_TIMEOUT )
+            return RESULT_TIMEOUT;
+
+        if( wait != WAIT_OBJECT_0 + 1 )
+            return ( wait == WAIT_OBJECT_0 ) ? RESULT_STOP : RESULT_ERROR;
+
+        m_pending = false;
+
+        DWORD size = 0;
+
+        if( !GetOverlappedResult( m_dir, &m_overlapped, &size, FALSE ) )
+            return RESULT_ERROR;
+
+        // note: a size of 0 means too much changed to fit in the buffer, the file might be in there
+        return ( !size || has_file_name( size ) ) ? RESULT_FILE : RESULT_OTHER;
+    }
+
+    NOINLINE void DirWatch::stop() {
+        SetEvent( m_stop_event );
+    }
+
+} // namespace Config
+
+#endif
\ No newline at end of file
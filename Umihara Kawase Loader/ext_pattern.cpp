@@ -0,0 +1,366 @@
+#include "ext_pattern.h"
+
+namespace PatternScan {
+
+    namespace Build {
+
+        // parse a 1 or 2 char hex byte
+        static NOINLINE std::optional< uint8_t > parse_hex_byte( std::string_view str ) {
+            const auto size = str.size();
+            if( !size || size > 2 )
+                return {};
+
+            uint8_t out = 0;
+
+            for( const auto &c : str ) {
+                if( !std::isxdigit( (uint8_t)c ) )
+                    return {};
+
+                out = (uint8_t)( ( out << 4 ) | ( ( c <= '9' ) ? c - '0' : ( c | 0x20 ) - 'a' + 10 ) );
+            }
+
+            return out;
+        }
+
+        NOINLINE ExtPattern::ExtPattern() : m_masks{}, m_optional{ 0 }, m_block_before{ 0 }, m_block_last{ 0 }, m_final{ 0 }, m_positions{ 0 }, m_min_len{ 0 }, m_first_byte{ -1 } {
+
+        }
+
+        NOINLINE ExtPattern::ExtPattern( std::string_view str ) : ExtPattern() {
+            // pending gap, consecutive gaps are merged
+            size_t gap_min = 0;
+            size_t gap_max = 0;
+
+            // add a position that matches every byte set in the lambda
+            const auto add_position = [ & ]( bool optional, const auto &is_match ) -> bool {
+                if( m_positions >= MAX_POSITIONS )
+                    return false;
+
+                const auto bit = state_t{ 1 } << m_positions;
+
+                for( size_t c = 0; c < m_masks.size(); ++c ) {
+                    if( is_match( (uint8_t)c ) )
+                        m_masks[ c ] |= bit;
+                }
+
+                if( optional )
+                    m_optional |= bit;
+                else
+                    ++m_min_len;
+
+                ++m_positions;
+
+                return true;
+            };
+
+            const auto any_byte = []( uint8_t ) {
+                return true;
+            };
+
+            // add pending gap as wildcards, the part above the minimum is optional
+            const auto flush_gap = [ & ]() -> bool {
+                if( !gap_max )
+                    return true;
+
+                for( size_t i = 0; i < gap_min; ++i ) {
+                    if( !add_position( false, any_byte ) )
+                        return false;
+                }
+
+                if( gap_max > gap_min ) {
+                    // optional block needs a position before it
+                    if( !m_positions )
+                        return false;
+
+                    m_block_before |= state_t{ 1 } << ( m_positions - 1 );
+
+                    for( size_t i = gap_min; i < gap_max; ++i ) {
+                        if( !add_position( true, any_byte ) )
+                            return false;
+                    }
+
+                    m_block_last |= state_t{ 1 } << ( m_positions - 1 );
+                }
+
+                gap_min = gap_max = 0;
+
+                return true;
+            };
+
+            // parse a single token
+            const auto parse_token = [ & ]( std::string_view tok ) -> bool {
+                if( tok.empty() )
+                    return false;
+
+                // gap
+                if( tok.front() == '[' ) {
+                    if( tok.back() != ']' )
+                        return false;
+
+                    tok = tok.substr( 1, tok.size() - 2 );
+
+                    const auto dash = tok.find( '-' );
+                    const auto lo   = tok.substr( 0, dash );
+                    const auto hi   = ( dash != std::string_view::npos ) ? tok.substr( dash + 1 ) : lo;
+
+                    if( lo.empty() || hi.empty() || lo.size() > 2 || hi.size() > 2 )
+                        return false;
+
+                    const auto is_digit = []( char c ) {
+                        return std::isdigit( (uint8_t)c ) != 0;
+                    };
+
+                    if( !std::all_of( lo.begin(), lo.end(), is_digit ) || !std::all_of( hi.begin(), hi.end(), is_digit ) )
+                        return false;
+
+                    const auto to_num = []( std::string_view digits ) {
+                        size_t out = 0;
+
+                        for( const auto c : digits )
+                            out = out * 10 + (size_t)( c - '0' );
+
+                        return out;
+                    };
+
+                    const auto lo_val = to_num( lo );
+                    const auto hi_val = to_num( hi );
+                    if( !hi_val || lo_val > hi_val )
+                        return false;
+
+                    gap_min += lo_val;
+                    gap_max += hi_val;
+
+                    return true;
+                }
+
+                if( !flush_gap() )
+                    return false;
+
+                // alternation
+                if( tok.front() == '(' ) {
+                    std::array< bool, 256 > set{};
+
+                    if( tok.back() != ')' )
+                        return false;
+
+                    tok = tok.substr( 1, tok.size() - 2 );
+
+                    // split by '|'
+                    while( true ) {
+                        const auto bar  = tok.find( '|' );
+                        const auto byte = parse_hex_byte( tok.substr( 0, bar ) );
+                        if( !byte )
+                            return false;
+
+                        set[ *byte ] = true;
+
+                        if( bar == std::string_view::npos )
+                            break;
+
+                        tok = tok.substr( bar + 1 );
+                    }
+
+                    return add_position( false,
+                        [ & ]( uint8_t c ) {
+                            return set[ c ];
+                        }
+                    );
+                }
+
+                // wildcard
+                // "??" is also valid here
+                if( tok.front() == '?' ) {
+                    if( tok.size() > 2 )
+                        return false;
+
+                    return add_position( false, any_byte );
+                }
+
+                // byte
+                const auto byte = parse_hex_byte( tok );
+                if( !byte )
+                    return false;
+
+                return add_position( false,
+                    [ & ]( uint8_t c ) {
+                        return c == *byte;
+                    }
+                );
+            };
+
+            if( str.empty() )
+                return;
+
+            // iterate each token
+            // split strings by space
+            auto valid = true;
+
+            for( size_t pos = 0; valid && pos < str.size(); ) {
+                auto end = str.find( ' ', pos );
+                if( end == std::string_view::npos )
+                    end = str.size();
+
+                valid = parse_token( str.substr( pos, end - pos ) );
+
+                pos = end + 1;
+            }
+
+            // trailing gap
+            if( valid )
+                valid = flush_gap();
+
+            if( !valid || !m_positions ) {
+                *this = ExtPattern();
+
+                return;
+            }
+
+            m_final = state_t{ 1 } << ( m_positions - 1 );
+
+            // single byte at the first position? it can be searched for directly
+            const auto first_amt = std::count_if( m_masks.begin(), m_masks.end(),
+                []( state_t m ) {
+                    return ( m & 1 ) != 0;
+                }
+            );
+
+            if( first_amt == 1 ) {
+                const auto it = std::find_if( m_masks.begin(), m_masks.end(),
+                    []( state_t m ) {
+                        return ( m & 1 ) != 0;
+                    }
+                );
+
+                m_first_byte = (int16_t)( it - m_masks.begin() );
+            }
+        }
+
+        // index of the lowest set bit, value must not be 0
+        // note: no 64-bit bit scan on x86
+        static FORCEINLINE size_t get_lowest_bit( uint64_t value ) {
+            ulong_t idx = 0;
+
+            if( _BitScanForward( &idx, (ulong_t)( value & 0xFFFFFFFF ) ) )
+                return idx;
+
+            _BitScanForward( &idx, (ulong_t)( value >> 32 ) );
+
+            return idx + 32;
+        }
+
+        NOINLINE ExtPattern::state_t ExtPattern::get_starts( const uint8_t *scan_start, const uint8_t *end ) const {
+            // optional positions that can be skipped going backwards, for each fill distance below
+            // run[ k ] has bit p set if positions p to p + 2^k - 1 are all optional
+            std::array< state_t, 6 > run;
+
+            run[ 0 ] = m_optional;
+
+            for( size_t k = 1; k < run.size(); ++k )
+                run[ k ] = run[ k - 1 ] & ( run[ k - 1 ] >> ( 1 << ( k - 1 ) ) );
+
+            // a position can also start the rest of the match if every position between it and an active one is optional
+            // doubling shifts, so this doesn't loop over the width of a gap
+            const auto fill_down = [ & ]( state_t state ) {
+                for( size_t k = 0; k < run.size(); ++k )
+                    state |= ( state >> ( 1 << k ) ) & run[ k ];
+
+                return state;
+            };
+
+            // bit p is set if positions p to the last one can match [cur, end)
+            // nothing consumed yet, only a trailing gap can match nothing
+            auto state = fill_down( m_final & m_optional );
+
+            state_t out = 0;
+
+            for( size_t len = 1; len <= m_positions && end - len >= scan_start; ++len ) {
+                // step back a byte, the last position can always take the byte right before end
+                state = ( ( state >> 1 ) | ( ( len == 1 ) ? m_final : 0 ) ) & m_masks[ *( end - len ) ];
+                state = fill_down( state );
+
+                if( !state )
+                    break;
+
+                // position 0 reached, a match starts here
+                if( state & 1 )
+                    out |= state_t{ 1 } << ( m_positions - len );
+            }
+
+            return out;
+        }
+
+        NOINLINE uintptr_t ExtPattern::find( uintptr_t start, size_t size, size_t *count_out ) const {
+            uintptr_t out = 0;
+
+            if( count_out )
+                *count_out = 0;
+
+            if( !start || !size || empty() )
+                return 0;
+
+            const auto scan_start = (const uint8_t *)start;
+
+            state_t state = 0;
+
+            // starts already counted, bit k is the start at counted_low + k
+            // starts of later matches are never before the window of earlier ones, so 64 bits are enough
+            // the window starts below any real start, so the first shift is never negative
+            state_t   counted     = 0;
+            ptrdiff_t counted_low = -(ptrdiff_t)m_positions;
+
+            for( size_t i = 0; i < size; ++i ) {
+                // nothing active, skip to the next byte that can start a match
+                if( !state && m_first_byte >= 0 ) {
+                    const auto next = (const uint8_t *)( std::memchr( scan_start + i, m_first_byte, size - i ) );
+                    if( !next )
+                        break;
+
+                    i = (size_t)( next - scan_start );
+                }
+
+                // shift-and step
+                state = ( ( state << 1 ) | 1 ) & m_masks[ scan_start[ i ] ];
+
+                // fill optional blocks
+                // the borrow of each subtraction stops at the first active position (or the last position) of the block
+                if( m_optional ) {
+                    const auto with_last = state | m_block_last;
+
+                    state |= m_optional & ~( ( with_last - m_block_before ) ^ with_last );
+                }
+
+                if( !( state & m_final ) )
+                    continue;
+
+                // found the end of a match, bit k is a start at end - max_size() + k
+                const auto end    = scan_start + i + 1;
+                const auto starts = get_starts( scan_start, end );
+                if( !starts )
+                    continue;
+
+                // first match, earliest start
+                if( !out ) {
+                    out = (uintptr_t)( end - ( m_positions - get_lowest_bit( starts ) ) );
+
+                    if( !count_out )
+                        return out;
+                }
+
+                // move the window up to this match's, then count starts that weren't counted yet
+                const auto low   = (ptrdiff_t)( i + 1 ) - (ptrdiff_t)m_positions;
+                const auto shift = low - counted_low;
+
+                counted     = ( shift < 64 ) ? counted >> shift : 0;
+                counted_low = low;
+
+                *count_out += std::bitset< 64 >( starts & ~counted ).count();
+
+                counted |= starts;
+            }
+
+            return out;
+        }
+
+    } // namespace Build
+
+} // namespace PatternScan
\ No newline at end of file
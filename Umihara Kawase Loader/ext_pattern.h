@@ -0,0 +1,91 @@
+#pragma once
+
+#include "build_pattern.h"
+
+namespace PatternScan {
+
+    namespace Build {
+
+        //
+        // extended pattern, compiled to a bit-parallel NFA (shift-and)
+        // supports everything IDA-style patterns do, and:
+        //     "[n]"          n wildcards
+        //     "[a-b]"        a to b wildcards
+        //     "(75|74|0F)"   any of these bytes
+        //
+        // example: "E8 ? ? ? ? (B8|FF) [4-5] 8B"
+        //
+
+        class ExtPattern {
+        private:
+            // max amount of positions (bits in the state word)
+            static constexpr size_t MAX_POSITIONS = 64;
+
+            // types
+            using state_t = uint64_t;
+
+            // bit i is set if a byte matches position i
+            std::array< state_t, 256 > m_masks;
+
+            // optional (gap) positions
+            state_t m_optional;
+
+            // position before each optional block / last position of each optional block
+            state_t m_block_before;
+            state_t m_block_last;
+
+            // last position
+            state_t m_final;
+
+            // amount of positions, min / max match length
+            size_t m_positions;
+            size_t m_min_len;
+
+            // byte at the first position, -1 if there's more than one
+            int16_t m_first_byte;
+
+            // every start of a match that ends at end, bit ( max_size() - match length ) is set for each one
+            // the pattern is run backwards from end, so this never backtracks
+            NOINLINE state_t get_starts( const uint8_t *scan_start, const uint8_t *end ) const;
+
+        public:
+            NOINLINE ExtPattern();
+
+            NOINLINE ExtPattern( std::string_view str );
+
+            // does a string use the extended syntax?
+            static FORCEINLINE bool is_extended( std::string_view str ) {
+                return str.find_first_of( "[(" ) != std::string_view::npos;
+            }
+
+            // min / max bytes in a match
+            FORCEINLINE size_t min_size() const {
+                return m_min_len;
+            }
+
+            FORCEINLINE size_t max_size() const {
+                return m_positions;
+            }
+
+            // search range, returns first match (earliest end, then earliest start)
+            // every match is counted if count_out is set, matches with the same start (but another gap length) count once
+            NOINLINE uintptr_t find( uintptr_t start, size_t size, size_t *count_out = nullptr ) const;
+
+            // is the pattern empty?
+            FORCEINLINE bool empty() const {
+                return m_positions == 0;
+            }
+
+            // valid checks
+            FORCEINLINE operator bool() const {
+                return empty() != true;
+            }
+
+            FORCEINLINE bool operator !() const {
+                return empty() == true;
+            }
+        };
+
+    } // namespace Build
+
+} // namespace PatternScan
\ No newline at end of file
@@ -9,6 +9,7 @@
 //
 
 using hash32_t = FNV1aHash::T::HashBase< uint32_t >;
+using hash64_t = FNV1aHash::T::HashBase< uint64_t >;
 
 //
 // helper macros for compile-time hashes of a string_view / wstring_view
@@ -22,6 +23,20 @@ using hash32_t = FNV1aHash::T::HashBase< uint32_t >;
         return out;                                       \
     }()
 
+#define CT_HASH_32_FOLD( str )                                 \
+    []() {                                                     \
+        constexpr auto out = FNV1aHash::ct_get_32_fold( str ); \
+                                                               \
+        return out;                                            \
+    }()
+
+#define CT_HASH_64( str )                                 \
+    []() {                                                \
+        constexpr auto out = FNV1aHash::ct_get_64( str ); \
+                                                          \
+        return out;                                       \
+    }()
+
 //
 // FNV-1a hash implementation
 //
@@ -41,6 +56,9 @@ namespace FNV1aHash {
         constexpr uint32_t FNV_BASIS_32 = 0x811C9DC5;
         constexpr uint32_t FNV_PRIME_32 = 0x1000193;
 
+        constexpr uint64_t FNV_BASIS_64 = 0xCBF29CE484222325;
+        constexpr uint64_t FNV_PRIME_64 = 0x100000001B3;
+
     } // namespace T
 
     //
@@ -66,6 +84,43 @@ namespace FNV1aHash {
         return hash;
     }
 
+    // hash a single byte
+    // 64-bit hash
+    FORCEINLINE constexpr hash64_t hash_byte_64( uint8_t value, uint64_t hash = T::FNV_BASIS_64 ) {
+        return ( value ^ hash ) * T::FNV_PRIME_64;
+    }
+
+    // hash 2-byte value
+    // 64-bit hash
+    FORCEINLINE constexpr hash64_t hash_short_64( uint16_t value, uint64_t hash = T::FNV_BASIS_64 ) {
+        hash = hash_byte_64( (uint8_t)( value & 0xFF ), hash );
+        hash = hash_byte_64( (uint8_t)( ( value >> 8 ) & 0xFF ), hash );
+
+        return hash;
+    }
+
+    //
+    // case folding
+    // only ASCII 'A' - 'Z' are folded, so hashes don't depend on locale
+    //
+
+    template< typename t > FORCEINLINE constexpr t fold_ascii( t c ) {
+        return ( c >= 'A' && c <= 'Z' ) ? (t)( c | 0x20 ) : c;
+    }
+
+    // compare 2 strings with the same folding the hashes use
+    template< typename t > FORCEINLINE constexpr bool equals_fold( std::basic_string_view< t > a, std::basic_string_view< t > b ) {
+        if( a.size() != b.size() )
+            return false;
+
+        for( size_t i = 0; i < a.size(); ++i ) {
+            if( fold_ascii( a[ i ] ) != fold_ascii( b[ i ] ) )
+                return false;
+        }
+
+        return true;
+    }
+
     //
     // compile-time hashing
     //
@@ -98,6 +153,44 @@ namespace FNV1aHash {
         return out;
     }
 
+    // 32-bit hash, case folded
+    FORCEINLINE constexpr hash32_t ct_get_32_fold( std::string_view str ) {
+        hash32_t out = T::FNV_BASIS_32;
+
+        for( const auto &c : str )
+            out = hash_byte_32( fold_ascii( c ), out );
+
+        return out;
+    }
+
+    FORCEINLINE constexpr hash32_t ct_get_32_fold( std::wstring_view wstr ) {
+        hash32_t out = T::FNV_BASIS_32;
+
+        for( const auto &wc : wstr )
+            out = hash_short_32( fold_ascii( wc ), out );
+
+        return out;
+    }
+
+    // 64-bit hash
+    FORCEINLINE constexpr hash64_t ct_get_64( std::string_view str ) {
+        hash64_t out = T::FNV_BASIS_64;
+
+        for( const auto &c : str )
+            out = hash_byte_64( c, out );
+
+        return out;
+    }
+
+    FORCEINLINE constexpr hash64_t ct_get_64( std::wstring_view wstr ) {
+        hash64_t out = T::FNV_BASIS_64;
+
+        for( const auto &wc : wstr )
+            out = hash_short_64( wc, out );
+
+        return out;
+    }
+
     //
     // run-time hashing
     //
@@ -125,8 +218,167 @@ namespace FNV1aHash {
         return get_32( (uint8_t *)str.data(), str.size() );
     }
 
+    // note: wchar_t is only 2 bytes on windows, elsewhere it's hashed a char at a time like ct_get_32
     FORCEINLINE hash32_t get_32( std::wstring_view wstr ) {
-        return get_32( (uint16_t *)wstr.data(), wstr.size() );
+        if constexpr( sizeof( wchar_t ) == 2 )
+            return get_32( (uint16_t *)wstr.data(), wstr.size() );
+
+        else
+            return ct_get_32( wstr );
     }
 
+    // 32-bit hash, case folded
+    // folds 16 bytes at a time, then hashes the folded block
+    FORCEINLINE hash32_t get_32_fold( const uint8_t *data, size_t len ) {
+        alignas( 16 ) std::array< uint8_t, 16 > block;
+
+        hash32_t out = T::FNV_BASIS_32;
+        size_t   i   = 0;
+
+        // note: bytes >= 0x80 are negative here, so they never land in the range
+        const auto lo  = _mm_set1_epi8( 'A' - 1 );
+        const auto hi  = _mm_set1_epi8( 'Z' + 1 );
+        const auto bit = _mm_set1_epi8( 0x20 );
+
+        for( ; i + block.size() <= len; i += block.size() ) {
+            const auto cur   = _mm_loadu_si128( (const __m128i *)( data + i ) );
+            const auto upper = _mm_and_si128( _mm_cmpgt_epi8( cur, lo ), _mm_cmplt_epi8( cur, hi ) );
+
+            _mm_store_si128( (__m128i *)block.data(), _mm_or_si128( cur, _mm_and_si128( upper, bit ) ) );
+
+            for( const auto &c : block )
+                out = hash_byte_32( c, out );
+        }
+
+        for( ; i < len; ++i )
+            out = hash_byte_32( fold_ascii( data[ i ] ), out );
+
+        return out;
+    }
+
+    // folds 8 chars at a time, then hashes the folded block
+    FORCEINLINE hash32_t get_32_fold( const uint16_t *data, size_t len ) {
+        alignas( 16 ) std::array< uint16_t, 8 > block;
+
+        hash32_t out = T::FNV_BASIS_32;
+        size_t   i   = 0;
+
+        // note: chars >= 0x8000 are negative here, so they never land in the range
+        const auto lo  = _mm_set1_epi16( 'A' - 1 );
+        const auto hi  = _mm_set1_epi16( 'Z' + 1 );
+        const auto bit = _mm_set1_epi16( 0x20 );
+
+        for( ; i + block.size() <= len; i += block.size() ) {
+            const auto cur   = _mm_loadu_si128( (const __m128i *)( data + i ) );
+            const auto upper = _mm_and_si128( _mm_cmpgt_epi16( cur, lo ), _mm_cmplt_epi16( cur, hi ) );
+
+            _mm_store_si128( (__m128i *)block.data(), _mm_or_si128( cur, _mm_and_si128( upper, bit ) ) );
+
+            for( const auto &c : block )
+                out = hash_short_32( c, out );
+        }
+
+        for( ; i < len; ++i )
+            out = hash_short_32( fold_ascii( data[ i ] ), out );
+
+        return out;
+    }
+
+    FORCEINLINE hash32_t get_32_fold( std::string_view str ) {
+        return get_32_fold( (const uint8_t *)str.data(), str.size() );
+    }
+
+    FORCEINLINE hash32_t get_32_fold( std::wstring_view wstr ) {
+        if constexpr( sizeof( wchar_t ) == 2 )
+            return get_32_fold( (const uint16_t *)wstr.data(), wstr.size() );
+
+        else
+            return ct_get_32_fold( wstr );
+    }
+
+    // 64-bit hash
+    FORCEINLINE hash64_t get_64( const uint8_t *data, size_t len ) {
+        hash64_t out = T::FNV_BASIS_64;
+
+        for( size_t i = 0; i < len; ++i )
+            out = hash_byte_64( data[ i ], out );
+
+        return out;
+    }
+
+    FORCEINLINE hash64_t get_64( const uint16_t *data, size_t len ) {
+        hash64_t out = T::FNV_BASIS_64;
+
+        for( size_t i = 0; i < len; ++i )
+            out = hash_short_64( data[ i ], out );
+
+        return out;
+    }
+
+    FORCEINLINE hash64_t get_64( std::string_view str ) {
+        return get_64( (const uint8_t *)str.data(), str.size() );
+    }
+
+    FORCEINLINE hash64_t get_64( std::wstring_view wstr ) {
+        if constexpr( sizeof( wchar_t ) == 2 )
+            return get_64( (const uint16_t *)wstr.data(), wstr.size() );
+
+        else
+            return ct_get_64( wstr );
+    }
+
+    //
+    // hasher types, for code that takes the hash as a template parameter
+    //
+
+    class Hasher32 {
+    public:
+        using hash_t = hash32_t;
+
+        static FORCEINLINE constexpr hash_t ct_get( std::string_view str ) {
+            return ct_get_32( str );
+        }
+
+        static FORCEINLINE constexpr hash_t ct_get( std::wstring_view wstr ) {
+            return ct_get_32( wstr );
+        }
+
+        static FORCEINLINE hash_t get( const uint8_t *data, size_t len ) {
+            return get_32( (uint8_t *)data, len );
+        }
+
+        static FORCEINLINE hash_t get( std::string_view str ) {
+            return get_32( str );
+        }
+
+        static FORCEINLINE hash_t get( std::wstring_view wstr ) {
+            return get_32( wstr );
+        }
+    };
+
+    class Hasher64 {
+    public:
+        using hash_t = hash64_t;
+
+        static FORCEINLINE constexpr hash_t ct_get( std::string_view str ) {
+            return ct_get_64( str );
+        }
+
+        static FORCEINLINE constexpr hash_t ct_get( std::wstring_view wstr ) {
+            return ct_get_64( wstr );
+        }
+
+        static FORCEINLINE hash_t get( const uint8_t *data, size_t len ) {
+            return get_64( data, len );
+        }
+
+        static FORCEINLINE hash_t get( std::string_view str ) {
+            return get_64( str );
+        }
+
+        static FORCEINLINE hash_t get( std::wstring_view wstr ) {
+            return get_64( wstr );
+        }
+    };
+
 } // namespace FNV1aHash
\ No newline at end of file
@@ -19,6 +19,12 @@
 #define FINI_WIDE_SUPPORT
 #define INIP_USE_UNICODE
 
+// scan with compiled (SSE2) patterns, comment out to use the byte by byte scanner
+#define PATTERN_SCAN_USE_COMPILED
+
+// time the input hook and log latency histograms, off by default, it costs a logger thread and a few timestamps per frame
+// #define INPUT_LATENCY_STATS
+
 // no min(a,b) / max(a,b) macros
 #define NOMINMAX
 
@@ -53,15 +59,22 @@ using ulong_t = unsigned long;
 #include <type_traits>
 #include <limits>
 #include <cctype>
+#include <cstring>
 #include <optional>
 #include <iostream>
 #include <array>
+#include <bitset>
 #include <vector>
 #include <string>
 #include <sstream>
 #include <algorithm>
 #include <filesystem>
 #include <fstream>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <memory_resource>
+#include <chrono>
 
 // dinput
 #include <dinput.h>
@@ -92,10 +105,25 @@ extern std::shared_ptr< spdlog::logger > g_log;
 
 // misc
 #include "hash.h"
+#include "word_hash.h"
+#include "perfect_hash.h"
+#include "string_table.h"
 #include "safe_handle.h"
+#include "arena.h"
+#include "mapped_file.h"
+#include "text_decode.h"
 #include "utils.h"
+#include "module_cache.h"
 #include "pattern_scan.h"
 #include "detour.h"
 #include "ini_parser.h"
 
-#include "sdk.h"
\ No newline at end of file
+#include "sdk.h"
+#include "config.h"
+#include "config_cache.h"
+#include "config_watcher.h"
+#include "snapshot.h"
+#include "spsc_ring.h"
+#include "latency_stats.h"
+#include "signatures.h"
+#include "sig_report.h"
\ No newline at end of file
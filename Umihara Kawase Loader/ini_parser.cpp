@@ -6,68 +6,260 @@
     #define INIP_STR( x ) x
 #endif
 
-NOINLINE INIParser::INIParser( inip_str_view_t filename ) : m_valid{ false }, m_sections{} {
-    init( filename );
+//
+// value decoding
+//
+
+// bool spellings, any case
+static constexpr auto BOOL_STRINGS = PerfectHash::make_map< inip_char_t, bool, true >( {
+    { INIP_STR( "1"     ), true  },
+    { INIP_STR( "true"  ), true  },
+    { INIP_STR( "on"    ), true  },
+    { INIP_STR( "yes"   ), true  },
+    { INIP_STR( "0"     ), false },
+    { INIP_STR( "false" ), false },
+    { INIP_STR( "off"   ), false },
+    { INIP_STR( "no"    ), false }
+} );
+
+// parse an integer the way strtoll( str, &end, 0 ) would, minus locale and errno
+// "0x" prefix is hex, a leading "0" is octal, otherwise decimal
+// the whole string must be a number
+static NOINLINE bool parse_int( inip_str_view_t str, bool &out_negative, uint64_t &out_magnitude ) {
+    uint32_t base  = 10;
+    uint64_t value = 0;
+    size_t   i     = 0;
+
+    // sign
+    out_negative = false;
+
+    if( !str.empty() && ( str[ 0 ] == INIP_STR( '-' ) || str[ 0 ] == INIP_STR( '+' ) ) ) {
+        out_negative = str[ 0 ] == INIP_STR( '-' );
+
+        ++i;
+    }
+
+    // prefix
+    if( str.size() - i > 2 && str[ i ] == INIP_STR( '0' ) && ( str[ i + 1 ] == INIP_STR( 'x' ) || str[ i + 1 ] == INIP_STR( 'X' ) ) ) {
+        base = 16;
+        i    += 2;
+    }
+
+    else if( str.size() - i > 1 && str[ i ] == INIP_STR( '0' ) ) {
+        base = 8;
+        i    += 1;
+    }
+
+    // no digits
+    if( i >= str.size() )
+        return false;
+
+    for( ; i < str.size(); ++i ) {
+        const auto c = (uint32_t)str[ i ];
+        uint32_t   digit;
+
+        if( c >= '0' && c <= '9' )
+            digit = c - '0';
+
+        else if( ( c | 0x20 ) >= 'a' && ( c | 0x20 ) <= 'f' )
+            digit = ( c | 0x20 ) - 'a' + 10;
+
+        else
+            return false;
+
+        if( digit >= base )
+            return false;
+
+        // overflow
+        if( value > ( std::numeric_limits< uint64_t >::max() - digit ) / base )
+            return false;
+
+        value = value * base + digit;
+    }
+
+    out_magnitude = value;
+
+    return true;
 }
 
-NOINLINE bool INIParser::init( inip_str_view_t filename ) {
-    inip_str_t  cur_line;
-    SectionInfo *section_info = nullptr;
+NOINLINE std::optional< uint64_t > INIParser::parse_uint( inip_str_view_t str ) {
+    bool     negative;
+    uint64_t magnitude;
+
+    if( !parse_int( str, negative, magnitude ) || negative )
+        return {};
+
+    return magnitude;
+}
+
+NOINLINE void INIParser::ValueInfo::decode() {
+    bool     negative;
+    uint64_t magnitude;
+
+    if( m_value.empty() )
+        return;
+
+    // integer
+    if( parse_int( m_value, negative, magnitude ) ) {
+        if( !negative && magnitude > (uint64_t)std::numeric_limits< int64_t >::max() ) {
+            m_type = VALUE_UINT;
+            m_uint = magnitude;
+        }
+
+        else if( !negative || magnitude <= (uint64_t)std::numeric_limits< int64_t >::max() + 1 ) {
+            m_type = VALUE_INT;
+            m_int  = negative ? (int64_t)( 0 - magnitude ) : (int64_t)magnitude;
+        }
+    }
 
+    // floating point, or an integer too small for int64_t
+    // note: the value is null terminated in our buffer
+    if( m_type == VALUE_STR ) {
 #ifdef INIP_USE_UNICODE
-    const auto isspace_pred = []( int c ) {
-        return std::isspace( c );
-    };
+        wchar_t *end = nullptr;
 #else
-    const auto isspace_pred = []( uint8_t c ) {
-        return std::isspace( c );
-    };
+        char *end = nullptr;
 #endif
 
+        errno = 0;
+
+#ifdef INIP_USE_UNICODE
+        const auto value = std::wcstod( m_value.data(), &end );
+#else
+        const auto value = std::strtod( m_value.data(), &end );
+#endif
+
+        // no trailing characters allowed
+        if( end == m_value.data() + m_value.size() && errno == 0 ) {
+            m_type   = VALUE_DOUBLE;
+            m_double = value;
+        }
+    }
+
+    // bool
+    const auto value = BOOL_STRINGS.find( m_value );
+    if( value )
+        m_bool = *value ? 1 : 0;
+}
+
+//
+// INIParser
+//
+
+NOINLINE INIParser::INIParser( inip_str_view_t filename, bool ignore_case ) : m_valid{ false }, m_buffer{}, m_sections{}, m_index{}, m_index_mask{ 0 }, m_duplicates{ 0 }, m_names{}, m_ignore_case{ false }, m_folded_names{ true } {
+    init( filename, ignore_case );
+}
+
+NOINLINE INIParser::LineType INIParser::parse_line( inip_char_t *start, inip_char_t *end, inip_str_view_t &out_name, inip_str_view_t &out_value ) {
+    const auto isspace_pred = []( inip_char_t c ) {
+        return is_space( (uint32_t)c );
+    };
+
+    // strip all whitespace, in place
+    const auto stripped_end = std::remove_if( start, end, isspace_pred );
+
+    // empty line
+    const auto cur_line = inip_str_view_t( start, (size_t)( stripped_end - start ) );
+    if( cur_line.empty() )
+        return LINE_EMPTY;
+
+    // null terminate line, this is either where the new line was or inside the stripped whitespace
+    *stripped_end = INIP_STR( '\0' );
+
+    // ignore comments
+    // note: no support for trailing comments
+    if( cur_line[ 0 ] == INIP_STR( ';' ) || cur_line[ 0 ] == INIP_STR( '#' ) )
+        return LINE_EMPTY;
+
+    // new section open
+    if( cur_line[ 0 ] == INIP_STR( '[' ) ) {
+        // try to find end
+        const auto end_bracket_delim = cur_line.find_first_of( INIP_STR( ']' ) );
+        if( end_bracket_delim == INIP_STR_NPOS )
+            return LINE_ERROR;
+
+        // get section name
+        // start after first bracket
+        out_name = cur_line.substr( 1, end_bracket_delim - 1 );
+        if( out_name.empty() )
+            return LINE_ERROR;
+
+        return LINE_SECTION;
+    }
+
+    // assume it's a value
+    // try to find equal delim
+    const auto equal_delim = cur_line.find_first_of( INIP_STR( '=' ) );
+    if( equal_delim == INIP_STR_NPOS )
+        return LINE_ERROR;
+
+    // get name
+    // empty value names are not allowed
+    out_name = cur_line.substr( 0, equal_delim );
+    if( out_name.empty() )
+        return LINE_ERROR;
+
+    // get value
+    // null values are allowed...
+    out_value = cur_line.substr( equal_delim + 1 );
+
+    return LINE_VALUE;
+}
+
+NOINLINE bool INIParser::init( inip_str_view_t filename, bool ignore_case ) {
+    SectionInfo *section_info = nullptr;
+
+    m_valid = false;
+    m_buffer.clear();
+    m_sections.clear();
+    m_index.clear();
+    m_names.clear();
+    m_folded_names.clear();
+    m_index_mask  = 0;
+    m_duplicates  = 0;
+    m_ignore_case = ignore_case;
+
     // bad filename
     if( filename.empty() )
         return false;
 
-    // attempt to open file
-    auto file = inip_file_stream_t( filename, std::ios::binary );
-    if( !file )
+    // attempt to open and map file
+    const auto file = MappedFile( inip_str_t( filename ) );
+    if( !file.is_open() )
         return false;
 
-    // read by new line
-    while( std::getline( file, cur_line ) ) {
-        // empty line
-        if( cur_line.empty() )
-            continue;
+    // decode the document into our buffer once, everything after this is done in place
+    const auto file_data = file.get_data();
+    const auto file_size = file.get_size();
+    const auto encoding  = TextDecode::detect( file_data, file_size );
 
-        // strip all whitespace
-        cur_line.erase( std::remove_if( cur_line.begin(), cur_line.end(), isspace_pred ), cur_line.end() );
+    TextDecode::decode( file_data + encoding.m_bom_size, file_size - encoding.m_bom_size, encoding.m_encoding, m_buffer );
 
-        // ignore comments
-        // go to next line
-        // note: no support for trailing comments
-        if( cur_line[ 0 ] == INIP_STR( ';' ) || cur_line[ 0 ] == INIP_STR( '#' ) )
-            continue;
+    // so the last value can always be null terminated
+    m_buffer.push_back( INIP_STR( '\0' ) );
 
-        // new section open
-        if( cur_line[ 0 ] == INIP_STR( '[' ) ) {
-            // try to find end
-            const auto end_bracket_delim = cur_line.find_first_of( INIP_STR( ']' ) );
-            if( end_bracket_delim == INIP_STR_NPOS )
-                return false;
+    const auto doc_start = m_buffer.data();
+    const auto doc_end   = doc_start + m_buffer.size() - 1;
 
-            // get section name
-            // start after first bracket
-            const auto section_name = cur_line.substr( 1, end_bracket_delim - 1 );
-            if( section_name.empty() )
-                return false;
+    // read by new line
+    for( auto line_start = doc_start, line_end = doc_start; line_start < doc_end; line_start = line_end + 1 ) {
+        inip_str_view_t name, value;
+
+        line_end = std::find( line_start, doc_end, INIP_STR( '\n' ) );
 
-            // make hash of section name
-            const auto section_name_hash = FNV1aHash::get_32( section_name );
+        const auto line_type = parse_line( line_start, line_end, name, value );
+        if( line_type == LINE_ERROR )
+            return false;
+
+        // new section open
+        if( line_type == LINE_SECTION ) {
+            // intern section name
+            const auto section_name_id = m_names.intern_ref( name );
 
             // check if section exists already
             const auto sec_exists_it = std::find_if( m_sections.begin(), m_sections.end(),
                 [ & ]( const SectionInfo &s ) -> bool {
-                    return s.get_name_hash() == section_name_hash;
+                    return s.m_name_id == section_name_id;
                 }
             );
 
@@ -79,178 +271,179 @@ NOINLINE bool INIParser::init( inip_str_view_t filename ) {
             }
 
             // ... otherwise make a new section entry
-            m_sections.push_back( SectionInfo( section_name, section_name_hash ) );
+            m_sections.push_back( SectionInfo( m_names.get( section_name_id ), m_names.get_hash( section_name_id ), section_name_id ) );
 
             // try to get last section entry
             section_info = &m_sections.back();
-            if( !section_info )
-                return false;
         }
 
-        // assume it's a value
-        else {
+        else if( line_type == LINE_VALUE ) {
             // no section to work off of...
             if( !section_info )
                 return false;
 
-            // try to find equal delim
-            const auto equal_delim = cur_line.find_first_of( INIP_STR( '=' ) );
-            if( equal_delim == INIP_STR_NPOS )
-                return false;
-
-            // get name
-            // empty value names are not allowed
-            const auto value_name = cur_line.substr( 0, equal_delim );
-            if( value_name.empty() )
-                return false;
-
-            // make hash of value name
-            const auto value_name_hash = FNV1aHash::get_32( value_name );
-
-            // todo: check same value name?
-
-            // get value
-            // null values are allowed...
-            const auto value = cur_line.substr( equal_delim + 1 );
-
             // add to section
-            section_info->m_values.push_back( ValueInfo( value_name, value_name_hash, value ) );
+            // note: duplicate value names are detected when building the index
+            const auto value_name_id = m_names.intern_ref( name );
+
+            section_info->m_values.push_back( ValueInfo( m_names.get( value_name_id ), m_names.get_hash( value_name_id ), value, value_name_id ) );
         }
     }
 
+    // build lookup table
+    build_index();
+
     // if we got here, parsing succeeded
     m_valid = true;
 
     return true;
 }
 
-NOINLINE std::optional< INIParser::ValueInfo * > INIParser::get_value_info_by_hash( hash32_t section_name, hash32_t value_name ) {
-    // first, find section info by hash
-    const auto section_it = std::find_if( m_sections.begin(), m_sections.end(),
-        [ & ]( const SectionInfo &s ) {
-            return s.get_name_hash() == section_name;
-        }
-    );
+NOINLINE void INIParser::build_index() {
+    size_t value_amt = 0;
 
-    if( section_it == m_sections.end() )
-        return {};
+    for( const auto &s : m_sections )
+        value_amt += s.m_values.size();
+
+    // keep load factor at or below 50%
+    size_t capacity = MIN_INDEX_SIZE;
+    while( capacity < value_amt * 2 )
+        capacity <<= 1;
+
+    m_index.assign( capacity, IndexEntry{} );
+    m_index_mask = capacity - 1;
+
+    for( const auto &s : m_sections ) {
+        // names are interned already, folded ones are made here
+        const auto section_id = m_ignore_case ? m_folded_names.intern( s.m_name ) : s.m_name_id;
+
+        for( auto &v : s.m_values ) {
+            const auto value_id = m_ignore_case ? m_folded_names.intern( v.m_name ) : v.m_name_id;
+
+            auto slot = get_index_slot( section_id, value_id );
+
+            // linear probe to an empty slot
+            for( ; m_index[ slot ].m_value; slot = ( slot + 1 ) & m_index_mask ) {
+                const auto &e = m_index[ slot ];
+
+                // same section and value name, first one wins
+                if( e.matches( section_id, value_id ) )
+                    break;
+            }
+
+            if( m_index[ slot ].m_value ) {
+                ++m_duplicates;
 
-    // now, find the value info by hash
-    const auto value_it = std::find_if( section_it->m_values.begin(), section_it->m_values.end(),
-        [ & ]( const ValueInfo &s ) {
-            return s.get_value_name_hash() == value_name;
+                continue;
+            }
+
+            m_index[ slot ] = IndexEntry{ section_id, value_id, &v };
         }
-    );
+    }
+}
 
-    if( value_it == section_it->m_values.end() )
-        return {};
+NOINLINE const INIParser::ValueInfo *INIParser::get_value_info( inip_str_view_t section_name, inip_str_view_t value_name ) const {
+    if( m_index.empty() )
+        return nullptr;
+
+    // names that were never interned can't be in the index
+    const auto &names = get_index_names();
+
+    const auto section_id = names.find( section_name );
+    const auto value_id   = names.find( value_name );
+    if( section_id == name_table_t::INVALID_HANDLE || value_id == name_table_t::INVALID_HANDLE )
+        return nullptr;
+
+    // probe until an empty slot, the table is never full
+    for( auto slot = get_index_slot( section_id, value_id ); m_index[ slot ].m_value; slot = ( slot + 1 ) & m_index_mask ) {
+        const auto &e = m_index[ slot ];
+
+        if( e.matches( section_id, value_id ) )
+            return e.m_value;
+    }
 
-    return &( *value_it );
+    return nullptr;
 }
 
 NOINLINE inip_str_t INIParser::get_value_str( inip_str_view_t section_name, inip_str_view_t value_name, inip_str_t default_value ) {
-    const auto value_info = get_value_info_by_hash(
-        FNV1aHash::get_32( section_name ),
-        FNV1aHash::get_32( value_name )
-    );
+    const auto value_info = get_value_info( section_name, value_name );
 
-    return ( value_info ) ? ( *value_info )->get_str() : default_value;
+    return ( value_info ) ? inip_str_t( value_info->get_str() ) : default_value;
 }
 
 NOINLINE double INIParser::get_value_double( inip_str_view_t section_name, inip_str_view_t value_name, double default_value ) {
-    const auto value_info = get_value_info_by_hash(
-        FNV1aHash::get_32( section_name ),
-        FNV1aHash::get_32( value_name )
-    );
+    const auto value_info = get_value_info( section_name, value_name );
 
     if( !value_info )
         return default_value;
 
-    const auto out = ( *value_info )->get_double();
+    const auto out = value_info->get_double();
 
     return ( out ) ? *out : default_value;
 }
 
 NOINLINE float INIParser::get_value_float( inip_str_view_t section_name, inip_str_view_t value_name, float default_value ) {
-    const auto value_info = get_value_info_by_hash(
-        FNV1aHash::get_32( section_name ),
-        FNV1aHash::get_32( value_name )
-    );
+    const auto value_info = get_value_info( section_name, value_name );
 
     if( !value_info )
         return default_value;
 
-    const auto out = ( *value_info )->get_float();
+    const auto out = value_info->get_float();
 
     return ( out ) ? *out : default_value;
 }
 
 NOINLINE uint64_t INIParser::get_value_uint64( inip_str_view_t section_name, inip_str_view_t value_name, uint64_t default_value ) {
-    const auto value_info = get_value_info_by_hash(
-        FNV1aHash::get_32( section_name ),
-        FNV1aHash::get_32( value_name )
-    );
+    const auto value_info = get_value_info( section_name, value_name );
 
     if( !value_info )
         return default_value;
 
-    const auto out = ( *value_info )->get_uint64();
+    const auto out = value_info->get_uint64();
 
     return ( out ) ? *out : default_value;
 }
 
 NOINLINE int64_t INIParser::get_value_int64( inip_str_view_t section_name, inip_str_view_t value_name, int64_t default_value ) {
-    const auto value_info = get_value_info_by_hash(
-        FNV1aHash::get_32( section_name ),
-        FNV1aHash::get_32( value_name )
-    );
+    const auto value_info = get_value_info( section_name, value_name );
 
     if( !value_info )
         return default_value;
 
-    const auto out = ( *value_info )->get_int64();
+    const auto out = value_info->get_int64();
 
     return ( out ) ? *out : default_value;
 }
 
 NOINLINE uint32_t INIParser::get_value_uint32( inip_str_view_t section_name, inip_str_view_t value_name, uint32_t default_value ) {
-    const auto value_info = get_value_info_by_hash(
-        FNV1aHash::get_32( section_name ),
-        FNV1aHash::get_32( value_name )
-    );
+    const auto value_info = get_value_info( section_name, value_name );
 
     if( !value_info )
         return default_value;
 
-    const auto out = ( *value_info )->get_uint32();
+    const auto out = value_info->get_uint32();
 
     return ( out ) ? *out : default_value;
 }
 
 NOINLINE int32_t INIParser::get_value_int32( inip_str_view_t section_name, inip_str_view_t value_name, int32_t default_value ) {
-    const auto value_info = get_value_info_by_hash(
-        FNV1aHash::get_32( section_name ),
-        FNV1aHash::get_32( value_name )
-    );
+    const auto value_info = get_value_info( section_name, value_name );
 
     if( !value_info )
         return default_value;
 
-    const auto out = ( *value_info )->get_int32();
+    const auto out = value_info->get_int32();
 
     return ( out ) ? *out : default_value;
 }
 
 NOINLINE bool INIParser::get_value_bool( inip_str_view_t section_name, inip_str_view_t value_name, bool default_value ) {
-    const auto value_info = get_value_info_by_hash(
-        FNV1aHash::get_32( section_name ),
-        FNV1aHash::get_32( value_name )
-    );
+    const auto value_info = get_value_info( section_name, value_name );
 
     if( !value_info )
         return default_value;
 
-    const auto out = ( *value_info )->get_bool();
+    const auto out = value_info->get_bool();
 
     return ( out ) ? *out : default_value;
 }
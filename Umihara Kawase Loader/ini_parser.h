@@ -15,145 +15,145 @@
 
 #ifdef INIP_USE_UNICODE
     // type(s)
-    using inip_str_t         = std::wstring;
-    using inip_str_view_t    = std::wstring_view;
-    using inip_file_stream_t = std::wifstream;
+    using inip_char_t     = wchar_t;
+    using inip_str_t      = std::wstring;
+    using inip_str_view_t = std::wstring_view;
 
     #define INIP_STR( x ) L ##x
 #else
     // type(s)
-    using inip_str_t         = std::string;
-    using inip_str_view_t    = std::string_view;
-    using inip_file_stream_t = std::ifstream;
+    using inip_char_t     = char;
+    using inip_str_t      = std::string;
+    using inip_str_view_t = std::string_view;
 
     #define INIP_STR( x ) x
 #endif
 
+// fwd declare
+class INIReader;
+
+//
+// whole document INI parser with indexed lookups
+// note: the loader streams config.ini through INIReader and only uses parse_line / parse_uint / ValueInfo from here
+// the document itself (index, ignore case mode, name interning) has no user in the DLL, it's library code used by the tests
+// /OPT:REF keeps it out of the release build
+//
+
 class INIParser {
 private:
+    // allow INIReader to use the line parser
+    friend class INIReader;
+
+    // interned names, equal ids mean equal names
+    using name_table_t = StringTable< inip_char_t >;
+    using name_id_t    = name_table_t::handle_t;
+
     // valid ini file?
     bool m_valid;
 
+    // the whole document, names and values are slices into this
+    // note: values are null terminated in here
+    std::vector< inip_char_t > m_buffer;
+
     // string / wstring npos value
     static constexpr auto INIP_STR_NPOS = inip_str_t::npos;
 
+    // line types
+    enum LineType : uint8_t {
+        LINE_EMPTY = 0, // empty or comment
+        LINE_SECTION,   // name is set
+        LINE_VALUE,     // name and value are set
+        LINE_ERROR
+    };
+
+    // strip whitespace from a line in place and figure out what it is
+    // names and values point into the line, there must be room for a null terminator at end
+    static NOINLINE LineType parse_line( inip_char_t *start, inip_char_t *end, inip_str_view_t &out_name, inip_str_view_t &out_value );
+
 public:
+    // decoded value type
+    enum ValueType : uint8_t {
+        VALUE_STR = 0, // not a number
+        VALUE_INT,     // integer, fits in int64_t
+        VALUE_UINT,    // integer above int64_t max
+        VALUE_DOUBLE   // floating point
+    };
+
     //
     // info about each section value
     //
 
     class ValueInfo {
     private:
-        // allow INIParser to access
+        // allow INIParser / INIReader to access
         friend class INIParser;
+        friend class INIReader;
 
         // name of value
-        inip_str_t m_name;
+        inip_str_view_t m_name;
 
         // value name hash
         hash32_t m_name_hash;
 
-        // value
-        inip_str_t m_value;
+        // interned name, only set by INIParser
+        name_id_t m_name_id;
 
-        // ctors
-        ValueInfo() = default;
-
-        FORCEINLINE ValueInfo( inip_str_view_t name, hash32_t name_hash, inip_str_view_t value ) : m_name{ name }, m_name_hash{ name_hash }, m_value{ value } {
+        // value (null terminated)
+        inip_str_view_t m_value;
 
-        }
-
-        // try to convert string to an int / float type
-        template< typename t > NOINLINE std::optional< t > convert_str( inip_str_view_t str ) const {
-            t out;
+        // decoded value, filled once at parse time
+        ValueType m_type;
 
-#ifdef INIP_USE_UNICODE
-            wchar_t *end = nullptr;
-#else
-            char *end = nullptr;
-#endif
+        // 1 / 0 if the value is a valid bool string, -1 otherwise
+        int8_t m_bool;
 
-            //
-            // check type
-            //
+        union {
+            int64_t  m_int;
+            uint64_t m_uint;
+            double   m_double;
+        };
 
-            // double
-            if constexpr( std::is_same_v< t, double > ) {
-#ifdef INIP_USE_UNICODE
-                out = (t)( std::wcstod( m_value.c_str(), &end ) );
-#else
-                out = (t)( std::strtod( m_value.c_str(), &end ) );
-#endif
-            }
+        // ctors
+        ValueInfo() = default;
 
-            // float
-            else if( std::is_same_v< t, float > ) {
-#ifdef INIP_USE_UNICODE
-                out = (t)( std::wcstof( m_value.c_str(), &end ) );
-#else
-                out = (t)( std::strtof( m_value.c_str(), &end ) );
-#endif
-            }
+        FORCEINLINE ValueInfo( inip_str_view_t name, hash32_t name_hash, inip_str_view_t value, name_id_t name_id = name_table_t::INVALID_HANDLE ) : m_name{ name }, m_name_hash{ name_hash }, m_name_id{ name_id }, m_value{ value }, m_type{ VALUE_STR }, m_bool{ -1 }, m_uint{ 0 } {
+            decode();
+        }
 
-            // 32-bit or 64-bit int
-            else if( std::is_integral_v< t > ) {
-                // 64-bit or 32-bit int?
-                constexpr auto is_64bit = ( sizeof( t ) ) == 8;
+        // decode value string to a number / bool
+        NOINLINE void decode();
 
-                // unsigned
-                if( std::is_unsigned_v< t > ) {
-                    // 64-bit
-                    if( is_64bit ) {
-#ifdef INIP_USE_UNICODE
-                        out = (t)( std::wcstoull( m_value.c_str(), &end, 0 ) );
-#else
-                        out = (t)( std::strtoull( m_value.c_str(), &end, 0 ) );
-#endif
-                    }
+        // read decoded integer, fails if it doesn't fit in t
+        template< typename t > FORCEINLINE std::optional< t > get_integral() const {
+            using limits_t = std::numeric_limits< t >;
 
-                    // 32-bit or lower
-                    else {
-#ifdef INIP_USE_UNICODE
-                        out = (t)( std::wcstoul( m_value.c_str(), &end, 0 ) );
-#else
-                        out = (t)( std::strtoul( m_value.c_str(), &end, 0 ) );
-#endif
-                    }
+            if( m_type == VALUE_INT ) {
+                if constexpr( std::is_signed_v< t > ) {
+                    if( m_int < (int64_t)limits_t::min() || m_int > (int64_t)limits_t::max() )
+                        return {};
                 }
 
-                // signed
                 else {
-                    // 64-bit
-                    if( is_64bit ) {
-#ifdef INIP_USE_UNICODE
-                        out = (t)( std::wcstoll( m_value.c_str(), &end, 0 ) );
-#else
-                        out = (t)( std::strtoll( m_value.c_str(), &end, 0 ) );
-#endif
-                    }
-
-                    // 32-bit or lower
-                    else {
-#ifdef INIP_USE_UNICODE
-                        out = (t)( std::wcstol( m_value.c_str(), &end, 0 ) );
-#else
-                        out = (t)( std::strtol( m_value.c_str(), &end, 0 ) );
-#endif
-                    }
+                    if( m_int < 0 || (uint64_t)m_int > (uint64_t)limits_t::max() )
+                        return {};
                 }
+
+                return (t)m_int;
             }
 
-            // check errors, no trailing numbers in strings allowed
-            // only the first valid number is converted (and allowed)
-            if( !end || errno != 0 || *end != '\0' )
-                return {};
+            if( m_type == VALUE_UINT ) {
+                if( m_uint > (uint64_t)limits_t::max() )
+                    return {};
+
+                return (t)m_uint;
+            }
 
-            return out;
+            return {};
         }
 
     public:
         // return name of value
-        FORCEINLINE inip_str_t get_value_name() const {
+        FORCEINLINE inip_str_view_t get_value_name() const {
             return m_name;
         }
 
@@ -162,84 +162,57 @@ public:
             return m_name_hash;
         }
 
+        // returns decoded value type
+        FORCEINLINE ValueType get_type() const {
+            return m_type;
+        }
+
         // returns set value string
-        FORCEINLINE inip_str_t get_str() const {
+        FORCEINLINE inip_str_view_t get_str() const {
             return m_value;
         }
 
         // returns set value double
-        FORCEINLINE auto get_double() const {
-            return convert_str< double >( m_value );
+        FORCEINLINE std::optional< double > get_double() const {
+            switch( m_type ) {
+                case VALUE_INT:    return (double)m_int;
+                case VALUE_UINT:   return (double)m_uint;
+                case VALUE_DOUBLE: return m_double;
+                default:           return {};
+            }
         }
 
         // returns set value float
-        FORCEINLINE auto get_float() const {
-            return convert_str< float >( m_value );
+        FORCEINLINE std::optional< float > get_float() const {
+            const auto out = get_double();
+
+            return ( out ) ? std::optional< float >( (float)*out ) : std::nullopt;
         }
 
         // returns set value uint64_t
         FORCEINLINE auto get_uint64() const {
-            return convert_str< uint64_t >( m_value );
+            return get_integral< uint64_t >();
         }
 
         // returns set value int64_t
         FORCEINLINE auto get_int64() const {
-            return convert_str< int64_t >( m_value );
+            return get_integral< int64_t >();
         }
 
         // returns set value uint32_t
         FORCEINLINE auto get_uint32() const {
-            return convert_str< uint32_t >( m_value );
+            return get_integral< uint32_t >();
         }
 
         // returns set value int32_t
         FORCEINLINE auto get_int32() const {
-            return convert_str< int32_t >( m_value );
+            return get_integral< int32_t >();
         }
 
         // returns set value bool
-        NOINLINE std::optional< bool > get_bool() const {
-#ifdef INIP_USE_UNICODE
-            const auto tolower_pred = []( int c ) {
-                return std::tolower( c );
-            };
-#else
-            const auto tolower_pred = []( uint8_t c ) {
-                return std::tolower( c );
-            };
-#endif
-
-            // make copy of value string
-            auto value_str = m_value;
-
-            // convert to lowercase
-            std::transform( value_str.begin(), value_str.end(), value_str.begin(), tolower_pred );
-
-            // check hash
-            // return true / false
-            // note: int strings besides these are not supported and treated as invalid
-            //       (for example, an int or floating point value above 1)
-            switch( FNV1aHash::get_32( value_str ) ) {
-                case CT_HASH_32( INIP_STR( "1"    ) ):
-                case CT_HASH_32( INIP_STR( "true" ) ):
-                case CT_HASH_32( INIP_STR( "on"   ) ):
-                case CT_HASH_32( INIP_STR( "yes"  ) ): {
-                    return true;
-                }
-
-                case CT_HASH_32( INIP_STR( "0"      ) ):
-                case CT_HASH_32( INIP_STR( "false" ) ):
-                case CT_HASH_32( INIP_STR( "off"   ) ):
-                case CT_HASH_32( INIP_STR( "no"    ) ): {
-                    return false;
-                }
-
-                default: {
-                    return {};
-                }
-            }
-
-            return {};
+        // note: only "1", "true", "on", "yes" and "0", "false", "off", "no" are valid (any case)
+        FORCEINLINE std::optional< bool > get_bool() const {
+            return ( m_bool >= 0 ) ? std::optional< bool >( m_bool != 0 ) : std::nullopt;
         }
     };
 
@@ -256,24 +229,27 @@ public:
         friend class INIParser;
 
         // section name
-        inip_str_t m_name;
+        inip_str_view_t m_name;
 
         // section name hash
         hash32_t m_name_hash;
 
+        // interned name
+        name_id_t m_name_id;
+
         // section vars and values
         section_vars_t m_values;
 
         // ctors
         SectionInfo() = default;
 
-        FORCEINLINE SectionInfo( inip_str_view_t name, hash32_t name_hash ) : m_name{ name }, m_name_hash{ name_hash }, m_values{} {
+        FORCEINLINE SectionInfo( inip_str_view_t name, hash32_t name_hash, name_id_t name_id ) : m_name{ name }, m_name_hash{ name_hash }, m_name_id{ name_id }, m_values{} {
 
         }
 
     public:
         // name of section
-        FORCEINLINE inip_str_t get_name() const {
+        FORCEINLINE inip_str_view_t get_name() const {
             return m_name;
         }
 
@@ -292,20 +268,90 @@ public:
     using sections_t = std::vector< SectionInfo >;
 
 private:
+    //
+    // flat lookup table entry, keyed by ( section id, value id )
+    //
+
+    class IndexEntry {
+    public:
+        name_id_t        m_section_id;
+        name_id_t        m_value_id;
+        const ValueInfo *m_value;
+
+        // names are interned, comparing ids is enough
+        FORCEINLINE bool matches( name_id_t section_id, name_id_t value_id ) const {
+            return m_section_id == section_id && m_value_id == value_id;
+        }
+    };
+
+    // min lookup table size (power of 2)
+    static constexpr size_t MIN_INDEX_SIZE = 16;
+
     // holds all sections and section values
     sections_t m_sections;
 
-    // find value by hash
-    NOINLINE std::optional< ValueInfo * > get_value_info_by_hash( hash32_t section_name, hash32_t value_name );
+    // open-addressing lookup table, empty slots have a null value
+    // note: points into m_sections, only built once parsing is done
+    std::vector< IndexEntry > m_index;
+    size_t                    m_index_mask;
+
+    // amount of duplicate values (same section and name)
+    size_t m_duplicates;
+
+    // section and value names, each distinct name once
+    // note: these point into m_buffer, nothing is copied
+    name_table_t m_names;
+
+    // lookups ignore ASCII case in section and value names
+    // note: only the index is affected, names are kept as they are
+    bool m_ignore_case;
+
+    // folded names for the index, only used if m_ignore_case is set
+    name_table_t m_folded_names;
+
+    // names the index is keyed by
+    FORCEINLINE const name_table_t &get_index_names() const {
+        return m_ignore_case ? m_folded_names : m_names;
+    }
+
+    // get the first slot for a ( section, value ) id pair
+    FORCEINLINE size_t get_index_slot( name_id_t section_id, name_id_t value_id ) const {
+        return ( ( section_id * 0x9E3779B1 ) ^ ( value_id * 0x85EBCA77 ) ) & m_index_mask;
+    }
+
+    // build lookup table from parsed sections
+    NOINLINE void build_index();
+
+    // find value by name
+    NOINLINE const ValueInfo *get_value_info( inip_str_view_t section_name, inip_str_view_t value_name ) const;
 
 public:
-    INIParser() = default;
+    INIParser() : m_valid{ false }, m_buffer{}, m_sections{}, m_index{}, m_index_mask{ 0 }, m_duplicates{ 0 }, m_names{}, m_ignore_case{ false }, m_folded_names{ true } {
+
+    }
 
     // open and parse INI file
-    NOINLINE INIParser( inip_str_view_t filename );
+    NOINLINE INIParser( inip_str_view_t filename, bool ignore_case = false );
+
+    // slices point into our buffer, moves keep it in place but copies wouldn't
+    INIParser( const INIParser & )             = delete;
+    INIParser &operator =( const INIParser & ) = delete;
+
+    INIParser( INIParser && )             = default;
+    INIParser &operator =( INIParser && ) = default;
 
     // open and parse INI file
-    NOINLINE bool init( inip_str_view_t filename );
+    NOINLINE bool init( inip_str_view_t filename, bool ignore_case = false );
+
+    // parse an unsigned integer the same way values are decoded
+    // "0x" prefix is hex, a leading "0" is octal, otherwise decimal
+    static NOINLINE std::optional< uint64_t > parse_uint( inip_str_view_t str );
+
+    // whitespace stripped from lines, same set as isspace in the C locale
+    // note: a plain ASCII check, std::isspace is undefined for code units that don't fit in an unsigned char
+    static FORCEINLINE constexpr bool is_space( uint32_t c ) {
+        return c == ' ' || ( c >= '\t' && c <= '\r' );
+    }
 
     // returns set value string
     NOINLINE inip_str_t get_value_str( inip_str_view_t section_name, inip_str_view_t value_name, inip_str_t default_value );
@@ -336,6 +382,11 @@ public:
         return m_sections;
     }
 
+    // amount of duplicate values, only the first of each is used
+    FORCEINLINE size_t get_duplicate_count() const {
+        return m_duplicates;
+    }
+
     // ini parse error?
     FORCEINLINE bool is_valid() const {
         return m_valid;
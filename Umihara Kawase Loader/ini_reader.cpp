@@ -0,0 +1,72 @@
+#include "ini_reader.h"
+
+NOINLINE INIReader::INIReader( inip_str_view_t filename ) : m_file{ inip_str_t( filename ) }, m_encoding{ TextDecode::ENC_UTF8 }, m_pos{ 0 }, m_error{ !m_file.is_open() }, m_line{}, m_section{}, m_section_hash{ 0 }, m_has_section{ false }, m_value{} {
+    const auto encoding = TextDecode::detect( m_file.get_data(), m_file.get_size() );
+
+    // skip BOM
+    m_encoding = encoding.m_encoding;
+    m_pos      = encoding.m_bom_size;
+}
+
+NOINLINE bool INIReader::next( Event &out ) {
+    const auto file_data = m_file.get_data();
+    const auto file_size = m_file.get_size();
+
+    if( m_error )
+        return false;
+
+    while( m_pos < file_size ) {
+        inip_str_view_t name, value;
+
+        // find end of line
+        const auto line_start = file_data + m_pos;
+        const auto line_bytes = TextDecode::find_newline( line_start, file_size - m_pos, m_encoding );
+
+        m_pos += line_bytes + TextDecode::get_unit_size( m_encoding );
+
+        // decode line, +1 for the null terminator
+        m_line.clear();
+
+        TextDecode::decode( line_start, line_bytes, m_encoding, m_line );
+
+        const auto line_size = m_line.size();
+
+        m_line.push_back( 0 );
+
+        const auto line_type = INIParser::parse_line( m_line.data(), m_line.data() + line_size, name, value );
+        if( line_type == INIParser::LINE_ERROR ) {
+            m_error = true;
+
+            return false;
+        }
+
+        // new section, keep a copy of its name since the line buffer is reused
+        if( line_type == INIParser::LINE_SECTION ) {
+            m_section.assign( name.begin(), name.end() );
+
+            m_section_hash = FNV1aHash::get_32( name );
+            m_has_section  = true;
+
+            continue;
+        }
+
+        if( line_type == INIParser::LINE_VALUE ) {
+            // no section to work off of...
+            if( !m_has_section ) {
+                m_error = true;
+
+                return false;
+            }
+
+            m_value = INIParser::ValueInfo( name, FNV1aHash::get_32( name ), value );
+
+            out.m_section      = inip_str_view_t( m_section.data(), m_section.size() );
+            out.m_section_hash = m_section_hash;
+            out.m_value        = &m_value;
+
+            return true;
+        }
+    }
+
+    return false;
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "ini_parser.h"
+
+//
+// streaming INI reader
+// yields one value at a time without building the whole document, memory use only depends on the longest line
+//
+
+class INIReader {
+public:
+    // a single value
+    // note: everything in here is only valid until the next call to next()
+    class Event {
+    public:
+        inip_str_view_t             m_section;
+        hash32_t                    m_section_hash;
+        const INIParser::ValueInfo *m_value;
+    };
+
+private:
+    MappedFile m_file;
+
+    // file encoding
+    TextDecode::Encoding m_encoding;
+
+    // read position in file
+    size_t m_pos;
+
+    // parse error?
+    bool m_error;
+
+    // current line, reused for every line
+    std::vector< inip_char_t > m_line;
+
+    // current section name, reused for every section
+    std::vector< inip_char_t > m_section;
+    hash32_t                   m_section_hash;
+    bool                       m_has_section;
+
+    // current value
+    INIParser::ValueInfo m_value;
+
+public:
+    // open and map INI file
+    NOINLINE INIReader( inip_str_view_t filename );
+
+    INIReader( const INIReader & )             = delete;
+    INIReader &operator =( const INIReader & ) = delete;
+
+    // read next value
+    // false at the end of the file or on a parse error
+    NOINLINE bool next( Event &out );
+
+    // call callback( const Event & ) for each value, return false from the callback to stop early
+    // false on a parse error
+    template< typename fn_t > FORCEINLINE bool for_each( fn_t &&callback ) {
+        Event event;
+
+        while( next( event ) ) {
+            if( !callback( static_cast< const Event & >( event ) ) )
+                return true;
+        }
+
+        return !m_error;
+    }
+
+    // file opened?
+    FORCEINLINE bool is_open() const {
+        return m_file.is_open();
+    }
+
+    // hit a parse error?
+    FORCEINLINE bool has_error() const {
+        return m_error;
+    }
+};
@@ -0,0 +1,365 @@
+#include "ini_writer.h"
+
+#ifdef INIP_USE_UNICODE
+    #define INIP_STR( x ) L ##x
+#else
+    #define INIP_STR( x ) x
+#endif
+
+// whitespace the parser strips
+static FORCEINLINE bool is_space_unit( uint32_t c ) {
+    return INIParser::is_space( c );
+}
+
+// can a section / value name be written without changing what the file means?
+// new lines would start a new line, brackets / '=' would be read back as part of the line structure
+// whitespace is stripped when reading, a name with some in it would never be found again
+static NOINLINE bool is_valid_name( inip_str_view_t name ) {
+    if( name.empty() || name[ 0 ] == INIP_STR( ';' ) || name[ 0 ] == INIP_STR( '#' ) )
+        return false;
+
+    return std::none_of( name.begin(), name.end(),
+        []( inip_char_t c ) {
+            return c == INIP_STR( '\n' ) || c == INIP_STR( '\0' ) || c == INIP_STR( '[' ) || c == INIP_STR( ']' ) || c == INIP_STR( '=' ) || is_space_unit( (uint32_t)c );
+        }
+    );
+}
+
+// values only have to stay on their line
+static NOINLINE bool is_valid_value( inip_str_view_t value ) {
+    return std::none_of( value.begin(), value.end(),
+        []( inip_char_t c ) {
+            return c == INIP_STR( '\n' ) || c == INIP_STR( '\r' ) || c == INIP_STR( '\0' );
+        }
+    );
+}
+
+NOINLINE INIWriter::INIWriter() : m_data{}, m_encoding{ TextDecode::ENC_UTF8 }, m_bom_size{ 0 }, m_crlf{ false }, m_write_time{ 0 }, m_size{ 0 }, m_edits{}, m_sections{}, m_names{} {
+
+}
+
+NOINLINE uint32_t INIWriter::get_unit( const std::vector< uint8_t > &data, size_t offset ) const {
+    if( m_encoding == TextDecode::ENC_UTF8 )
+        return data[ offset ];
+
+    if( m_encoding == TextDecode::ENC_UTF16BE )
+        return (uint32_t)( ( data[ offset ] << 8 ) | data[ offset + 1 ] );
+
+    return (uint32_t)( data[ offset ] | ( data[ offset + 1 ] << 8 ) );
+}
+
+NOINLINE size_t INIWriter::add_stripped_name( size_t start, size_t end ) {
+    const auto offset = m_names.size();
+
+    TextDecode::decode( m_data.data() + start, end - start, m_encoding, m_names );
+
+    // whitespace is always a code unit of its own, so it can be stripped after decoding
+    const auto stripped_end = std::remove_if( m_names.begin() + offset, m_names.end(),
+        []( inip_char_t c ) {
+            return is_space_unit( (uint32_t)c );
+        }
+    );
+
+    m_names.erase( stripped_end, m_names.end() );
+
+    return offset;
+}
+
+NOINLINE void INIWriter::build_index() {
+    IndexedSection *section = nullptr;
+
+    m_sections.clear();
+    m_names.clear();
+
+    const auto unit_size = TextDecode::get_unit_size( m_encoding );
+
+    for( size_t line_start = m_bom_size; line_start < m_data.size(); ) {
+        const auto line_end  = line_start + TextDecode::find_newline( m_data.data() + line_start, m_data.size() - line_start, m_encoding );
+        const auto next_line = std::min( line_end + unit_size, m_data.size() );
+
+        // first non-whitespace unit
+        auto first = line_start;
+        while( first < line_end && is_space_unit( get_unit( first ) ) )
+            first += unit_size;
+
+        const auto c = ( first < line_end ) ? get_unit( first ) : 0;
+
+        // empty or comment
+        if( !c || c == ';' || c == '#' ) {
+            line_start = next_line;
+
+            continue;
+        }
+
+        // section
+        if( c == '[' ) {
+            auto close = first;
+            while( close < line_end && get_unit( close ) != ']' )
+                close += unit_size;
+
+            const auto name_offset = add_stripped_name( first + unit_size, close );
+            const auto name_size   = m_names.size() - name_offset;
+            const auto name_hash   = FNV1aHash::get_32( get_name( name_offset, name_size ) );
+
+            // same name as an earlier section continues it, its name is already stored
+            section = find_section( get_name( name_offset, name_size ), name_hash );
+            if( section )
+                m_names.resize( name_offset );
+
+            else {
+                m_sections.push_back( IndexedSection{ name_hash, name_offset, name_size, 0, false, {} } );
+
+                section = &m_sections.back();
+            }
+
+            // new values go after the header if there aren't any
+            section->m_insert_offset = next_line;
+
+            line_start = next_line;
+
+            continue;
+        }
+
+        // value
+        auto equal = first;
+        while( equal < line_end && get_unit( equal ) != '=' )
+            equal += unit_size;
+
+        if( section && equal < line_end ) {
+            const auto name_offset = add_stripped_name( first, equal );
+            const auto name_size   = m_names.size() - name_offset;
+            const auto name_hash   = FNV1aHash::get_32( get_name( name_offset, name_size ) );
+
+            // first one wins, same as the parser
+            if( find_value( *section, get_name( name_offset, name_size ), name_hash ) )
+                m_names.resize( name_offset );
+
+            else {
+                auto value_start = equal + unit_size;
+                while( value_start < line_end && is_space_unit( get_unit( value_start ) ) )
+                    value_start += unit_size;
+
+                auto value_end = line_end;
+                while( value_end > value_start && is_space_unit( get_unit( value_end - unit_size ) ) )
+                    value_end -= unit_size;
+
+                section->m_values.push_back( IndexedValue{ name_hash, name_offset, name_size, value_start, value_end - value_start, NO_EDIT } );
+            }
+
+            // new values go after the last value of the section
+            section->m_insert_offset = next_line;
+        }
+
+        line_start = next_line;
+    }
+}
+
+NOINLINE INIWriter::IndexedSection *INIWriter::find_section( inip_str_view_t name, hash32_t name_hash ) {
+    const auto it = std::find_if( m_sections.begin(), m_sections.end(),
+        [ & ]( const IndexedSection &s ) {
+            return s.m_name_hash == name_hash && get_name( s.m_name_offset, s.m_name_size ) == name;
+        }
+    );
+
+    return ( it != m_sections.end() ) ? &( *it ) : nullptr;
+}
+
+NOINLINE INIWriter::IndexedValue *INIWriter::find_value( IndexedSection &section, inip_str_view_t name, hash32_t name_hash ) {
+    const auto it = std::find_if( section.m_values.begin(), section.m_values.end(),
+        [ & ]( const IndexedValue &v ) {
+            return v.m_name_hash == name_hash && get_name( v.m_name_offset, v.m_name_size ) == name;
+        }
+    );
+
+    return ( it != section.m_values.end() ) ? &( *it ) : nullptr;
+}
+
+NOINLINE void INIWriter::append_text( std::vector< uint8_t > &out, inip_str_view_t text ) const {
+    TextDecode::encode( text, m_encoding, out );
+}
+
+NOINLINE bool INIWriter::init( const std_fs::path &file ) {
+    m_data.clear();
+    m_edits.clear();
+    m_sections.clear();
+    m_names.clear();
+
+    if( !Utils::get_file_info( file, m_write_time, m_size ) )
+        return false;
+
+    const auto mapped = MappedFile( file );
+    if( !mapped.is_open() || mapped.get_size() != m_size )
+        return false;
+
+    m_data.assign( mapped.get_data(), mapped.get_data() + mapped.get_size() );
+
+    const auto encoding = TextDecode::detect( m_data.data(), m_data.size() );
+
+    m_encoding = encoding.m_encoding;
+    m_bom_size = encoding.m_bom_size;
+
+    // keep line endings as they are
+    const auto unit_size = TextDecode::get_unit_size( m_encoding );
+    const auto first_nl  = m_bom_size + TextDecode::find_newline( m_data.data() + m_bom_size, m_data.size() - m_bom_size, m_encoding );
+
+    m_crlf = first_nl < m_data.size() && first_nl >= m_bom_size + unit_size && get_unit( first_nl - unit_size ) == '\r';
+
+    build_index();
+
+    return true;
+}
+
+NOINLINE bool INIWriter::set_value( inip_str_view_t section, inip_str_view_t name, inip_str_view_t value ) {
+    if( !is_valid_name( section ) || !is_valid_name( name ) || !is_valid_value( value ) )
+        return false;
+
+    const auto section_hash = FNV1aHash::get_32( section );
+    const auto name_hash    = FNV1aHash::get_32( name );
+
+    // new section, written at the end of the file
+    auto indexed_section = find_section( section, section_hash );
+    if( !indexed_section ) {
+        const auto name_offset = m_names.size();
+
+        m_names.insert( m_names.end(), section.begin(), section.end() );
+        m_sections.push_back( IndexedSection{ section_hash, name_offset, section.size(), m_data.size(), true, {} } );
+
+        indexed_section = &m_sections.back();
+    }
+
+    auto indexed_value = find_value( *indexed_section, name, name_hash );
+
+    // already edited, just swap the text
+    if( indexed_value && indexed_value->m_edit != NO_EDIT ) {
+        m_edits[ indexed_value->m_edit ].m_value = value;
+
+        return true;
+    }
+
+    // replace value span, or add value (and section) after the last value of the section / at the end
+    const auto insert = !indexed_value;
+
+    if( insert ) {
+        const auto name_offset = m_names.size();
+
+        m_names.insert( m_names.end(), name.begin(), name.end() );
+        indexed_section->m_values.push_back( IndexedValue{ name_hash, name_offset, name.size(), indexed_section->m_insert_offset, 0, NO_EDIT } );
+
+        indexed_value = &indexed_section->m_values.back();
+    }
+
+    indexed_value->m_edit = m_edits.size();
+
+    m_edits.push_back( Edit{ indexed_value->m_offset, indexed_value->m_size, insert, indexed_section->m_new, inip_str_t( section ), inip_str_t( name ), inip_str_t( value ) } );
+
+    return true;
+}
+
+NOINLINE bool INIWriter::save( const std_fs::path &file ) {
+    std::vector< uint8_t >    out;
+    std::vector< inip_str_t > added_sections;
+    uint64_t                  write_time, size;
+    DWORD                     written = 0;
+
+    const auto newline   = m_crlf ? INIP_STR( "\r\n" ) : INIP_STR( "\n" );
+    const auto unit_size = TextDecode::get_unit_size( m_encoding );
+
+    // changed behind our back?
+    if( !Utils::get_file_info( file, write_time, size ) || write_time != m_write_time || size != m_size )
+        return false;
+
+    // apply edits in file order, inserts at the same spot keep their order
+    auto edits = std::vector< const Edit * >( m_edits.size() );
+
+    std::transform( m_edits.begin(), m_edits.end(), edits.begin(),
+        []( const Edit &e ) {
+            return &e;
+        }
+    );
+
+    std::stable_sort( edits.begin(), edits.end(),
+        []( const Edit *a, const Edit *b ) {
+            return a->m_offset < b->m_offset;
+        }
+    );
+
+    // new sections go last, grouped so each header is written once
+    const auto first_new = std::stable_partition( edits.begin(), edits.end(),
+        []( const Edit *e ) {
+            return !e->m_new_section;
+        }
+    );
+
+    std::stable_sort( first_new, edits.end(),
+        []( const Edit *a, const Edit *b ) {
+            return a->m_section < b->m_section;
+        }
+    );
+
+    out.reserve( m_data.size() + 64 );
+
+    size_t pos = 0;
+
+    for( const auto e : edits ) {
+        out.insert( out.end(), m_data.begin() + pos, m_data.begin() + e->m_offset );
+
+        pos = e->m_offset + e->m_size;
+
+        // replace value only
+        if( !e->m_insert ) {
+            append_text( out, e->m_value );
+
+            continue;
+        }
+
+        // last line has no new line
+        if( e->m_offset == m_data.size() && out.size() > m_bom_size && get_unit( out, out.size() - unit_size ) != '\n' )
+            append_text( out, newline );
+
+        if( e->m_new_section && std::find( added_sections.begin(), added_sections.end(), e->m_section ) == added_sections.end() ) {
+            append_text( out, newline );
+            append_text( out, INIP_STR( "[" ) );
+            append_text( out, e->m_section );
+            append_text( out, INIP_STR( "]" ) );
+            append_text( out, newline );
+
+            added_sections.push_back( e->m_section );
+        }
+
+        append_text( out, e->m_name );
+        append_text( out, INIP_STR( " = " ) );
+        append_text( out, e->m_value );
+        append_text( out, newline );
+    }
+
+    out.insert( out.end(), m_data.begin() + pos, m_data.end() );
+
+    auto tmp_file = file;
+    tmp_file += L".tmp";
+
+    // write temp file, flushed so the move below can't reach the disk before the contents do
+    const auto write_tmp_file = [ & ]() {
+        const auto handle = SHandleI( CreateFileW( tmp_file.c_str(), GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr ) );
+        if( !handle )
+            return false;
+
+        return WriteFile( handle, out.data(), (DWORD)out.size(), &written, nullptr ) && written == out.size() && FlushFileBuffers( handle );
+    };
+
+    // ... and swap it in, don't leave a temp file behind if either fails
+    if( !write_tmp_file() || !MoveFileExW( tmp_file.c_str(), file.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH ) ) {
+        DeleteFileW( tmp_file.c_str() );
+
+        return false;
+    }
+
+    // saved, this is the new original
+    m_data = std::move( out );
+    m_edits.clear();
+
+    build_index();
+
+    return Utils::get_file_info( file, m_write_time, m_size );
+}
+
+#undef INIP_STR
@@ -0,0 +1,115 @@
+#pragma once
+
+#include "ini_parser.h"
+
+//
+// INI writer that keeps the file as it is
+// value changes are kept as an edit log over the original bytes, so comments, whitespace, ordering and encoding are untouched
+// the file is indexed once on load, edits are looked up / added through the index instead of rescanning the file
+//
+
+class INIWriter {
+private:
+    // a single change over the original bytes
+    // replacements swap out the value span, inserts (new values / sections) replace nothing
+    class Edit {
+    public:
+        size_t     m_offset;
+        size_t     m_size;
+        bool       m_insert;
+        bool       m_new_section;
+        inip_str_t m_section;
+        inip_str_t m_name;
+        inip_str_t m_value;
+    };
+
+    // no edit for an indexed value yet
+    static constexpr size_t NO_EDIT = std::numeric_limits< size_t >::max();
+
+    // a value in the file (or one added by an edit), first one wins like in the parser
+    // names are stripped and decoded, stored in m_names
+    class IndexedValue {
+    public:
+        hash32_t m_name_hash;
+        size_t   m_name_offset;
+        size_t   m_name_size;
+        size_t   m_offset;  // value span in the original bytes
+        size_t   m_size;
+        size_t   m_edit;    // index into m_edits
+    };
+
+    // a section, all blocks with the same name are merged
+    class IndexedSection {
+    public:
+        hash32_t                    m_name_hash;
+        size_t                      m_name_offset;
+        size_t                      m_name_size;
+        size_t                      m_insert_offset; // new values go after the section's last value / header
+        bool                        m_new;           // added by an edit, written at the end of the file
+        std::vector< IndexedValue > m_values;
+    };
+
+    // original file
+    std::vector< uint8_t > m_data;
+    TextDecode::Encoding   m_encoding;
+    size_t                 m_bom_size;
+
+    // file uses "\r\n"
+    bool m_crlf;
+
+    // write time / size when loaded, saving fails if the file changed since
+    uint64_t m_write_time;
+    uint64_t m_size;
+
+    // pending edits
+    std::vector< Edit > m_edits;
+
+    // index over the original bytes (and edits)
+    std::vector< IndexedSection > m_sections;
+    std::vector< inip_char_t >    m_names;
+
+    // read code unit at byte offset
+    NOINLINE uint32_t get_unit( const std::vector< uint8_t > &data, size_t offset ) const;
+
+    FORCEINLINE uint32_t get_unit( size_t offset ) const {
+        return get_unit( m_data, offset );
+    }
+
+    // decode units in [start, end) with all whitespace removed, like the parser does, and append to m_names
+    // returns offset of the name in m_names
+    NOINLINE size_t add_stripped_name( size_t start, size_t end );
+
+    FORCEINLINE inip_str_view_t get_name( size_t offset, size_t size ) const {
+        return inip_str_view_t( m_names.data() + offset, size );
+    }
+
+    // index sections and values in the original bytes, one pass
+    NOINLINE void build_index();
+
+    // find an indexed section / value, null if there's none
+    NOINLINE IndexedSection *find_section( inip_str_view_t name, hash32_t name_hash );
+    NOINLINE IndexedValue *find_value( IndexedSection &section, inip_str_view_t name, hash32_t name_hash );
+
+    // encode text in file encoding
+    NOINLINE void append_text( std::vector< uint8_t > &out, inip_str_view_t text ) const;
+
+public:
+    NOINLINE INIWriter();
+
+    // load file, false if it can't be read
+    NOINLINE bool init( const std_fs::path &file );
+
+    // set a value, adds it (and the section) if needed
+    // only the value itself is rewritten, the rest of the line stays as it is
+    // fails if the text would change the file's structure: new lines anywhere, whitespace, brackets or '=' in names
+    NOINLINE bool set_value( inip_str_view_t section, inip_str_view_t name, inip_str_view_t value );
+
+    // apply edits and write file, through a temp file that's flushed and moved over the original
+    // fails if the file changed since init()
+    NOINLINE bool save( const std_fs::path &file );
+
+    // any unsaved edits?
+    FORCEINLINE bool has_edits() const {
+        return !m_edits.empty();
+    }
+};
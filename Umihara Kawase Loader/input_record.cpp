@@ -0,0 +1,373 @@
+#include "input_record.h"
+
+namespace InputRecord {
+
+    NOINLINE Recorder::Recorder() :
+        m_recording{ false },
+        m_raw{ false },
+        m_ring{},
+        m_file{ nullptr },
+        m_chunk{},
+        m_prev{},
+        m_prev_delta{ 0 },
+        m_chunk_frame_amt{ 0 },
+        m_frame_amt{ 0 },
+        m_dropped_logged{ 0 },
+        m_stop_event{ nullptr },
+        m_thread{ nullptr } {
+
+    }
+
+    NOINLINE ulong_t __stdcall Recorder::thread_func( void *arg ) {
+        const auto recorder = (Recorder *)arg;
+
+        recorder->run();
+
+        return 0;
+    }
+
+    NOINLINE void Recorder::run() {
+        // write every FLUSH_TIME until stopped, then write whatever is left
+        while( WaitForSingleObject( m_stop_event, FLUSH_TIME ) == WAIT_TIMEOUT ) {
+            if( !flush() ) {
+                g_log->error( L"Input recording: write failed, recording stopped" );
+
+                m_recording.store( false, std::memory_order_release );
+
+                return;
+            }
+        }
+
+        if( !flush() )
+            g_log->error( L"Input recording: write failed" );
+    }
+
+    NOINLINE void Recorder::encode( const Frame &frame ) {
+        // first frame in the chunk, start from nothing pressed
+        if( !m_chunk_frame_amt ) {
+            m_prev        = {};
+            m_prev.m_time = frame.m_time;
+            m_prev_delta  = 0;
+        }
+
+        const auto delta       = frame.m_time - m_prev.m_time;
+        const auto raw_changed = m_raw && frame.m_raw != m_prev.m_raw;
+        const auto changed     = raw_changed || frame.m_key_state != m_prev.m_key_state;
+
+        // frames usually come at a steady rate, the change in delta is small
+        T::put_varint( m_chunk, ( T::zigzag( (int64_t)( delta - m_prev_delta ) ) << 1 ) | (uint64_t)changed );
+
+        if( changed ) {
+            T::put_varint( m_chunk, frame.m_key_state ^ m_prev.m_key_state );
+
+            if( m_raw ) {
+                // unchanged / changed byte runs, a few keys change per frame at most
+                for( size_t pos = 0; pos < RAW_SIZE; ) {
+                    const auto same_start = pos;
+
+                    while( pos < RAW_SIZE && frame.m_raw[ pos ] == m_prev.m_raw[ pos ] )
+                        ++pos;
+
+                    const auto diff_start = pos;
+
+                    while( pos < RAW_SIZE && frame.m_raw[ pos ] != m_prev.m_raw[ pos ] )
+                        ++pos;
+
+                    T::put_varint( m_chunk, diff_start - same_start );
+                    T::put_varint( m_chunk, pos - diff_start );
+
+                    m_chunk.insert( m_chunk.end(), frame.m_raw.begin() + diff_start, frame.m_raw.begin() + pos );
+                }
+            }
+        }
+
+        m_prev       = frame;
+        m_prev_delta = delta;
+
+        ++m_chunk_frame_amt;
+    }
+
+    NOINLINE bool Recorder::flush() {
+        ChunkHeader header{};
+        DWORD       written = 0;
+
+        // room for the header, it's filled in once the frames are encoded
+        m_chunk.assign( sizeof( ChunkHeader ), 0 );
+        m_chunk_frame_amt = 0;
+
+        const auto add_frame = [ & ]( const Frame &frame ) {
+            if( !m_chunk_frame_amt )
+                header.m_first_time = frame.m_time;
+
+            encode( frame );
+        };
+
+        m_ring->drain( add_frame );
+
+        // report dropped frames once in a while, not per frame
+        const auto dropped = m_ring->get_dropped();
+        if( dropped != m_dropped_logged ) {
+            g_log->warn( L"Input recording: {} frame(s) dropped, writer fell behind", dropped - m_dropped_logged );
+
+            m_dropped_logged = dropped;
+        }
+
+        if( !m_chunk_frame_amt )
+            return true;
+
+        header.m_size        = (uint32_t)( m_chunk.size() - sizeof( ChunkHeader ) );
+        header.m_frame_amt   = m_chunk_frame_amt;
+        header.m_first_frame = m_frame_amt;
+
+        std::memcpy( m_chunk.data(), &header, sizeof( header ) );
+
+        if( !WriteFile( m_file, m_chunk.data(), (DWORD)m_chunk.size(), &written, nullptr ) || written != m_chunk.size() )
+            return false;
+
+        m_frame_amt += m_chunk_frame_amt;
+
+        return true;
+    }
+
+    NOINLINE bool Recorder::start( const std_fs::path &file, int8_t game_id, bool raw ) {
+        LARGE_INTEGER frequency, now;
+        DWORD         written = 0;
+
+        if( m_thread )
+            return false;
+
+        QueryPerformanceFrequency( &frequency );
+        QueryPerformanceCounter( &now );
+
+        m_file.reset( CreateFileW( file.c_str(), GENERIC_WRITE, FILE_SHARE_READ, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr ) );
+        if( !m_file )
+            return false;
+
+        FileHeader header{};
+
+        header.m_magic      = FILE_MAGIC;
+        header.m_version    = FILE_VERSION;
+        header.m_flags      = raw ? (uint32_t)FLAG_RAW : 0;
+        header.m_game_id    = game_id;
+        header.m_frequency  = (uint64_t)frequency.QuadPart;
+        header.m_start_time = (uint64_t)now.QuadPart;
+
+        if( !WriteFile( m_file, &header, sizeof( header ), &written, nullptr ) || written != sizeof( header ) )
+            return false;
+
+        m_stop_event.reset( CreateEventW( nullptr, TRUE, FALSE, nullptr ) );
+        if( !m_stop_event )
+            return false;
+
+        // chunks are a few hundred bytes at 60 fps, more with raw state
+        m_chunk.reserve( 4096 );
+
+        m_raw  = raw;
+        m_ring = std::make_unique< ring_t >();
+
+        m_recording.store( true, std::memory_order_release );
+
+        m_thread.reset( CreateThread( nullptr, 0, thread_func, this, 0, nullptr ) );
+        if( !m_thread )
+            m_recording.store( false, std::memory_order_release );
+
+        return m_thread.get() != nullptr;
+    }
+
+    NOINLINE void Recorder::stop() {
+        if( !m_thread )
+            return;
+
+        // the ring stays around, the input hook might be in record() right now
+        m_recording.store( false, std::memory_order_release );
+
+        SetEvent( m_stop_event );
+        WaitForSingleObject( m_thread, INFINITE );
+
+        m_thread.reset();
+        m_file.reset();
+
+        g_log->info( L"Input recording: {} frame(s) written", m_frame_amt );
+    }
+
+    NOINLINE Player::Player( const std_fs::path &file ) :
+        m_file{ file },
+        m_valid{ false },
+        m_raw{ false },
+        m_frequency{ 0 },
+        m_frame_amt{ 0 },
+        m_chunks{},
+        m_chunk_index{ 0 },
+        m_pos{ nullptr },
+        m_end{ nullptr },
+        m_chunk_frames_left{ 0 },
+        m_prefetched{ 0 },
+        m_frame{ 0 },
+        m_prev{},
+        m_prev_delta{ 0 } {
+
+        m_valid = init();
+
+        if( m_valid )
+            start_chunk( 0 );
+    }
+
+    NOINLINE bool Player::init() {
+        FileHeader header;
+
+        const auto size = m_file.get_size();
+        if( !m_file.is_mapped() || size < sizeof( header ) )
+            return false;
+
+        std::memcpy( &header, m_file.get_data(), sizeof( header ) );
+
+        if( header.m_magic != FILE_MAGIC || header.m_version != FILE_VERSION )
+            return false;
+
+        m_raw       = ( header.m_flags & FLAG_RAW ) != 0;
+        m_frequency = header.m_frequency;
+
+        // hop from chunk header to chunk header, frames aren't touched
+        for( auto offset = sizeof( header ); offset < size; ) {
+            // cut off at the end, the game was probably killed while writing
+            if( size - offset < sizeof( ChunkHeader ) )
+                break;
+
+            const auto chunk = get_chunk_header( offset );
+            if( chunk.m_size > size - offset - sizeof( ChunkHeader ) )
+                break;
+
+            // chunks must follow each other
+            if( chunk.m_first_frame != m_frame_amt )
+                return false;
+
+            m_chunks.push_back( ChunkInfo{ offset, chunk.m_first_frame } );
+
+            m_frame_amt += chunk.m_frame_amt;
+            offset      += sizeof( ChunkHeader ) + chunk.m_size;
+        }
+
+        return true;
+    }
+
+    NOINLINE bool Player::start_chunk( size_t index ) {
+        m_chunk_index       = index;
+        m_chunk_frames_left = 0;
+
+        if( index >= m_chunks.size() )
+            return false;
+
+        const auto offset = m_chunks[ index ].m_offset;
+        const auto chunk  = get_chunk_header( offset );
+
+        m_pos               = m_file.get_data() + offset + sizeof( ChunkHeader );
+        m_end               = m_pos + chunk.m_size;
+        m_chunk_frames_left = chunk.m_frame_amt;
+
+        // every chunk starts from nothing pressed
+        m_frame       = chunk.m_first_frame;
+        m_prev        = {};
+        m_prev.m_time = chunk.m_first_time;
+        m_prev_delta  = 0;
+
+        prefetch();
+
+        return true;
+    }
+
+    NOINLINE void Player::prefetch() {
+        const auto data   = m_file.get_data();
+        const auto offset = (size_t)( m_pos - data );
+
+        // seeked past what was read ahead, start from here
+        if( m_prefetched < offset )
+            m_prefetched = offset & ~( PREFETCH_STEP - 1 );
+
+        const auto limit = std::min( offset + PREFETCH_SIZE, m_file.get_size() );
+
+        // one read per page is enough to page it in, volatile so the reads are kept
+        for( ; m_prefetched < limit; m_prefetched += PREFETCH_STEP )
+            (void)*(volatile const uint8_t *)( data + m_prefetched );
+    }
+
+    NOINLINE bool Player::next( Frame &out ) {
+        uint64_t head, key_state;
+
+        // done with this chunk, skip to the next one with frames in it
+        while( !m_chunk_frames_left ) {
+            if( !start_chunk( m_chunk_index + 1 ) )
+                return false;
+        }
+
+        // bad data from here on, end the recording
+        const auto bad_data = [ & ]() {
+            start_chunk( m_chunks.size() );
+
+            return false;
+        };
+
+        if( !T::get_varint( m_pos, m_end, head ) )
+            return bad_data();
+
+        const auto delta = m_prev_delta + (uint64_t)T::unzigzag( head >> 1 );
+
+        m_prev.m_time += delta;
+        m_prev_delta  = delta;
+
+        if( head & 1 ) {
+            if( !T::get_varint( m_pos, m_end, key_state ) )
+                return bad_data();
+
+            m_prev.m_key_state ^= (uint32_t)key_state;
+
+            for( size_t pos = 0; m_raw && pos < RAW_SIZE; ) {
+                uint64_t same, diff;
+
+                if( !T::get_varint( m_pos, m_end, same ) || !T::get_varint( m_pos, m_end, diff ) )
+                    return bad_data();
+
+                // runs must stay inside the state and move forward
+                if( same > RAW_SIZE - pos || diff > RAW_SIZE - pos - same || diff > (uint64_t)( m_end - m_pos ) || !( same | diff ) )
+                    return bad_data();
+
+                pos += (size_t)same;
+
+                std::memcpy( m_prev.m_raw.data() + pos, m_pos, (size_t)diff );
+
+                pos   += (size_t)diff;
+                m_pos += diff;
+            }
+        }
+
+        --m_chunk_frames_left;
+        ++m_frame;
+
+        out = m_prev;
+
+        return true;
+    }
+
+    NOINLINE bool Player::seek( uint64_t frame ) {
+        Frame skipped;
+
+        if( frame >= m_frame_amt )
+            return false;
+
+        // last chunk starting at or before the frame
+        const auto after = []( uint64_t f, const ChunkInfo &chunk ) {
+            return f < chunk.m_first_frame;
+        };
+
+        const auto it = std::upper_bound( m_chunks.begin(), m_chunks.end(), frame, after );
+
+        start_chunk( (size_t)( it - m_chunks.begin() ) - 1 );
+
+        while( m_frame < frame ) {
+            if( !next( skipped ) )
+                return false;
+        }
+
+        return true;
+    }
+
+} // namespace InputRecord
\ No newline at end of file
@@ -0,0 +1,302 @@
+#pragma once
+
+#include "includes.h"
+
+//
+// input recording / replay
+// the input hook pushes one frame per call into a ring, a background thread compresses them to a file
+// the hook never waits on the writer or on I/O, frames are dropped if the writer falls behind
+//
+// replays decode a memory mapped recording one frame at a time, the cost per frame doesn't depend on its length
+//
+// file layout:
+//     FileHeader
+//     chunks, each a ChunkHeader followed by m_size bytes of frames
+//
+// frames are delta coded against the previous frame in their chunk, every chunk starts from nothing pressed
+// so a chunk can be decoded (or skipped) without looking at the ones before it
+//
+// frame encoding, every number is an unsigned LEB128 varint:
+//     head       zigzag( time delta - previous time delta ) << 1 | state changed
+//     key state  previous key state xor new key state, only if the state changed
+//     raw state  only if the state changed and the file has FLAG_RAW
+//                ( unchanged byte amt, changed byte amt, changed bytes ) runs until all RAW_SIZE bytes are covered
+//
+
+namespace InputRecord {
+
+    //
+    // file format
+    //
+
+    // "UMIR"
+    constexpr uint32_t FILE_MAGIC   = 0x52494D55;
+    constexpr uint32_t FILE_VERSION = 1;
+
+    // raw dinput keyboard state size
+    constexpr size_t RAW_SIZE = 256;
+
+    enum FileFlags : uint32_t {
+        FLAG_RAW = 1 << 0 // raw keyboard state is recorded
+    };
+
+    class FileHeader {
+    public:
+        uint32_t m_magic;
+        uint32_t m_version;
+        uint32_t m_flags;
+        int32_t  m_game_id;
+        uint64_t m_frequency;  // timestamp ticks per second
+        uint64_t m_start_time; // timestamp when recording started
+    };
+
+    class ChunkHeader {
+    public:
+        uint32_t m_size;        // encoded frame bytes after this header
+        uint32_t m_frame_amt;
+        uint64_t m_first_frame; // index of the first frame in the recording
+        uint64_t m_first_time;  // timestamp of the first frame
+    };
+
+    // one input hook call
+    class Frame {
+    public:
+        uint64_t                        m_time;      // QueryPerformanceCounter ticks
+        uint32_t                        m_key_state; // game key state the game ended up with
+        std::array< uint8_t, RAW_SIZE > m_raw;       // raw keyboard state, all zero if it wasn't captured
+    };
+
+    namespace T {
+
+        FORCEINLINE uint64_t zigzag( int64_t value ) {
+            return ( (uint64_t)value << 1 ) ^ (uint64_t)( value >> 63 );
+        }
+
+        FORCEINLINE int64_t unzigzag( uint64_t value ) {
+            return (int64_t)( value >> 1 ) ^ -(int64_t)( value & 1 );
+        }
+
+        FORCEINLINE void put_varint( std::vector< uint8_t > &out, uint64_t value ) {
+            while( value >= 0x80 ) {
+                out.push_back( (uint8_t)( value | 0x80 ) );
+
+                value >>= 7;
+            }
+
+            out.push_back( (uint8_t)value );
+        }
+
+        // read a varint, false if it runs past end or is too long
+        FORCEINLINE bool get_varint( const uint8_t *&pos, const uint8_t *end, uint64_t &out ) {
+            out = 0;
+
+            for( uint32_t shift = 0; pos < end && shift < 64; shift += 7 ) {
+                const auto byte = *pos++;
+
+                out |= (uint64_t)( byte & 0x7F ) << shift;
+
+                if( !( byte & 0x80 ) )
+                    return true;
+            }
+
+            return false;
+        }
+
+    } // namespace T
+
+    //
+    // writes a recording on a background thread
+    //
+
+    class Recorder {
+    private:
+        // frames buffered between writes, ~17 seconds at 60 fps
+        static constexpr size_t RING_SIZE = 1024;
+
+        // how often the writer drains the ring
+        // a normal exit writes everything (the loader stops the recorder from an ExitProcess hook)
+        // this is about how much is lost if the game is killed or crashes
+        static constexpr ulong_t FLUSH_TIME = 500;
+
+        using ring_t = SpscRing< Frame, RING_SIZE >;
+
+        // checked by the input hook, set while the writer is running
+        std::atomic< bool > m_recording;
+
+        // record raw keyboard state?
+        bool m_raw;
+
+        // frames from the input hook, only allocated once recording starts
+        std::unique_ptr< ring_t > m_ring;
+
+        // writer side
+        SHandleI               m_file;
+        std::vector< uint8_t > m_chunk;           // chunk header + encoded frames
+        Frame                  m_prev;            // previous frame in the chunk
+        uint64_t               m_prev_delta;      // previous time delta in the chunk
+        uint32_t               m_chunk_frame_amt;
+        uint64_t               m_frame_amt;       // frames written
+        size_t                 m_dropped_logged;  // dropped frames already logged
+
+        // stop signal / writer thread
+        SHandle m_stop_event;
+        SHandle m_thread;
+
+        // thread entry
+        static NOINLINE ulong_t __stdcall thread_func( void *arg );
+
+        // write until stopped
+        NOINLINE void run();
+
+        // add a frame to the current chunk
+        NOINLINE void encode( const Frame &frame );
+
+        // drain the ring and write a chunk, false on write error
+        NOINLINE bool flush();
+
+    public:
+        NOINLINE Recorder();
+
+        Recorder( const Recorder & )             = delete;
+        Recorder &operator =( const Recorder & ) = delete;
+
+        // create the recording file and start the writer
+        NOINLINE bool start( const std_fs::path &file, int8_t game_id, bool raw );
+
+        // stop recording, everything recorded so far is written
+        // note: don't call this from DllMain
+        NOINLINE void stop();
+
+        // record a frame, call this from the input hook only
+        // raw is the keyboard state, null if it wasn't captured
+        FORCEINLINE void record( uint32_t key_state, const uint8_t *raw ) {
+            LARGE_INTEGER now;
+
+            if( !m_recording.load( std::memory_order_acquire ) )
+                return;
+
+            // writer is behind, drop the frame
+            const auto frame = m_ring->reserve();
+            if( !frame )
+                return;
+
+            QueryPerformanceCounter( &now );
+
+            frame->m_time      = (uint64_t)now.QuadPart;
+            frame->m_key_state = key_state;
+
+            if( m_raw ) {
+                if( raw )
+                    std::memcpy( frame->m_raw.data(), raw, RAW_SIZE );
+
+                else
+                    frame->m_raw.fill( 0 );
+            }
+
+            m_ring->commit();
+        }
+
+        // is the writer running?
+        FORCEINLINE bool is_recording() const {
+            return m_recording.load( std::memory_order_acquire );
+        }
+    };
+
+    //
+    // reads a recording one frame at a time
+    //
+
+    class Player {
+    private:
+        // bytes to read ahead of the decoder, so upcoming chunks are paged in before they're needed
+        static constexpr size_t PREFETCH_SIZE = 0x4000;
+        static constexpr size_t PREFETCH_STEP = 0x1000;
+
+        MappedFile m_file;
+
+        // header info, only valid if the recording is
+        bool     m_valid;
+        bool     m_raw;
+        uint64_t m_frequency;
+        uint64_t m_frame_amt;
+
+        class ChunkInfo {
+        public:
+            size_t   m_offset; // chunk header offset in the file
+            uint64_t m_first_frame;
+        };
+
+        // every chunk, found when the file is opened
+        std::vector< ChunkInfo > m_chunks;
+
+        // current chunk
+        size_t         m_chunk_index;
+        const uint8_t  *m_pos;
+        const uint8_t  *m_end;
+        uint32_t       m_chunk_frames_left;
+        size_t         m_prefetched; // file offset read ahead up to
+
+        // next frame index / previous frame
+        uint64_t m_frame;
+        Frame    m_prev;
+        uint64_t m_prev_delta;
+
+        // read a chunk header, they aren't aligned in the file
+        FORCEINLINE ChunkHeader get_chunk_header( size_t offset ) const {
+            ChunkHeader out;
+
+            std::memcpy( &out, m_file.get_data() + offset, sizeof( out ) );
+
+            return out;
+        }
+
+        // check headers and find all chunks
+        NOINLINE bool init();
+
+        // start decoding a chunk, false if there are no more
+        NOINLINE bool start_chunk( size_t index );
+
+        // touch pages ahead of the decoder
+        NOINLINE void prefetch();
+
+    public:
+        // open and map a recording
+        NOINLINE Player( const std_fs::path &file );
+
+        Player( const Player & )             = delete;
+        Player &operator =( const Player & ) = delete;
+
+        // decode the next frame, false at the end of the recording or on bad data
+        NOINLINE bool next( Frame &out );
+
+        // jump to a frame, the next call to next() returns it
+        // only the frames before it in its chunk are decoded
+        NOINLINE bool seek( uint64_t frame );
+
+        // valid recording?
+        FORCEINLINE bool is_valid() const {
+            return m_valid;
+        }
+
+        // raw keyboard state in frames?
+        FORCEINLINE bool has_raw() const {
+            return m_raw;
+        }
+
+        // timestamp ticks per second
+        FORCEINLINE uint64_t get_frequency() const {
+            return m_frequency;
+        }
+
+        // index of the frame next() returns
+        FORCEINLINE uint64_t get_frame() const {
+            return m_frame;
+        }
+
+        // amount of frames in the recording
+        FORCEINLINE uint64_t get_frame_amt() const {
+            return m_frame_amt;
+        }
+    };
+
+} // namespace InputRecord
\ No newline at end of file
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "includes.h"
+
+//
+// game key state from a dinput keyboard state, this runs every frame in the input hook
+// single key binds are a per-key table (Config::key_table_t) and chords are rules (Config::KeyRule), both built when the config is bound
+//
+
+namespace KeyState {
+
+    // one bit per dinput key, bit n is word n / 32 bit n % 32
+    // note: x86 is little-endian, so this has the same layout as Config::key_mask_t
+    using pressed_mask_t = std::array< uint32_t, 8 >;
+
+    // game key state of the single key binds, also returns which keys are pressed
+    // 64 keys are checked at a time and blocks without a pressed key are skipped, usually all but one or two
+    // the cost doesn't depend on the amount of single key binds
+    // note: key_states is the 256 byte dinput keyboard state, the high bit is set for pressed keys
+    FORCEINLINE uint32_t get_table_state( const Config::key_table_t &table, const uint8_t *key_states, pressed_mask_t &out_pressed ) {
+        uint32_t out = 0;
+
+        for( size_t i = 0; i < table.size(); i += 64 ) {
+            const auto a = _mm_loadu_si128( (const __m128i *)( key_states + i ) );
+            const auto b = _mm_loadu_si128( (const __m128i *)( key_states + i + 16 ) );
+            const auto c = _mm_loadu_si128( (const __m128i *)( key_states + i + 32 ) );
+            const auto d = _mm_loadu_si128( (const __m128i *)( key_states + i + 48 ) );
+
+            // nothing pressed in this block?
+            if( !_mm_movemask_epi8( _mm_or_si128( _mm_or_si128( a, b ), _mm_or_si128( c, d ) ) ) ) {
+                out_pressed[ i / 32 ]     = 0;
+                out_pressed[ i / 32 + 1 ] = 0;
+
+                continue;
+            }
+
+            out_pressed[ i / 32 ]     = (uint32_t)_mm_movemask_epi8( a ) | ( (uint32_t)_mm_movemask_epi8( b ) << 16 );
+            out_pressed[ i / 32 + 1 ] = (uint32_t)_mm_movemask_epi8( c ) | ( (uint32_t)_mm_movemask_epi8( d ) << 16 );
+
+            for( size_t j = 0; j < 2; ++j ) {
+                auto pressed = out_pressed[ i / 32 + j ];
+
+                while( pressed ) {
+                    unsigned long idx;
+
+                    _BitScanForward( &idx, pressed );
+
+                    out |= table[ i + j * 32 + idx ];
+
+                    pressed &= pressed - 1;
+                }
+            }
+        }
+
+        return out;
+    }
+
+    // game key state of the chords, every rule with all of its keys pressed adds its state
+    // overlapping chords all fire, "0x1D+0x2C" and "0x1D+0x2A+0x2C" are both pressed while the second one is held
+    FORCEINLINE uint32_t get_rule_state( const Config::KeyRule *rules, size_t rule_amt, const pressed_mask_t &pressed ) {
+        uint32_t out = 0;
+
+        const auto pressed_all = _mm256_loadu_si256( (const __m256i *)pressed.data() );
+
+        for( size_t i = 0; i < rule_amt; ++i ) {
+            // testc is set if no mask bits are missing from pressed
+            if( _mm256_testc_si256( pressed_all, _mm256_loadu_si256( (const __m256i *)rules[ i ].m_mask.data() ) ) )
+                out |= rules[ i ].m_state;
+        }
+
+        return out;
+    }
+
+    // game key state for a keyboard state
+    // single keys cost a table lookup and chords an AND / compare each
+    FORCEINLINE uint32_t get( const Config::Settings &settings, const uint8_t *key_states ) {
+        pressed_mask_t pressed;
+
+        const auto out = get_table_state( settings.m_key_table, key_states, pressed );
+
+        return out | get_rule_state( settings.m_key_rules.data(), settings.m_key_rule_amt, pressed );
+    }
+
+} // namespace KeyState
\ No newline at end of file
@@ -0,0 +1,158 @@
+#include "latency_stats.h"
+
+namespace Latency {
+
+    //
+    // histogram
+    //
+
+    NOINLINE void Histogram::get_counts( counts_t &out ) const {
+        for( size_t i = 0; i < BUCKET_AMT; ++i )
+            out[ i ] = m_counts[ i ].load( std::memory_order_relaxed );
+    }
+
+    NOINLINE uint64_t Histogram::get_bucket_min( size_t bucket ) {
+        if( bucket < SUB_AMT )
+            return bucket;
+
+        const auto shift = bucket / SUB_AMT - 1;
+
+        return (uint64_t)( bucket % SUB_AMT + SUB_AMT ) << shift;
+    }
+
+    NOINLINE uint64_t Histogram::get_bucket_max( size_t bucket ) {
+        // the last bucket also holds everything that was clamped
+        if( bucket + 1 >= BUCKET_AMT )
+            return 0xFFFFFFFF;
+
+        return get_bucket_min( bucket + 1 ) - 1;
+    }
+
+    //
+    // summary
+    //
+
+    NOINLINE Summary Summary::from_counts( const Histogram::counts_t &counts ) {
+        Summary out{};
+
+        for( const auto c : counts )
+            out.m_amt += c;
+
+        if( !out.m_amt )
+            return out;
+
+        // smallest value with at least this many samples at or below it
+        const std::array< uint64_t, 3 > ranks = {
+            ( out.m_amt * 500 + 999 ) / 1000,
+            ( out.m_amt * 990 + 999 ) / 1000,
+            ( out.m_amt * 999 + 999 ) / 1000
+        };
+
+        std::array< uint64_t *, 3 > values = { &out.m_p50, &out.m_p99, &out.m_p999 };
+
+        uint64_t seen = 0;
+        size_t   rank = 0;
+
+        for( size_t i = 0; i < counts.size(); ++i ) {
+            if( !counts[ i ] )
+                continue;
+
+            if( !seen )
+                out.m_min = Histogram::get_bucket_min( i );
+
+            seen += counts[ i ];
+
+            for( ; rank < ranks.size() && seen >= ranks[ rank ]; ++rank )
+                *values[ rank ] = Histogram::get_bucket_max( i );
+
+            out.m_max = Histogram::get_bucket_max( i );
+        }
+
+        return out;
+    }
+
+    //
+    // stats
+    //
+
+    NOINLINE Stats::Stats() : m_histograms{}, m_last_enter{ 0 }, m_logged{}, m_stop_event{ nullptr }, m_thread{ nullptr } {
+
+    }
+
+    NOINLINE ulong_t __stdcall Stats::thread_func( void *arg ) {
+        const auto stats = (Stats *)arg;
+
+        stats->run();
+
+        return 0;
+    }
+
+    NOINLINE void Stats::run() {
+        while( WaitForSingleObject( m_stop_event, LOG_TIME ) == WAIT_TIMEOUT )
+            log_summary();
+
+        log_summary();
+    }
+
+    NOINLINE void Stats::log_summary() {
+        constexpr std::array< std::wstring_view, SERIES_MAX > SERIES_NAMES = {
+            L"frame",
+            L"game handler",
+            L"keyboard read",
+            L"loader"
+        };
+
+        LARGE_INTEGER       frequency;
+        Histogram::counts_t counts;
+
+        QueryPerformanceFrequency( &frequency );
+
+        // ticks to microseconds
+        const auto to_us = [ & ]( uint64_t ticks ) {
+            return (double)ticks * 1000000.0 / (double)frequency.QuadPart;
+        };
+
+        for( size_t i = 0; i < SERIES_MAX; ++i ) {
+            m_histograms[ i ].get_counts( counts );
+
+            // only this interval, counts wrap around the same way on both sides
+            auto interval = counts;
+
+            for( size_t j = 0; j < counts.size(); ++j )
+                interval[ j ] -= m_logged[ i ][ j ];
+
+            m_logged[ i ] = counts;
+
+            const auto summary = Summary::from_counts( interval );
+            if( !summary.m_amt )
+                continue;
+
+            g_log->info( L"Input latency ({}): {} samples, min {:.1f}us, p50 {:.1f}us, p99 {:.1f}us, p99.9 {:.1f}us, max {:.1f}us",
+                SERIES_NAMES[ i ], summary.m_amt, to_us( summary.m_min ), to_us( summary.m_p50 ), to_us( summary.m_p99 ), to_us( summary.m_p999 ), to_us( summary.m_max ) );
+        }
+    }
+
+    NOINLINE bool Stats::start() {
+        if( m_thread )
+            return false;
+
+        m_stop_event.reset( CreateEventW( nullptr, TRUE, FALSE, nullptr ) );
+        if( !m_stop_event )
+            return false;
+
+        m_thread.reset( CreateThread( nullptr, 0, thread_func, this, 0, nullptr ) );
+
+        return m_thread.get() != nullptr;
+    }
+
+    NOINLINE void Stats::stop() {
+        if( !m_thread )
+            return;
+
+        SetEvent( m_stop_event );
+        WaitForSingleObject( m_thread, INFINITE );
+
+        m_thread.reset();
+    }
+
+} // namespace Latency
\ No newline at end of file
@@ -0,0 +1,168 @@
+#pragma once
+
+#include "includes.h"
+
+//
+// input hook timing, compiled out unless INPUT_LATENCY_STATS is defined
+//
+// LATENCY_MARK( name ) takes a timestamp into a local
+// LATENCY_ADD( stats, ... ) adds a frame's timestamps to a Latency::Stats
+//
+
+#ifdef INPUT_LATENCY_STATS
+    #define LATENCY_MARK( name )      const auto name = Latency::now()
+    #define LATENCY_ADD( stats, ... ) ( stats ).add( __VA_ARGS__ )
+#else
+    #define LATENCY_MARK( name )
+    #define LATENCY_ADD( stats, ... )
+#endif
+
+namespace Latency {
+
+    // high resolution monotonic timestamp, QueryPerformanceCounter ticks
+    FORCEINLINE uint64_t now() {
+        LARGE_INTEGER out;
+
+        QueryPerformanceCounter( &out );
+
+        return (uint64_t)out.QuadPart;
+    }
+
+    //
+    // log-linear histogram (HDR style)
+    // every power of 2 is split into SUB_AMT linear buckets, so values are kept to within ~6%
+    // one writer thread, any amount of readers, nothing locks
+    //
+
+    class Histogram {
+    public:
+        static constexpr uint32_t SUB_BITS   = 4;
+        static constexpr uint32_t SUB_AMT    = 1 << SUB_BITS;
+        static constexpr size_t   BUCKET_AMT = ( 32 - SUB_BITS + 1 ) * SUB_AMT;
+
+        using counts_t = std::array< uint32_t, BUCKET_AMT >;
+
+    private:
+        std::array< std::atomic< uint32_t >, BUCKET_AMT > m_counts;
+
+        // values under SUB_AMT get a bucket each, the rest by highest bit and the SUB_BITS bits below it
+        static FORCEINLINE size_t get_bucket( uint32_t value ) {
+            unsigned long high_bit;
+
+            if( value < SUB_AMT )
+                return value;
+
+            _BitScanReverse( &high_bit, value );
+
+            const auto shift = high_bit - SUB_BITS;
+
+            return ( shift + 1 ) * SUB_AMT + ( value >> shift ) - SUB_AMT;
+        }
+
+    public:
+        Histogram() : m_counts{} {
+
+        }
+
+        Histogram( const Histogram & )             = delete;
+        Histogram &operator =( const Histogram & ) = delete;
+
+        // writer side, values over 32 bits go in the last bucket
+        FORCEINLINE void add( uint64_t value ) {
+            auto &count = m_counts[ get_bucket( (uint32_t)std::min< uint64_t >( value, 0xFFFFFFFF ) ) ];
+
+            // only one writer, no need for a locked add
+            count.store( count.load( std::memory_order_relaxed ) + 1, std::memory_order_relaxed );
+        }
+
+        // copy out the counts, counts only ever go up
+        NOINLINE void get_counts( counts_t &out ) const;
+
+        // lowest / highest value that goes in a bucket
+        static NOINLINE uint64_t get_bucket_min( size_t bucket );
+        static NOINLINE uint64_t get_bucket_max( size_t bucket );
+    };
+
+    //
+    // summary of a histogram
+    //
+
+    class Summary {
+    public:
+        uint64_t m_amt;
+        uint64_t m_min;
+        uint64_t m_p50;
+        uint64_t m_p99;
+        uint64_t m_p999;
+        uint64_t m_max;
+
+        // summarize bucket counts, percentiles are the highest value of their bucket
+        static NOINLINE Summary from_counts( const Histogram::counts_t &counts );
+    };
+
+    //
+    // per-frame input hook timings, summaries are logged from a background thread
+    //
+
+    class Stats {
+    public:
+        enum Series : uint8_t {
+            SERIES_FRAME = 0, // hook entry to hook entry, the game's poll rate
+            SERIES_ORIG,      // the game's own input handler
+            SERIES_CAPTURE,   // reading the keyboard
+            SERIES_LOADER,    // everything the loader does after the game's handler
+            SERIES_MAX
+        };
+
+    private:
+        // how often summaries are logged
+        static constexpr ulong_t LOG_TIME = 60000;
+
+        std::array< Histogram, SERIES_MAX > m_histograms;
+
+        // input hook side
+        uint64_t m_last_enter;
+
+        // logger side, counts at the last summary so each one only covers its own interval
+        std::array< Histogram::counts_t, SERIES_MAX > m_logged;
+
+        // stop signal / logger thread
+        SHandle m_stop_event;
+        SHandle m_thread;
+
+        // thread entry
+        static NOINLINE ulong_t __stdcall thread_func( void *arg );
+
+        // log until stopped
+        NOINLINE void run();
+
+        // log a summary of everything since the last one
+        NOINLINE void log_summary();
+
+    public:
+        NOINLINE Stats();
+
+        Stats( const Stats & )             = delete;
+        Stats &operator =( const Stats & ) = delete;
+
+        // start logging summaries
+        NOINLINE bool start();
+
+        // stop logging and wait for the thread to exit, the last interval is logged
+        // note: don't call this from DllMain
+        NOINLINE void stop();
+
+        // add one hook call, call this from the input hook only
+        FORCEINLINE void add( uint64_t enter, uint64_t orig_done, uint64_t capture_done, uint64_t leave ) {
+            if( m_last_enter )
+                m_histograms[ SERIES_FRAME ].add( enter - m_last_enter );
+
+            m_histograms[ SERIES_ORIG    ].add( orig_done - enter );
+            m_histograms[ SERIES_CAPTURE ].add( capture_done - orig_done );
+            m_histograms[ SERIES_LOADER  ].add( leave - orig_done );
+
+            m_last_enter = enter;
+        }
+    };
+
+} // namespace Latency
\ No newline at end of file
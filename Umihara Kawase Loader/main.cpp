@@ -1,4 +1,8 @@
 #include "includes.h"
+#include "ini_reader.h"
+#include "ini_writer.h"
+#include "input_record.h"
+#include "key_state.h"
 
 /*
     Umihara Kawase Loader by melanite ( https://github.com/melanite/Umihara-Kawase-Loader )
@@ -18,41 +22,21 @@
 */
 
 //
-// misc defs / vars
+// misc defs
 //
 
-// info about each user keybind
-class UserKeyData {
-public:
-    uint32_t m_dinput_key;    // user keybind (dinput)
-    uint32_t m_umi_key_state; // key used by game
+// input replay state
+enum ReplayState : uint8_t {
+    REPLAY_WAITING = 0, // waiting for the start key
+    REPLAY_RUNNING,
+    REPLAY_DONE         // end of the recording, the game has its input back
 };
 
-// user keybinds
-// default m_dinput_key value is changed in INI
-static std::vector< UserKeyData > g_user_keybinds = {
-    // movement and move UI selection keys
-    { DIK_UP,     UMI_KEY_UP    },
-    { DIK_DOWN,   UMI_KEY_DOWN  },
-    { DIK_LEFT,   UMI_KEY_LEFT  },
-    { DIK_RIGHT,  UMI_KEY_RIGHT },
-
-    // menu related
-    { DIK_SPACE,  UMI_KEY_START   },
-    { DIK_RETURN, UMI_KEY_PAUSE   },
-    { DIK_TAB,    UMI_KEY_SELECT  }, // NOTE: this key is only valid on the first game (UmiharaKawase)
-    { DIK_S,      UMI_KEY_RESTART },
-    { DIK_ESCAPE, UMI_KEY_BACK    },
-
-    // gameplay
-    { DIK_Z,     UMI_KEY_JUMP },
-    { DIK_A,     UMI_KEY_HOOK },
-    { DIK_PRIOR, UMI_KEY_L    },
-    { DIK_NEXT,  UMI_KEY_R    },
-
-    // misc
-    { DIK_X, UMI_KEY_SKIP }
-};
+// no seek requested
+constexpr uint64_t REPLAY_NO_SEEK = std::numeric_limits< uint64_t >::max();
+
+// kernel32 ExitProcess
+using exit_process_t = void (__stdcall *)( uint32_t exit_code );
 
 //
 // global vars
@@ -66,7 +50,12 @@ static std_fs::path g_path_root_dir;
 static std_fs::path g_path_loader_dir;
 static std_fs::path g_path_loader_dll_dir;
 static std_fs::path g_path_loader_ini;
+static std_fs::path g_path_loader_ini_cache;
 static std_fs::path g_path_loader_log;
+static std_fs::path g_path_loader_sig_builds_dir;
+static std_fs::path g_path_loader_sig_report;
+static std_fs::path g_path_loader_input_rec;
+static std_fs::path g_path_loader_input_replay;
 
 // game related funcs / vars
 static uintptr_t    g_input_hander_func_addr = 0;
@@ -76,17 +65,66 @@ static uint32_t     *g_key_list              = nullptr;
 
 // hooks
 static Detour< input_handler_t > g_input_handler_hook;
+static Detour< exit_process_t >  g_exit_process_hook;
 
 //
 // ini settings
 //
 
 static auto g_ini_use_keybinds = false;
+static auto g_ini_sig_report   = false;
+static auto g_ini_hot_reload   = false;
+static auto g_ini_record_input = false;
+static auto g_ini_record_raw   = false;
+
+static auto     g_ini_replay_input       = false;
+static uint32_t g_ini_replay_start_key   = 0;
+static uint32_t g_ini_replay_start_frame = 0;
+
+// current settings, read by the input hook
+// swapped out when the INI is reloaded
+static Snapshot< Config::Settings > g_settings;
+
+// INI hot-reload
+static Config::Watcher g_ini_watcher;
+
+// input recording, written by the input hook
+static InputRecord::Recorder g_input_recorder;
+
+// input replay, read by the input hook
+// note: set up before plugins are loaded and never replaced
+static std::unique_ptr< InputRecord::Player > g_input_player;
+static auto                                   g_replay_state = REPLAY_WAITING;
+
+// seek / fast-forward requests from plugins, picked up on the next frame
+static std::atomic< uint64_t > g_replay_seek{ REPLAY_NO_SEEK };
+static std::atomic< uint32_t > g_replay_skip{ 0 };
+
+#ifdef INPUT_LATENCY_STATS
+// input hook timings, written by the input hook
+static Latency::Stats g_latency_stats;
+#endif
 
 //
 // misc funcs
 //
 
+// the game is exiting, stop background threads while they still exist
+// ExitProcess kills every other thread before DLL_PROCESS_DETACH, so this can't wait until DllMain
+static NOINLINE void __stdcall exit_process_hook( uint32_t exit_code ) {
+    static const auto orig = g_exit_process_hook.get_orig_func();
+
+    // writes the frames recorded since the last flush
+    g_input_recorder.stop();
+
+#ifdef INPUT_LATENCY_STATS
+    // logs the last interval
+    g_latency_stats.stop();
+#endif
+
+    orig( exit_code );
+}
+
 static NOINLINE void init_failed( std::wstring_view error ) {
     const auto title_msg = fmt::format( L"[Umihara Kawase Loader] Error: {}", error );
 
@@ -136,95 +174,179 @@ static NOINLINE void init_paths() {
         return;
     }
 
+    // get binary INI cache path
+    g_path_loader_ini_cache = g_path_loader_dir / L"config.bin";
+
     // get output log path
     g_path_loader_log = g_path_loader_dir / L"log.txt";
+
+    // get signature report paths
+    g_path_loader_sig_builds_dir = g_path_loader_dir / L"sig_builds";
+    g_path_loader_sig_report     = g_path_loader_dir / L"sig_report.json";
+
+    // get input recording paths
+    g_path_loader_input_rec    = g_path_loader_dir / L"input.rec";
+    g_path_loader_input_replay = g_path_loader_dir / L"replay.rec";
+}
+
+// parse INI and fill settings, null on parse error
+static NOINLINE std::unique_ptr< Config::Settings > load_settings( const std_fs::path &file ) {
+    auto settings = std::make_unique< Config::Settings >();
+
+    const auto parse_start = std::chrono::steady_clock::now();
+
+    // stream values straight into settings, the document is never built
+    auto reader = INIReader( file.wstring() );
+    if( !reader.is_open() )
+        return {};
+
+    const auto bind_result = Config::bind( reader, g_game_id, *settings );
+    if( reader.has_error() )
+        return {};
+
+    const auto parse_us = std::chrono::duration_cast< std::chrono::microseconds >( std::chrono::steady_clock::now() - parse_start ).count();
+
+    if( bind_result.m_unknown || bind_result.m_duplicate || bind_result.m_invalid )
+        g_log->warn( L"INI: {} unknown, {} duplicate, {} invalid value(s)", bind_result.m_unknown, bind_result.m_duplicate, bind_result.m_invalid );
+
+    g_log->info( L"INI parse done in {}us: \"{}\"", parse_us, file.wstring() );
+
+    return settings;
+}
+
+// called from the watcher thread
+static NOINLINE void reload_ini( const std_fs::path &file ) {
+    auto settings = load_settings( file );
+    if( !settings ) {
+        g_log->error( L"INI reload: parse error, keeping current settings" );
+
+        return;
+    }
+
+    if( !Config::store_cache( file, g_path_loader_ini_cache, g_game_id, *settings ) )
+        g_log->warn( L"Failed to write INI cache" );
+
+    g_settings.publish( std::move( settings ) );
+
+    g_log->info( L"INI reloaded" );
+}
+
+//
+// export funcs for plugins
+//
+
+// serializes INI writes from plugins
+static std::mutex g_ini_write_mutex;
+
+extern "C" {
+
+    // set a value in the loader INI, comments / formatting are kept
+    // settings are picked up by hot-reload if it's enabled
+    // note: fails for text that would add lines or sections, see INIWriter::set_value
+    BOOL __stdcall umi_set_config_value( const wchar_t *section, const wchar_t *name, const wchar_t *value ) {
+        if( !section || !name || !value || g_path_loader_ini.empty() )
+            return FALSE;
+
+        std::lock_guard< std::mutex > lock( g_ini_write_mutex );
+
+        auto writer = INIWriter();
+
+        if( !writer.init( g_path_loader_ini ) || !writer.set_value( section, name, value ) || !writer.save( g_path_loader_ini ) ) {
+            g_log->error( L"Failed to write INI value: [{}] {}", section, name );
+
+            return FALSE;
+        }
+
+        g_log->info( L"INI value written: [{}] {} = {}", section, name, value );
+
+        return TRUE;
+    }
+
+    // jump to a frame in the input replay
+    BOOL __stdcall umi_replay_seek( uint32_t frame ) {
+        if( !g_input_player || frame >= g_input_player->get_frame_amt() )
+            return FALSE;
+
+        g_replay_seek.store( frame );
+
+        return TRUE;
+    }
+
+    // fast-forward the input replay, skipped frames are never fed to the game
+    BOOL __stdcall umi_replay_skip( uint32_t frames ) {
+        if( !g_input_player )
+            return FALSE;
+
+        g_replay_skip.fetch_add( frames );
+
+        return TRUE;
+    }
+
 }
 
 static NOINLINE bool init_ini() {
-    INIParser ini;
+    auto settings = std::make_unique< Config::Settings >();
 
-    // get keybind from file, keep track of index
-    static auto get_ini_keybind = [ & ]( std::wstring_view section_name, std::wstring_view value_name, uint32_t default_value ) {
-        static size_t cur_idx = 0;
+    // try cache first, it's only used if the INI didn't change
+    const auto cache_start = std::chrono::steady_clock::now();
 
-        // get entry @ index, go to next
-        const auto entry = &g_user_keybinds[ cur_idx++ ];
+    if( Config::load_cache( g_path_loader_ini, g_path_loader_ini_cache, g_game_id, *settings ) ) {
+        const auto cache_us = std::chrono::duration_cast< std::chrono::microseconds >( std::chrono::steady_clock::now() - cache_start ).count();
 
-        // set dinput key in vector
-        entry->m_dinput_key = ini.get_value_uint32( section_name, value_name, default_value );
-    };
+        g_log->info( L"INI loaded from cache in {}us: \"{}\"", cache_us, g_path_loader_ini_cache.wstring() );
+    }
 
-    ini = INIParser( g_path_loader_ini.wstring() );
-    if( !ini.is_valid() ) {
-        init_failed( L"INI parse error" );
+    else {
+        settings = load_settings( g_path_loader_ini );
+        if( !settings ) {
+            init_failed( L"INI parse error" );
 
-        return false;
+            return false;
+        }
+
+        if( !Config::store_cache( g_path_loader_ini, g_path_loader_ini_cache, g_game_id, *settings ) )
+            g_log->warn( L"Failed to write INI cache" );
     }
 
     // get misc INI stuff
-    g_ini_use_keybinds = ini.get_value_bool( L"settings", L"rebind_keys", false );
-
-    // get keybinds from INI
-    if( g_ini_use_keybinds ) {
-        // this sucks, but it must be done in order...
-
-        // movement and move UI selection keybinds
-        get_ini_keybind( L"settings", L"KEY_UP",    DIK_UP    );
-        get_ini_keybind( L"settings", L"KEY_DOWN",  DIK_DOWN  );
-        get_ini_keybind( L"settings", L"KEY_LEFT",  DIK_LEFT  );
-        get_ini_keybind( L"settings", L"KEY_RIGHT", DIK_RIGHT );
-
-        // menu related keybinds
-        get_ini_keybind( L"settings", L"KEY_START",   DIK_SPACE  );
-        get_ini_keybind( L"settings", L"KEY_PAUSE",   DIK_RETURN );
-        get_ini_keybind( L"settings", L"KEY_SELECT",  DIK_TAB    );
-        get_ini_keybind( L"settings", L"KEY_RESTART", DIK_S      );
-        get_ini_keybind( L"settings", L"KEY_BACK",    DIK_ESCAPE );
-
-        // gameplay keybinds
-        get_ini_keybind( L"settings", L"KEY_JUMP", DIK_Z     );
-        get_ini_keybind( L"settings", L"KEY_HOOK", DIK_A     );
-        get_ini_keybind( L"settings", L"KEY_L",    DIK_PRIOR );
-        get_ini_keybind( L"settings", L"KEY_R",    DIK_NEXT  );
-
-        // misc keybinds
-        get_ini_keybind( L"settings", L"KEY_SKIP", DIK_X );
+    g_ini_use_keybinds = settings->m_rebind_keys;
+    g_ini_sig_report   = settings->m_signature_report;
+    g_ini_hot_reload   = settings->m_hot_reload;
+    g_ini_record_input = settings->m_record_input;
+    g_ini_record_raw   = settings->m_record_raw_input;
 
+    g_ini_replay_input       = settings->m_replay_input;
+    g_ini_replay_start_key   = settings->m_replay_start_key;
+    g_ini_replay_start_frame = settings->m_replay_start_frame;
+
+    if( g_ini_use_keybinds )
         g_log->info( L"Extracted keybinds from INI" );
-    }
 
-    g_log->info( L"INI parse done: \"{}\"", g_path_loader_ini.wstring() );
+    g_settings.publish( std::move( settings ) );
 
     return true;
 }
 
-static NOINLINE bool check_valid_dll( std::wstring_view filename ) {
+static NOINLINE bool check_valid_dll( const std_fs::path &filename ) {
     IMAGE_DOS_HEADER *dos;
     IMAGE_NT_HEADERS *nt;
 
-    // open up file at end
-    auto file = std::ifstream( filename, ( std::ios::ate | std::ios::binary ) );
-    if( !file )
+    // map file, only the headers are read
+    const auto file = MappedFile( filename );
+    if( !file.is_mapped() )
         return false;
 
-    // get filesize
-    const auto file_size = file.tellg();
-    if( file_size == -1 )
+    // make sure the headers are in the file before touching them
+    if( file.get_size() < sizeof( IMAGE_DOS_HEADER ) )
         return false;
 
-    // go back to start, since we opened at the end
-    file.seekg( 0 );
-
-    // allocate buffer for file
-    auto file_buffer = std::vector< char >( (size_t)file_size );
-
-    // read file contents to buffer
-    if( !file.read( file_buffer.data(), file_size ) )
+    const auto file_dos = (const IMAGE_DOS_HEADER *)file.get_data();
+    if( file_dos->e_lfanew < 0 || (size_t)file_dos->e_lfanew + sizeof( IMAGE_NT_HEADERS ) > file.get_size() )
         return false;
 
     // get file headers
     // make sure this is a DLL
-    if( !Utils::get_pe_file_headers( (uintptr_t)( file_buffer.data() ), dos, nt ) )
+    if( !Utils::get_pe_file_headers( (uintptr_t)( file.get_data() ), dos, nt ) )
         return false;
 
     if( !( nt->FileHeader.Characteristics & IMAGE_FILE_DLL ) )
@@ -252,8 +374,8 @@ static NOINLINE bool load_dlls() {
         if( f.is_directory() )
             continue;
 
-        // convert to path object
-        const auto cur_file = f.path();
+        // get path, no copies
+        const auto &cur_file = f.path();
         if( cur_file.empty() ) {
             g_log->warn( L"Invalid DLL filepath (2)" );
 
@@ -261,24 +383,24 @@ static NOINLINE bool load_dlls() {
         }
 
         // get path string
-        const auto filename = cur_file.wstring();
+        const auto filename = std::wstring_view( cur_file.native() );
 
         // skip bad extensions
-        if( cur_file.extension() != L".dll" ) {
+        if( filename.size() < 4 || filename.substr( filename.size() - 4 ) != L".dll" ) {
             g_log->warn( L"Invalid DLL extension: \"{}\"", filename );
 
             continue;
         }
 
         // skip bad PE files
-        if( !check_valid_dll( filename ) ) {
+        if( !check_valid_dll( cur_file ) ) {
             g_log->warn( L"Invalid DLL file: \"{}\"", filename );
 
             continue;
         }
 
         // try to load it
-        if( !LoadLibraryW( filename.c_str() ) ) {
+        if( !LoadLibraryW( cur_file.c_str() ) ) {
             g_log->warn( L"Failed to map DLL: \"{}\"", filename );
 
             continue;
@@ -295,6 +417,28 @@ static NOINLINE bool load_dlls() {
     return true;
 }
 
+static NOINLINE void run_sig_report() {
+    g_log->info( L"Running signature report on \"{}\"", g_path_loader_sig_builds_dir.wstring() );
+
+    const auto failed_amt = SigReport::run( g_path_loader_sig_builds_dir, g_path_loader_sig_report );
+    if( failed_amt < 0 ) {
+        g_log->warn( L"Signature report failed, does \"{}\" exist?", g_path_loader_sig_builds_dir.wstring() );
+
+        return;
+    }
+
+    g_log->info( L"Signature report done, {} failed: \"{}\"", failed_amt, g_path_loader_sig_report.wstring() );
+}
+
+static NOINLINE void log_approx_match( std::wstring_view name, const PatternScan::ApproxResult &approx ) {
+    // exact match (or none at all)
+    if( !approx.m_addr )
+        return;
+
+    g_log->warn( L"Signature \"{}\" is outdated, using closest match: 0x{:X} ({} mismatched bytes, confidence {:.2f})",
+        name, approx.m_addr, approx.m_distance, approx.m_confidence );
+}
+
 static NOINLINE std::optional< uint32_t > umi_key_to_dinput_key( uint32_t key ) {
     // array in .rdata size, etc
     constexpr auto KEY_LIST_SIZE_BYTES = uint32_t{ 0x90 };
@@ -312,41 +456,69 @@ static NOINLINE std::optional< uint32_t > umi_key_to_dinput_key( uint32_t key )
     return {};
 }
 
-static NOINLINE void modify_input_data( InputData *data ) {
-    uint8_t m_key_states[ 256 ];
-
-    // check for dinput keypress flag
-    static auto is_key_pressed = [ & ]( uint8_t sc ) -> bool {
-        return ( m_key_states[ sc ] & 0x80 );
-    };
-
+// returns true if key_states was filled
+static NOINLINE bool capture_key_states( InputData *data, std::array< uint8_t, 256 > &key_states ) {
     // make sure data is valid first
     if( !data || !data->m_dinput_device )
-        return;
+        return false;
 
     // only do this if we're in focus
     if( data->m_focus_flag != UMI_FOCUSED )
-        return;
+        return false;
 
     // capture keyboard state
-    const auto dihr = data->m_dinput_device->GetDeviceState( sizeof( m_key_states ), &m_key_states );
-    if( dihr != DI_OK )
+    const auto dihr = data->m_dinput_device->GetDeviceState( (DWORD)key_states.size(), key_states.data() );
+    return dihr == DI_OK;
+}
+
+static NOINLINE void modify_input_data( InputData *data, const std::array< uint8_t, 256 > &key_states ) {
+    // current settings
+    // rebinding might've been turned off by a reload, leave the game's input alone then
+    const auto settings = Snapshot< Config::Settings >::Reader( g_settings );
+    if( !settings || !settings->m_rebind_keys )
         return;
 
-    // swallow all keys
-    data->m_key_state = 0;
+    // swallow all keys, then add the keybinds that are pressed
+    data->m_key_state = KeyState::get( *settings.get(), key_states.data() );
+}
+
+// feed the next recorded frame to the game instead of the device
+static NOINLINE void replay_input_data( InputData *data, const uint8_t *key_states ) {
+    InputRecord::Frame frame;
+
+    // start on the exact frame the start key is first seen
+    if( g_replay_state == REPLAY_WAITING ) {
+        if( g_ini_replay_start_key && !( key_states && ( key_states[ g_ini_replay_start_key & 0xFF ] & 0x80 ) ) )
+            return;
 
-    // check for key(s) being pressed
-    for( const auto &b : g_user_keybinds ) {
-        // // this key is only valid on the first game
-        // // skip on other games
-        // if( b.m_umi_key_state == UMI_KEY_SELECT && g_game_ver_id != UMI_GAME_KAWASE )
-        //     continue;
+        if( g_ini_replay_start_frame )
+            g_input_player->seek( g_ini_replay_start_frame );
 
-        // key is pressed, add to keybind flag
-        if( is_key_pressed( b.m_dinput_key ) )
-            data->m_key_state |= b.m_umi_key_state;
+        g_replay_state = REPLAY_RUNNING;
     }
+
+    if( g_replay_state != REPLAY_RUNNING )
+        return;
+
+    // seek / fast-forward requests
+    const auto seek = g_replay_seek.exchange( REPLAY_NO_SEEK );
+    if( seek != REPLAY_NO_SEEK )
+        g_input_player->seek( seek );
+
+    // skipping past the end stops on the last frame
+    const auto skip = g_replay_skip.exchange( 0 );
+    if( skip )
+        g_input_player->seek( std::min( g_input_player->get_frame() + skip, g_input_player->get_frame_amt() - 1 ) );
+
+    if( !g_input_player->next( frame ) ) {
+        g_replay_state = REPLAY_DONE;
+
+        g_log->info( L"Input replay done after {} frame(s)", g_input_player->get_frame() );
+
+        return;
+    }
+
+    data->m_key_state = frame.m_key_state;
 }
 
 //
@@ -357,12 +529,35 @@ static NOINLINE int __fastcall input_handler_hook( InputData *data, uintptr_t ed
     // store original function
     static const auto orig = g_input_handler_hook.get_orig_func();
 
+    alignas( 16 ) std::array< uint8_t, 256 > key_states;
+
+    LATENCY_MARK( enter );
+
     // let original run first
     // the game will fill out the input data structure
     const auto ret = orig( data );
 
+    LATENCY_MARK( orig_done );
+
+    const auto has_key_states = capture_key_states( data, key_states );
+
+    LATENCY_MARK( capture_done );
+
     // send inputs as needed
-    modify_input_data( data );
+    if( has_key_states )
+        modify_input_data( data, key_states );
+
+    if( data ) {
+        // replaying? the device is ignored
+        if( g_input_player )
+            replay_input_data( data, has_key_states ? key_states.data() : nullptr );
+
+        // record what the game ends up with
+        g_input_recorder.record( data->m_key_state, has_key_states ? key_states.data() : nullptr );
+    }
+
+    LATENCY_MARK( leave );
+    LATENCY_ADD( g_latency_stats, enter, orig_done, capture_done, leave );
 
     return ret;
 }
@@ -372,23 +567,33 @@ static NOINLINE int __fastcall input_handler_hook( InputData *data, uintptr_t ed
 //
 
 static NOINLINE ulong_t __stdcall init_thread( void *arg ) {
+    // short-lived init allocations (patterns, etc) come from here, all freed at once when init is done
+    Arena        init_arena;
+    Arena::Scope init_arena_scope( init_arena );
+
     // 100ms
     constexpr ulong_t INIT_WAIT_TIME = 100;
 
     // 10 seconds
     constexpr ulong_t MAX_INIT_WAIT_TIME = INIT_WAIT_TIME * 100;
 
-    ulong_t   total_wait_time = 0;
-    uintptr_t found_name_str  = 0;
+    ulong_t                   total_wait_time = 0;
+    uintptr_t                 found_name_str  = 0;
+    PatternScan::ApproxResult name_approx{};
 
     // this is pretty silly but my guess is the steam DRM unpacking routine takes a bit to finish (???)
     // find reference to game path wstring
     do {
-        found_name_str = PatternScan::find( "", "0F B7 8A ? ? ? ? 66 85 C9 75 EA 33 C9 66 89 0C 46 EB 77" );
+        found_name_str = Signatures::find( UMI_GAME_INVALID, Signatures::SIG_GAME_NAME );
 
         // keep track of total sleep time
         total_wait_time += INIT_WAIT_TIME;
         if( total_wait_time > MAX_INIT_WAIT_TIME ) {
+            // last chance, maybe a game update changed a few bytes
+            found_name_str = Signatures::find( UMI_GAME_INVALID, Signatures::SIG_GAME_NAME, &name_approx );
+            if( found_name_str )
+                break;
+
             init_failed( L"Invalid game or outdated signatures" );
 
             return 0;
@@ -399,9 +604,6 @@ static NOINLINE ulong_t __stdcall init_thread( void *arg ) {
     }
     while( !found_name_str );
 
-    // get name location in .rdata
-    found_name_str = *(uintptr_t *)( found_name_str + 3 );
-
     // initialize string from location in .rdata
     g_game_name = std::wstring( (wchar_t *)found_name_str );
     if( g_game_name.empty() )
@@ -413,29 +615,7 @@ static NOINLINE ulong_t __stdcall init_thread( void *arg ) {
 
     // check game name hash
     // set game version ID
-    switch( FNV1aHash::get_32( g_game_name ) ) {
-        case CT_HASH_32( L"UmiharaKawase" ): {
-            g_game_id = UMI_GAME_KAWASE;
-
-            break;
-        }
-
-        case CT_HASH_32( L"UmiharaKawase Shun SE" ): {
-            g_game_id = UMI_GAME_KAWASE_SHUN;
-
-            break;
-        }
-
-        case CT_HASH_32( L"Sayonara Umihara Kawase" ): {
-            g_game_id = UMI_GAME_SAYONARA_KAWASE;
-
-            break;
-        }
-
-        default: {
-            break;
-        }
-    }
+    g_game_id = Signatures::game_id_from_name( g_game_name );
 
     //
     // initialize
@@ -465,6 +645,8 @@ static NOINLINE ulong_t __stdcall init_thread( void *arg ) {
     // print game version info
     g_log->info( L"Game: \"{}\" (ID: {})", g_game_name, g_game_id );
 
+    log_approx_match( L"game name", name_approx );
+
     // set up ini
     if( !init_ini() ) {
         g_log->error( L"Failed to set up ini" );
@@ -472,6 +654,24 @@ static NOINLINE ulong_t __stdcall init_thread( void *arg ) {
         return 0;
     }
 
+    // check signatures against other game builds
+    if( g_ini_sig_report )
+        run_sig_report();
+
+    // open input replay, before plugins are loaded so they can control it
+    if( g_ini_replay_input ) {
+        auto player = std::make_unique< InputRecord::Player >( g_path_loader_input_replay );
+
+        if( !player->is_valid() || !player->get_frame_amt() )
+            g_log->error( L"Invalid or empty input replay \"{}\", replay is disabled", g_path_loader_input_replay.wstring() );
+
+        else {
+            g_log->info( L"Replaying {} frame(s) from \"{}\"", player->get_frame_amt(), g_path_loader_input_replay.wstring() );
+
+            g_input_player = std::move( player );
+        }
+    }
+
     // load other DLLs
     if( !load_dlls() ) {
         g_log->error( L"Failed to load extra DLLs" );
@@ -483,48 +683,15 @@ static NOINLINE ulong_t __stdcall init_thread( void *arg ) {
     // sigscan, etc
     //
 
-    uintptr_t key_list_tmp;
-
-    // find sigs on each game
-    switch( g_game_id ) {
-        case UMI_GAME_KAWASE: {
-            // follow relative jmp
-            g_input_hander_func_addr = Utils::follow_rel_instruction( PatternScan::find( "", "E8 ? ? ? ? B8 ? ? ? ? 8B FF" ) );
-
-            key_list_tmp = PatternScan::find( "", "B8 ? ? ? ? 8D 9B ? ? ? ?" );
-
-            break;
-        }
-
-        case UMI_GAME_KAWASE_SHUN: {
-            // follow relative jmp
-            g_input_hander_func_addr = Utils::follow_rel_instruction( PatternScan::find( "", "E8 ? ? ? ? FF 35 ? ? ? ? 8B 35 ? ? ? ?" ) );
-
-            key_list_tmp = PatternScan::find( "", "B8 ? ? ? ? EB 08" );
-
-            break;
-        }
-
-        case UMI_GAME_SAYONARA_KAWASE: {
-            g_input_hander_func_addr = Utils::follow_rel_instruction( PatternScan::find( "", "E8 ? ? ? ? FF 35 ? ? ? ? 8B 35 ? ? ? ?" ) );
-
-            key_list_tmp = PatternScan::find( "", "89 86 ? ? ? ? B8 ? ? ? ? EB 08" );
-            if( !key_list_tmp )
-                break;
-
-            // skip over (mov [reg+disp32], reg)
-            // (modrm = 2, 0, 6)
-            key_list_tmp += 7;
-
-            break;
-        }
+    // find sigs for this game
+    // offset chains are applied by the signature list
+    // the input handler is hooked, so it must match exactly
+    PatternScan::ApproxResult key_list_approx;
 
-        default: {
-            g_log->error( L"Failed to identify game version (2)" );
+    g_input_hander_func_addr = Signatures::find( g_game_id, Signatures::SIG_INPUT_HANDLER );
+    g_key_list               = Signatures::find< uint32_t * >( g_game_id, Signatures::SIG_KEY_LIST, &key_list_approx );
 
-            return 0;
-        }
-    }
+    log_approx_match( L"key list", key_list_approx );
 
     // valid sigs?
     if( !g_input_hander_func_addr ) {
@@ -533,17 +700,12 @@ static NOINLINE ulong_t __stdcall init_thread( void *arg ) {
         return 0;
     }
 
-    if( !key_list_tmp ) {
+    if( !g_key_list ) {
         g_log->error( L"Failed to find key list array" );
 
         return 0;
     }
 
-    // get key list now
-    // actual key list starts 4 bytes back
-    g_key_list  = *(uint32_t **)key_list_tmp;
-    g_key_list -= 1;
-
     // log...
     g_log->info( L"Input handler func: 0x{:X}", g_input_hander_func_addr );
     g_log->info( L"Key list array: 0x{:X}", (uintptr_t)g_key_list );
@@ -552,8 +714,20 @@ static NOINLINE ulong_t __stdcall init_thread( void *arg ) {
     // set up hooks
     //
 
+    // start recording before the hook, so the first frame isn't missed
+    if( g_ini_record_input ) {
+        if( !g_input_recorder.start( g_path_loader_input_rec, g_game_id, g_ini_record_raw ) )
+            g_log->error( L"Failed to start input recording" );
+
+        else
+            g_log->info( L"Recording input to \"{}\"", g_path_loader_input_rec.wstring() );
+    }
+
     // check if user wants to rebind keys
-    if( g_ini_use_keybinds ) {
+    // with hot-reload on, rebinding can be turned on later so the hook is always needed
+    const auto hook_input = g_ini_use_keybinds || g_ini_hot_reload || g_input_recorder.is_recording() || g_input_player;
+
+    if( hook_input ) {
         // hook input handler
         if( !g_input_handler_hook.init( g_input_hander_func_addr, &input_handler_hook ) ) {
             g_log->error( L"Failed to initialize input handler hook" );
@@ -569,6 +743,38 @@ static NOINLINE ulong_t __stdcall init_thread( void *arg ) {
         }
     }
 
+    auto stop_on_exit = g_input_recorder.is_recording();
+
+#ifdef INPUT_LATENCY_STATS
+    // only the input hook adds timings, without it there's nothing to log
+    if( hook_input ) {
+        if( !g_latency_stats.start() )
+            g_log->error( L"Failed to start input latency stats" );
+
+        else
+            stop_on_exit = true;
+    }
+#endif
+
+    // flush the recording / log the last latency stats when the game exits
+    if( stop_on_exit ) {
+        const auto exit_process = (uintptr_t)GetProcAddress( GetModuleHandleA( "kernel32.dll" ), "ExitProcess" );
+
+        if( !g_exit_process_hook.init( exit_process, &exit_process_hook ) || !g_exit_process_hook.enable() )
+            g_log->warn( L"Failed to hook ExitProcess, the last recorded frames and latency stats are lost on exit" );
+    }
+
+    // watch INI for changes
+    if( g_ini_hot_reload ) {
+        if( !g_ini_watcher.start( g_path_loader_ini, reload_ini ) )
+            g_log->error( L"Failed to start INI watcher, hot-reload is disabled" );
+
+        else
+            g_log->info( L"Watching INI for changes" );
+    }
+
+    g_log->info( L"Init arena: {} allocations ({} KB) in {} heap blocks ({} KB)", init_arena.get_alloc_count(), init_arena.get_alloc_size() / 1024, init_arena.get_block_count(), init_arena.get_block_size() / 1024 );
+
     g_log->info( L"Initialized!" );
 
     return 1;
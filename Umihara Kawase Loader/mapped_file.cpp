@@ -0,0 +1,21 @@
+#include "mapped_file.h"
+
+NOINLINE size_t MappedFile::get_file_size( HANDLE file ) {
+    LARGE_INTEGER size;
+
+    if( !file || !GetFileSizeEx( file, &size ) )
+        return 0;
+
+    return (size_t)size.QuadPart;
+}
+
+NOINLINE MappedFile::MappedFile( const std_fs::path &filename ) :
+    m_file{ CreateFileW( filename.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr ) },
+    m_size{ get_file_size( m_file ) },
+    m_mapping{ ( m_size ) ? CreateFileMappingW( m_file, nullptr, PAGE_READONLY, 0, 0, nullptr ) : nullptr },
+    m_view{ ( m_mapping ) ? MapViewOfFile( m_mapping, FILE_MAP_READ, 0, 0, 0 ) : nullptr } {
+
+    // mapping failed, nothing to read
+    if( !m_view )
+        m_size = 0;
+}
\ No newline at end of file
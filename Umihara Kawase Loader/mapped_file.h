@@ -0,0 +1,48 @@
+#pragma once
+
+#include "includes.h"
+
+//
+// read-only memory mapped file
+//
+
+class MappedFile {
+private:
+    // file / mapping / view handles
+    // note: declaration order matters, the view must be unmapped before the mapping and file are closed
+    SHandleI    m_file;
+    size_t      m_size;
+    SHandle     m_mapping;
+    SHandleFile m_view;
+
+    // get file size, 0 on error
+    static NOINLINE size_t get_file_size( HANDLE file );
+
+public:
+    // open and map file
+    NOINLINE MappedFile( const std_fs::path &filename );
+
+    // no copies, handles would be closed twice
+    MappedFile( const MappedFile & )             = delete;
+    MappedFile &operator =( const MappedFile & ) = delete;
+
+    // returns mapped data
+    FORCEINLINE const uint8_t *get_data() const {
+        return m_view.get< const uint8_t * >();
+    }
+
+    // returns file size
+    FORCEINLINE size_t get_size() const {
+        return m_size;
+    }
+
+    // file opened? (empty files are opened but not mapped)
+    FORCEINLINE bool is_open() const {
+        return m_file.get() != nullptr;
+    }
+
+    // file opened and mapped?
+    FORCEINLINE bool is_mapped() const {
+        return get_data() != nullptr;
+    }
+};
\ No newline at end of file
@@ -0,0 +1,255 @@
+#include "module_cache.h"
+
+namespace ModuleCache {
+
+    //
+    // loader notification types (ntdll)
+    //
+
+    namespace T {
+
+        // LDR_DLL_NOTIFICATION_REASON_UNLOADED
+        constexpr ulong_t LDR_REASON_UNLOADED = 2;
+
+        // loaded / unloaded notification data have the same layout
+        class LdrDllNotificationData {
+        public:
+            ulong_t    m_flags;
+            const void *m_full_dll_name; // UNICODE_STRING *
+            const void *m_base_dll_name; // UNICODE_STRING *
+            void       *m_dll_base;
+            ulong_t    m_size_of_image;
+        };
+
+        using ldr_dll_notification_t         = void (__stdcall *)( ulong_t reason, const LdrDllNotificationData *data, void *ctx );
+        using LdrRegisterDllNotification_t   = long (__stdcall *)( ulong_t flags, ldr_dll_notification_t func, void *ctx, void **cookie );
+        using LdrUnregisterDllNotification_t = long (__stdcall *)( void *cookie );
+
+    } // namespace T
+
+    //
+    // module registry
+    //
+
+    class Registry {
+    private:
+        // a cached module and the name used to look it up
+        class Entry {
+        public:
+            hash32_t     m_name_hash;
+            std::string  m_name;
+            module_ptr_t m_info;
+        };
+
+        // note: never hold this while calling into the windows loader, the unload callback runs under the loader lock
+        std::mutex           m_mutex;
+        std::vector< Entry > m_entries;
+
+        // unload notification cookie
+        void *m_cookie;
+
+        // called by ntdll when a module is unloaded
+        static void __stdcall on_dll_notification( ulong_t reason, const T::LdrDllNotificationData *data, void *ctx ) {
+            if( reason != T::LDR_REASON_UNLOADED || !data || !ctx )
+                return;
+
+            ( (Registry *)ctx )->invalidate( (uintptr_t)data->m_dll_base );
+        }
+
+        // register for unload notifications
+        NOINLINE void register_notification() {
+            const auto ntdll = GetModuleHandleA( "ntdll.dll" );
+            if( !ntdll )
+                return;
+
+            const auto register_func = (T::LdrRegisterDllNotification_t)( GetProcAddress( ntdll, "LdrRegisterDllNotification" ) );
+            if( !register_func )
+                return;
+
+            if( register_func( 0, &on_dll_notification, this, &m_cookie ) != 0 )
+                m_cookie = nullptr;
+        }
+
+        // stop unload notifications, ntdll would call into a freed registry otherwise
+        NOINLINE void unregister_notification() {
+            if( !m_cookie )
+                return;
+
+            const auto ntdll = GetModuleHandleA( "ntdll.dll" );
+            if( !ntdll )
+                return;
+
+            const auto unregister_func = (T::LdrUnregisterDllNotification_t)( GetProcAddress( ntdll, "LdrUnregisterDllNotification" ) );
+            if( unregister_func )
+                unregister_func( m_cookie );
+
+            m_cookie = nullptr;
+        }
+
+        // parse PE headers of a loaded module
+        static NOINLINE module_ptr_t parse( uintptr_t base ) {
+            IMAGE_DOS_HEADER *dos;
+            IMAGE_NT_HEADERS *nt;
+
+            if( !Utils::get_pe_file_headers( base, dos, nt ) )
+                return {};
+
+            auto info = std::make_shared< ModuleInfo >();
+
+            info->m_base       = base;
+            info->m_image_size = nt->OptionalHeader.SizeOfImage;
+            info->m_code       = SectionRange( Utils::RVA_to_ptr( base, nt->OptionalHeader.BaseOfCode ), nt->OptionalHeader.SizeOfCode );
+
+            // get all executable sections
+            const auto sections = IMAGE_FIRST_SECTION( nt );
+
+            for( uint16_t i = 0; i < nt->FileHeader.NumberOfSections; ++i ) {
+                const auto &s = sections[ i ];
+                if( !( s.Characteristics & IMAGE_SCN_MEM_EXECUTE ) )
+                    continue;
+
+                info->m_exec_sections.emplace_back( Utils::RVA_to_ptr( base, s.VirtualAddress ), s.Misc.VirtualSize );
+            }
+
+            return info;
+        }
+
+    public:
+        NOINLINE Registry() : m_mutex{}, m_entries{}, m_cookie{ nullptr } {
+            register_notification();
+        }
+
+        // runs on DLL_PROCESS_DETACH, along with the other statics
+        NOINLINE ~Registry() {
+            unregister_notification();
+        }
+
+        Registry( const Registry & )             = delete;
+        Registry &operator =( const Registry & ) = delete;
+
+        NOINLINE module_ptr_t get( std::string_view module_name ) {
+            const auto name_hash = FNV1aHash::get_32( module_name );
+
+            // same name (not just the same hash)?
+            const auto is_name = [ & ]( const Entry &e ) {
+                return e.m_name_hash == name_hash && e.m_name == module_name;
+            };
+
+            // already cached?
+            {
+                std::lock_guard< std::mutex > lock( m_mutex );
+
+                for( const auto &e : m_entries ) {
+                    if( is_name( e ) )
+                        return e.m_info;
+                }
+            }
+
+            // get module base
+            // note: module_name might not be null terminated
+            const auto name = std::string( module_name );
+            const auto base = (uintptr_t)( GetModuleHandleA( ( !name.empty() ) ? name.c_str() : 0 ) );
+            if( !base )
+                return {};
+
+            std::lock_guard< std::mutex > lock( m_mutex );
+
+            // already cached under a different name (or by another thread)? share the entry
+            for( const auto &e : m_entries ) {
+                if( e.m_info->get_base() != base )
+                    continue;
+
+                const auto info = e.m_info;
+
+                if( std::none_of( m_entries.begin(), m_entries.end(), is_name ) )
+                    m_entries.push_back( Entry{ name_hash, name, info } );
+
+                return info;
+            }
+
+            // ... otherwise parse headers
+            const auto info = parse( base );
+            if( !info )
+                return {};
+
+            m_entries.push_back( Entry{ name_hash, name, info } );
+
+            return info;
+        }
+
+        NOINLINE void invalidate( uintptr_t base ) {
+            std::lock_guard< std::mutex > lock( m_mutex );
+
+            m_entries.erase( std::remove_if( m_entries.begin(), m_entries.end(),
+                [ & ]( const Entry &e ) {
+                    return e.m_info->get_base() == base;
+                }
+            ), m_entries.end() );
+        }
+    };
+
+    // the registry, made on first use
+    // note: not a plain static, its constructor calls into the windows loader and statics are made under the loader lock
+    static NOINLINE Registry &get_registry() {
+        static Registry registry;
+
+        return registry;
+    }
+
+    //
+    // ModuleInfo
+    //
+
+    // guards fingerprint / scanned ranges
+    static std::mutex g_info_mutex;
+
+    NOINLINE hash32_t ModuleInfo::get_code_fingerprint() const {
+        std::lock_guard< std::mutex > lock( g_info_mutex );
+
+        if( !m_code_fingerprint )
+            m_code_fingerprint = FNV1aHash::get_32( (uint8_t *)m_code.get_start(), m_code.get_size() );
+
+        return *m_code_fingerprint;
+    }
+
+    NOINLINE void ModuleInfo::record_scan( uintptr_t start, size_t size ) const {
+        std::lock_guard< std::mutex > lock( g_info_mutex );
+
+        auto end = start + size;
+
+        // the same ranges get scanned over and over while waiting for the game to unpack
+        // merge with every range this one overlaps or touches, so the list only grows for new ranges
+        const auto merge = [ & ]( const SectionRange &r ) {
+            if( r.get_start() > end || r.get_end() < start )
+                return false;
+
+            start = std::min( start, r.get_start() );
+            end   = std::max( end, r.get_end() );
+
+            return true;
+        };
+
+        m_scanned.erase( std::remove_if( m_scanned.begin(), m_scanned.end(), merge ), m_scanned.end() );
+
+        m_scanned.emplace_back( start, end - start );
+    }
+
+    NOINLINE ranges_t ModuleInfo::get_scanned_ranges() const {
+        std::lock_guard< std::mutex > lock( g_info_mutex );
+
+        return m_scanned;
+    }
+
+    //
+    // funcs
+    //
+
+    NOINLINE module_ptr_t get( std::string_view module_name ) {
+        return get_registry().get( module_name );
+    }
+
+    NOINLINE void invalidate( uintptr_t base ) {
+        get_registry().invalidate( base );
+    }
+
+} // namespace ModuleCache
\ No newline at end of file
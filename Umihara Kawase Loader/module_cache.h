@@ -0,0 +1,121 @@
+#pragma once
+
+#include "includes.h"
+
+namespace ModuleCache {
+
+    //
+    // a single address range inside of a module
+    //
+
+    class SectionRange {
+    private:
+        uintptr_t m_start;
+        size_t    m_size;
+
+    public:
+        SectionRange() = default;
+
+        FORCEINLINE SectionRange( uintptr_t start, size_t size ) : m_start{ start }, m_size{ size } {
+
+        }
+
+        // get start / size / end of range
+        FORCEINLINE uintptr_t get_start() const {
+            return m_start;
+        }
+
+        FORCEINLINE size_t get_size() const {
+            return m_size;
+        }
+
+        FORCEINLINE uintptr_t get_end() const {
+            return m_start + m_size;
+        }
+
+        // is an address inside of this range?
+        FORCEINLINE bool contains( uintptr_t addr ) const {
+            return addr >= m_start && addr < get_end();
+        }
+    };
+
+    // section range container
+    using ranges_t = std::vector< SectionRange >;
+
+    //
+    // cached info about a loaded module
+    // filled out once from the PE headers, removed when the module is unloaded
+    //
+
+    class ModuleInfo {
+    private:
+        // allow the registry to fill this out
+        friend class Registry;
+
+        // module base address
+        uintptr_t m_base;
+
+        // OptionalHeader.SizeOfImage
+        size_t m_image_size;
+
+        // OptionalHeader.BaseOfCode / OptionalHeader.SizeOfCode
+        SectionRange m_code;
+
+        // all executable sections
+        ranges_t m_exec_sections;
+
+        // FNV-1a hash of the code section, made on first use
+        // note: the games unpack their code at runtime, so don't ask for this before the first signature resolves
+        mutable std::optional< hash32_t > m_code_fingerprint;
+
+        // every range that was scanned in this module, overlapping ranges are merged
+        mutable ranges_t m_scanned;
+
+    public:
+        ModuleInfo() = default;
+
+        // module base address
+        FORCEINLINE uintptr_t get_base() const {
+            return m_base;
+        }
+
+        // size of the mapped image
+        FORCEINLINE size_t get_image_size() const {
+            return m_image_size;
+        }
+
+        // code section start / size
+        FORCEINLINE const SectionRange &get_code() const {
+            return m_code;
+        }
+
+        // all executable sections
+        FORCEINLINE const ranges_t &get_exec_sections() const {
+            return m_exec_sections;
+        }
+
+        // get (or make) the code section fingerprint
+        NOINLINE hash32_t get_code_fingerprint() const;
+
+        // keep track of a scanned range, merged with the ranges it overlaps
+        NOINLINE void record_scan( uintptr_t start, size_t size ) const;
+
+        // returns a copy of all scanned ranges
+        NOINLINE ranges_t get_scanned_ranges() const;
+    };
+
+    // shared module info ptr
+    using module_ptr_t = std::shared_ptr< const ModuleInfo >;
+
+    //
+    // funcs in source file
+    //
+
+    // get cached module info, the module is parsed on first lookup
+    // an empty module name is the main executable
+    extern NOINLINE module_ptr_t get( std::string_view module_name );
+
+    // drop a cached module by base address
+    extern NOINLINE void invalidate( uintptr_t base );
+
+} // namespace ModuleCache
\ No newline at end of file
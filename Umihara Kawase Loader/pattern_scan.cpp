@@ -1,4 +1,6 @@
 #include "pattern_scan.h"
+#include "compiled_pattern.h"
+#include "ext_pattern.h"
 
 namespace PatternScan {
 
@@ -6,6 +8,18 @@ namespace PatternScan {
         if( !start || !size || pattern_str.empty() )
             return 0;
 
+        // gaps / alternation need the extended pattern engine
+        if( Build::ExtPattern::is_extended( pattern_str ) )
+            return Build::ExtPattern( pattern_str ).find( start, size );
+
+#ifdef PATTERN_SCAN_USE_COMPILED
+        // use compiled pattern if possible
+        // wildcard-only patterns can't be compiled
+        const auto compiled = Build::get_compiled( pattern_str );
+        if( compiled )
+            return find_compiled( start, size, *compiled );
+#endif
+
         // convert pattern string to pattern object
         const auto pattern = Build::Pattern( pattern_str );
         if( !pattern )
@@ -25,4 +39,261 @@ namespace PatternScan {
         return ( it != scan_end ) ? (uintptr_t)it : 0;
     }
 
+    NOINLINE uintptr_t find_compiled( uintptr_t start, size_t size, const Build::CompiledPattern &pattern ) {
+        if( !start || !pattern || pattern.size() > size )
+            return 0;
+
+        // get scan start and end
+        const auto scan_start = (const uint8_t *)start;
+        const auto scan_end   = scan_start + size;
+
+        // last possible match
+        const auto scan_last = scan_end - pattern.size();
+
+        const auto anchor        = _mm_set1_epi8( (char)pattern.get_anchor_byte() );
+        const auto anchor_offset = pattern.get_anchor_offset();
+
+        auto cur = scan_start;
+
+        // check 16 candidates at a time with the anchor byte
+        // only while every 16-byte load stays inside the range
+        if( size >= pattern.read_size() + 15 ) {
+            const auto simd_last = scan_end - pattern.read_size() - 15;
+
+            for( ; cur <= simd_last; cur += 16 ) {
+                const auto bytes = _mm_loadu_si128( (const __m128i *)( cur + anchor_offset ) );
+
+                auto candidates = (uint32_t)( _mm_movemask_epi8( _mm_cmpeq_epi8( bytes, anchor ) ) );
+
+                while( candidates ) {
+                    ulong_t idx;
+                    _BitScanForward( &idx, candidates );
+
+                    if( pattern.match( cur + idx ) )
+                        return (uintptr_t)( cur + idx );
+
+                    // clear lowest set bit
+                    candidates &= candidates - 1;
+                }
+            }
+        }
+
+        // end of range, byte by byte
+        for( ; cur <= scan_last; ++cur ) {
+            if( pattern.match_slow( cur ) )
+                return (uintptr_t)cur;
+        }
+
+        return 0;
+    }
+
+    NOINLINE uintptr_t find_module( std::string_view module_name, size_t size, std::string_view pattern_str ) {
+        // get cached module info
+        // we only need the start of the code section
+        const auto module = ModuleCache::get( module_name );
+        if( !module )
+            return 0;
+
+        const auto scan_start = module->get_code().get_start();
+
+        module->record_scan( scan_start, size );
+
+        return find( scan_start, size, pattern_str );
+    }
+
+    NOINLINE uintptr_t find_module( std::string_view module_name, std::string_view pattern_str ) {
+        // get cached module info
+        // we need the code section start and size
+        const auto module = ModuleCache::get( module_name );
+        if( !module )
+            return 0;
+
+        const auto &code = module->get_code();
+
+        module->record_scan( code.get_start(), code.get_size() );
+
+        return find( code.get_start(), code.get_size(), pattern_str );
+    }
+
+    NOINLINE bool find_batch( uintptr_t start, size_t size, const std::vector< Build::Pattern > &patterns, batch_results_t &out ) {
+        // first non-wildcard byte of each pattern
+        class Anchor {
+        public:
+            size_t m_pattern_idx;
+            size_t m_offset;
+        };
+
+        out.assign( patterns.size(), BatchResult{ 0, 0 } );
+
+        if( !start || !size || patterns.empty() )
+            return false;
+
+        // bucket patterns by their anchor byte
+        // only patterns with a matching anchor byte are compared at each position
+        std::array< std::vector< Anchor >, 256 > buckets;
+
+        for( size_t i = 0; i < patterns.size(); ++i ) {
+            const auto &p = patterns[ i ];
+
+            const auto it = std::find_if( p.cbegin(), p.cend(),
+                []( const Build::PatternByte &b ) {
+                    return !b.is_wildcard();
+                }
+            );
+
+            // empty or wildcard-only pattern, never matches
+            if( it == p.cend() )
+                continue;
+
+            buckets[ it->get_byte() ].push_back( Anchor{ i, (size_t)( it - p.cbegin() ) } );
+        }
+
+        // get scan start and end
+        const auto scan_start = (const uint8_t *)start;
+        const auto scan_end   = scan_start + size;
+
+        for( auto cur = scan_start; cur < scan_end; ++cur ) {
+            for( const auto &a : buckets[ *cur ] ) {
+                const auto &p = patterns[ a.m_pattern_idx ];
+
+                // pattern would start before / end after the range
+                if( (size_t)( cur - scan_start ) < a.m_offset )
+                    continue;
+
+                const auto match = cur - a.m_offset;
+                if( (size_t)( scan_end - match ) < p.size() )
+                    continue;
+
+                if( !std::equal( p.cbegin(), p.cend(), match,
+                    []( const Build::PatternByte &b, const uint8_t &c ) {
+                        return b.compare( c );
+                    }
+                ) )
+                    continue;
+
+                auto &res = out[ a.m_pattern_idx ];
+
+                if( !res.m_count++ )
+                    res.m_first = (uintptr_t)match;
+            }
+        }
+
+        return true;
+    }
+
+    NOINLINE bool find_approx( uintptr_t start, size_t size, std::string_view pattern_str, uint32_t max_mismatches, ApproxResult &out ) {
+        out = ApproxResult{ 0, 0, 0, 0.f };
+
+        if( !start || !size || pattern_str.empty() )
+            return false;
+
+        // convert pattern string to pattern object
+        const auto pattern = Build::Pattern( pattern_str );
+        if( !pattern || pattern.size() > size )
+            return false;
+
+        // amount of bytes that can mismatch
+        const auto fixed_amt = (uint32_t)( std::count_if( pattern.cbegin(), pattern.cend(),
+            []( const Build::PatternByte &b ) {
+                return !b.is_wildcard();
+            }
+        ) );
+
+        // everything would match...
+        if( !fixed_amt || max_mismatches >= fixed_amt )
+            return false;
+
+        //
+        // shift-add, every pattern byte gets a mismatch counter packed into a 64-bit word
+        // the top bit of each counter is an overflow flag (more than max_mismatches)
+        //
+
+        uint32_t field_bits = 1;
+
+        while( ( 1ull << ( field_bits - 1 ) ) <= max_mismatches )
+            ++field_bits;
+
+        // only a prefix fits into the word, the rest of the pattern is verified at each candidate
+        const auto filter_len = std::min( pattern.size(), (size_t)( 64 / field_bits ) );
+        const auto last_shift = ( filter_len - 1 ) * field_bits;
+        const auto field_mask = ( 1ull << field_bits ) - 1;
+        const auto high_bit   = 1ull << ( field_bits - 1 );
+
+        // mismatch table, counter i is set if the byte doesn't match pattern byte i
+        std::array< uint64_t, 256 > table{};
+        uint64_t                    high_mask = 0;
+
+        for( size_t i = 0; i < filter_len; ++i ) {
+            const auto shift = i * field_bits;
+
+            high_mask |= high_bit << shift;
+
+            const auto &b = pattern[ i ];
+            if( b.is_wildcard() )
+                continue;
+
+            for( size_t c = 0; c < table.size(); ++c ) {
+                if( c != b.get_byte() )
+                    table[ c ] |= 1ull << shift;
+            }
+        }
+
+        const auto scan_start = (const uint8_t *)start;
+
+        uint64_t state     = 0;
+        uint64_t overflow  = 0;
+        uint32_t best_dist = max_mismatches + 1;
+
+        for( size_t i = 0; i < size; ++i ) {
+            // counter i - 1 becomes counter i, add mismatches for this byte
+            state    = ( state << field_bits ) + table[ scan_start[ i ] ];
+            overflow = ( overflow << field_bits ) | ( state & high_mask );
+            state   &= ~high_mask;
+
+            // not enough bytes yet
+            if( i + 1 < filter_len )
+                continue;
+
+            // too many mismatches in prefix
+            if( ( overflow >> last_shift ) & high_bit )
+                continue;
+
+            auto dist = (uint32_t)( ( state >> last_shift ) & field_mask );
+            if( dist > max_mismatches )
+                continue;
+
+            // pattern would end after the range, so will every match after this one
+            const auto match = i + 1 - filter_len;
+            if( match + pattern.size() > size )
+                break;
+
+            // verify the rest
+            for( size_t j = filter_len; j < pattern.size() && dist <= max_mismatches; ++j ) {
+                if( !pattern[ j ].compare( scan_start[ match + j ] ) )
+                    ++dist;
+            }
+
+            if( dist > max_mismatches )
+                continue;
+
+            // keep track of best match
+            if( dist < best_dist ) {
+                best_dist        = dist;
+                out.m_addr       = (uintptr_t)( scan_start + match );
+                out.m_best_count = 1;
+            }
+
+            else if( dist == best_dist )
+                ++out.m_best_count;
+        }
+
+        if( !out.m_addr )
+            return false;
+
+        out.m_distance   = best_dist;
+        out.m_confidence = ( (float)( fixed_amt - best_dist ) / (float)fixed_amt ) / (float)out.m_best_count;
+
+        return true;
+    }
+
 } // namespace PatternScan
\ No newline at end of file
@@ -4,9 +4,57 @@
 
 namespace PatternScan {
 
-    // search for an IDA-style pattern in range
+    // fwd declare
+    namespace Build {
+        class Pattern;
+        class CompiledPattern;
+    }
+
+    //
+    // result of a batch scan for a single pattern
+    //
+
+    class BatchResult {
+    public:
+        uintptr_t m_first; // first match, 0 if none
+        size_t    m_count; // total amount of matches
+    };
+
+    // batch result container
+    using batch_results_t = std::vector< BatchResult >;
+
+    //
+    // result of an approximate scan
+    //
+
+    class ApproxResult {
+    public:
+        uintptr_t m_addr;       // best match, 0 if none
+        uint32_t  m_distance;   // mismatched non-wildcard bytes at best match
+        uint32_t  m_best_count; // amount of matches with the same distance
+        float     m_confidence; // 0.0 - 1.0, lowered by mismatches and ambiguous matches
+    };
+
+    // search for an IDA-style (or extended, see ExtPattern) pattern in range
     extern NOINLINE uintptr_t find( uintptr_t start, size_t size, std::string_view pattern_str );
 
+    // search for a compiled pattern in range
+    extern NOINLINE uintptr_t find_compiled( uintptr_t start, size_t size, const Build::CompiledPattern &pattern );
+
+    // search for pattern in module with size
+    extern NOINLINE uintptr_t find_module( std::string_view module_name, size_t size, std::string_view pattern_str );
+
+    // search for pattern in entire module
+    extern NOINLINE uintptr_t find_module( std::string_view module_name, std::string_view pattern_str );
+
+    // search for many patterns in range with a single pass, every match is counted
+    // output has one entry per pattern (in order)
+    extern NOINLINE bool find_batch( uintptr_t start, size_t size, const std::vector< Build::Pattern > &patterns, batch_results_t &out );
+
+    // search for the closest match of an IDA-style pattern in range
+    // at most max_mismatches non-wildcard bytes may differ
+    extern NOINLINE bool find_approx( uintptr_t start, size_t size, std::string_view pattern_str, uint32_t max_mismatches, ApproxResult &out );
+
     //
     // templated funcs
     //
@@ -17,38 +65,13 @@ namespace PatternScan {
     }
 
     // search for pattern in module with size
-    template< typename t = uintptr_t > NOINLINE t find( std::string_view module_name, size_t size, std::string_view pattern_str ) {
-        IMAGE_DOS_HEADER *dos;
-        IMAGE_NT_HEADERS *nt;
-
-        // get needed module info
-        // we only need the start of the code section
-        const auto base = (uintptr_t)( GetModuleHandleA( ( !module_name.empty() ) ? module_name.data() : 0 ) );
-        if( !Utils::get_pe_file_headers( base, dos, nt ) )
-            return {};
-
-        const auto scan_start = Utils::RVA_to_ptr( base, nt->OptionalHeader.BaseOfCode );
-
-        // find pattern and cast
-        return find< t >( scan_start, size, pattern_str );
+    template< typename t = uintptr_t > FORCEINLINE t find( std::string_view module_name, size_t size, std::string_view pattern_str ) {
+        return (t)( find_module( module_name, size, pattern_str ) );
     }
 
     // search for pattern in entire module
     template< typename t = uintptr_t > FORCEINLINE t find( std::string_view module_name, std::string_view pattern_str ) {
-        IMAGE_DOS_HEADER *dos;
-        IMAGE_NT_HEADERS *nt;
-
-        // get needed module info
-        // we need the code section start and size
-        const auto base = (uintptr_t)( GetModuleHandleA( ( !module_name.empty() ) ? module_name.data() : 0 ) );
-        if( !Utils::get_pe_file_headers( base, dos, nt ) )
-            return {};
-
-        const auto scan_start = Utils::RVA_to_ptr( base, nt->OptionalHeader.BaseOfCode );
-        const auto scan_size  = nt->OptionalHeader.SizeOfCode;
-
-        // find pattern and cast
-        return find< t >( scan_start, scan_size, pattern_str );
+        return (t)( find_module( module_name, pattern_str ) );
     }
 
 } // namespace PatternScan
\ No newline at end of file
@@ -0,0 +1,176 @@
+#pragma once
+
+#include "hash.h"
+
+//
+// compile-time perfect hash maps for fixed string sets
+// a seed that puts every key in its own slot is searched for at compile time, lookups are one hash, one index and one compare
+//
+// example:
+//     constexpr auto MAP = PerfectHash::make_map< wchar_t, int >( { { L"a", 1 }, { L"b", 2 } } );
+//     const auto value = MAP.find( L"a" ); // pointer to 1, null if the key isn't in the map
+//
+// maps made with fold = true ignore ASCII case, in keys and lookups
+//
+
+namespace PerfectHash {
+
+    namespace T {
+
+        // the seed search has to fit in the compiler's constexpr evaluation limit
+        // msvc's /constexpr:steps and clang's -fconstexpr-steps both default to 1 << 20
+        constexpr size_t MAX_STEPS = size_t{ 1 } << 20;
+
+        // rough steps per key placed while trying a seed (hash mix, slot check, store, loop)
+        constexpr size_t STEPS_PER_KEY = 16;
+
+        // keys placed over every seed tried before giving up, well under the step limit
+        // a bad seed usually fails after a few keys, so this is thousands of seeds
+        constexpr size_t MAX_TRIES = MAX_STEPS / STEPS_PER_KEY;
+
+        // max seeds to try before giving up
+        constexpr uint32_t MAX_SEED = 0x10000;
+
+        // max keys per map, with 4 slots per key a seed for this many is found in a few thousand tries
+        // (test_perfect_hash checks random key sets up to this size)
+        constexpr size_t MAX_KEYS = 48;
+
+        // not constexpr, calling it at compile time fails the build with this name in the error
+        // used when no seed works within MAX_TRIES (duplicate keys, or an unlucky key set)
+        inline uint32_t no_seed_found_check_for_duplicate_keys() {
+            return 0;
+        }
+
+        // bits needed for at least 4 slots per key
+        FORCEINLINE constexpr size_t get_slot_bits( size_t amt ) {
+            size_t bits = 1;
+
+            while( ( size_t{ 1 } << bits ) < amt * 4 )
+                ++bits;
+
+            return bits;
+        }
+
+    } // namespace T
+
+    template< typename char_t, typename value_t > class Entry {
+    public:
+        std::basic_string_view< char_t > m_key;
+        value_t                          m_value;
+    };
+
+    template< typename char_t, typename value_t, size_t n, bool fold = false > class Map {
+    private:
+        // types
+        using entry_t    = Entry< char_t, value_t >;
+        using str_view_t = std::basic_string_view< char_t >;
+
+        static constexpr size_t SLOT_BITS = T::get_slot_bits( n );
+        static constexpr size_t SLOT_AMT  = size_t{ 1 } << SLOT_BITS;
+
+        static_assert( n > 0, "PerfectHash::Map: no keys" );
+        static_assert( n <= T::MAX_KEYS, "PerfectHash::Map: too many keys for the compile-time seed search, split the map or use a sorted array" );
+
+        std::array< entry_t, n >         m_entries;
+        std::array< uint16_t, SLOT_AMT > m_slots;   // entry index + 1, 0 if empty
+        uint32_t                         m_seed;
+        bool                             m_found;
+
+        // hash / compare keys
+        static FORCEINLINE constexpr uint32_t ct_hash( str_view_t key ) {
+            return fold ? FNV1aHash::ct_get_32_fold( key ) : FNV1aHash::ct_get_32( key );
+        }
+
+        static FORCEINLINE hash32_t hash( str_view_t key ) {
+            return fold ? FNV1aHash::get_32_fold( key ) : FNV1aHash::get_32( key );
+        }
+
+        static FORCEINLINE constexpr bool equals( str_view_t a, str_view_t b ) {
+            return fold ? FNV1aHash::equals_fold( a, b ) : a == b;
+        }
+
+        // keys are hashed with FNV-1a, the seed only scatters that hash
+        // so callers that already have the FNV-1a hash of a key don't need to hash it again
+        static FORCEINLINE constexpr size_t get_slot( uint32_t hash, uint32_t seed ) {
+            return (size_t)( (uint32_t)( ( hash ^ seed ) * 0x9E3779B1 ) >> ( 32 - SLOT_BITS ) );
+        }
+
+    public:
+        constexpr Map( const std::array< entry_t, n > &entries ) : m_entries{ entries }, m_slots{}, m_seed{ 0 }, m_found{ false } {
+            std::array< uint32_t, n > hashes{};
+
+            for( size_t i = 0; i < n; ++i )
+                hashes[ i ] = ct_hash( entries[ i ].m_key );
+
+            // slots taken by the current seed hold seed + 1, so nothing is cleared between seeds
+            std::array< uint32_t, SLOT_AMT > taken{};
+
+            size_t tries = 0;
+
+            for( uint32_t seed = 0; seed < T::MAX_SEED && tries < T::MAX_TRIES; ++seed ) {
+                auto ok = true;
+
+                for( size_t i = 0; ok && i < n; ++i, ++tries ) {
+                    auto &slot = taken[ get_slot( hashes[ i ], seed ) ];
+
+                    ok   = ( slot != seed + 1 );
+                    slot = seed + 1;
+                }
+
+                if( ok ) {
+                    for( size_t i = 0; i < n; ++i )
+                        m_slots[ get_slot( hashes[ i ], seed ) ] = (uint16_t)( i + 1 );
+
+                    m_seed  = seed;
+                    m_found = true;
+
+                    return;
+                }
+            }
+
+            m_seed = T::no_seed_found_check_for_duplicate_keys();
+        }
+
+        // find value for a key with its FNV-1a hash (case folded if the map is), null if not found
+        FORCEINLINE const value_t *find( str_view_t key, hash32_t hash ) const {
+            const auto index = m_slots[ get_slot( hash, m_seed ) ];
+            if( !index )
+                return nullptr;
+
+            const auto &entry = m_entries[ index - 1 ];
+
+            return equals( entry.m_key, key ) ? &entry.m_value : nullptr;
+        }
+
+        // find value for a key, null if not found
+        FORCEINLINE const value_t *find( str_view_t key ) const {
+            return find( key, hash( key ) );
+        }
+
+        // amount of keys
+        FORCEINLINE constexpr size_t size() const {
+            return n;
+        }
+
+        // seed the search settled on
+        FORCEINLINE constexpr uint32_t get_seed() const {
+            return m_seed;
+        }
+
+        // did the search find a seed? always true at compile time, the build fails otherwise
+        FORCEINLINE constexpr bool is_valid() const {
+            return m_found;
+        }
+    };
+
+    // make a map from a list of entries
+    template< typename char_t, typename value_t, bool fold = false, size_t n > FORCEINLINE constexpr Map< char_t, value_t, n, fold > make_map( const Entry< char_t, value_t > ( &entries )[ n ] ) {
+        std::array< Entry< char_t, value_t >, n > out{};
+
+        for( size_t i = 0; i < n; ++i )
+            out[ i ] = entries[ i ];
+
+        return Map< char_t, value_t, n, fold >( out );
+    }
+
+} // namespace PerfectHash
\ No newline at end of file
@@ -86,6 +86,15 @@ public:
         close();
     }
 
+    // close current handle and take a new one
+    FORCEINLINE void reset( HANDLE handle = nullptr ) {
+        close();
+
+        m_handle = nullptr;
+
+        init( handle );
+    }
+
     // return handle as t
     // null if invalid
     template< typename t = HANDLE > FORCEINLINE t get() const {
@@ -0,0 +1,235 @@
+#include "sig_report.h"
+#include "ext_pattern.h"
+
+namespace SigReport {
+
+    //
+    // MappedImage
+    //
+
+    NOINLINE bool MappedImage::init( const std_fs::path &filename ) {
+        IMAGE_DOS_HEADER *dos;
+        IMAGE_NT_HEADERS *nt;
+
+        m_image.clear();
+
+        // open up file at end
+        auto file = std::ifstream( filename, ( std::ios::ate | std::ios::binary ) );
+        if( !file )
+            return false;
+
+        // get filesize
+        const auto file_size = file.tellg();
+        if( file_size == -1 )
+            return false;
+
+        // go back to start, since we opened at the end
+        file.seekg( 0 );
+
+        // read file contents to buffer
+        auto file_buffer = std::vector< uint8_t >( (size_t)file_size );
+        if( !file.read( (char *)file_buffer.data(), file_size ) )
+            return false;
+
+        // need at least a DOS header before we can look at anything else
+        if( file_buffer.size() < sizeof( IMAGE_DOS_HEADER ) )
+            return false;
+
+        const auto nt_offset = (size_t)( ( (IMAGE_DOS_HEADER *)file_buffer.data() )->e_lfanew );
+        if( nt_offset + sizeof( IMAGE_NT_HEADERS ) > file_buffer.size() )
+            return false;
+
+        if( !Utils::get_pe_file_headers( (uintptr_t)( file_buffer.data() ), dos, nt ) )
+            return false;
+
+        const auto &opt = nt->OptionalHeader;
+        if( opt.SizeOfHeaders > file_buffer.size() || opt.SizeOfHeaders > opt.SizeOfImage )
+            return false;
+
+        // allocate image, copy headers
+        m_image.assign( opt.SizeOfImage, 0 );
+
+        std::memcpy( m_image.data(), file_buffer.data(), opt.SizeOfHeaders );
+
+        // copy each section to its virtual address
+        const auto sections = IMAGE_FIRST_SECTION( nt );
+
+        for( uint16_t i = 0; i < nt->FileHeader.NumberOfSections; ++i ) {
+            const auto &s = sections[ i ];
+
+            const auto raw_size = (size_t)( std::min( s.SizeOfRawData, s.Misc.VirtualSize ? s.Misc.VirtualSize : s.SizeOfRawData ) );
+
+            // skip sections that don't fit
+            if( (size_t)s.PointerToRawData + raw_size > file_buffer.size() )
+                continue;
+
+            if( (size_t)s.VirtualAddress + raw_size > m_image.size() )
+                continue;
+
+            std::memcpy( &m_image[ s.VirtualAddress ], &file_buffer[ s.PointerToRawData ], raw_size );
+        }
+
+        m_image_base = opt.ImageBase;
+        m_code_rva   = opt.BaseOfCode;
+        m_code_size  = std::min( (size_t)opt.SizeOfCode, m_image.size() - std::min( (size_t)opt.BaseOfCode, m_image.size() ) );
+
+        return true;
+    }
+
+    //
+    // helpers
+    //
+
+    // escape a string for JSON output
+    // control chars can't appear in JSON strings as-is
+    static NOINLINE std::string json_escape( std::string_view str ) {
+        std::string out;
+
+        out.reserve( str.size() );
+
+        for( const auto &c : str ) {
+            if( (uint8_t)c < 0x20 ) {
+                out += fmt::format( "\\u{:04X}", (uint8_t)c );
+
+                continue;
+            }
+
+            if( c == '\\' || c == '"' )
+                out += '\\';
+
+            out += c;
+        }
+
+        return out;
+    }
+
+    // read game name from a mapped image, same as the loader does at runtime
+    static NOINLINE int8_t identify_game( const MappedImage &image, uintptr_t name_match ) {
+        const auto sig = Signatures::get( UMI_GAME_INVALID, Signatures::SIG_GAME_NAME );
+        if( !sig || !name_match )
+            return UMI_GAME_INVALID;
+
+        const auto name_addr = Signatures::resolve_chain( *sig, name_match, image.get_reloc_delta() );
+        if( !image.contains( name_addr ) )
+            return UMI_GAME_INVALID;
+
+        // read wide string (UTF-16), stop at the end of the image
+        std::wstring name;
+
+        for( auto cur = name_addr; image.contains( cur + 1 ); cur += 2 ) {
+            const auto wc = *(uint16_t *)cur;
+            if( !wc )
+                break;
+
+            // the games use backslashes for filepaths, we don't need them
+            if( wc != L'\\' )
+                name += (wchar_t)wc;
+        }
+
+        return Signatures::game_id_from_name( name );
+    }
+
+    //
+    // funcs
+    //
+
+    NOINLINE int32_t run( const std_fs::path &builds_dir, const std_fs::path &out_file ) {
+        using steady_clock_t = std::chrono::steady_clock;
+
+        int32_t failed_amt = 0;
+
+        if( !std_fs::is_directory( builds_dir ) )
+            return -1;
+
+        auto out = std::ofstream( out_file, std::ios::trunc );
+        if( !out )
+            return -1;
+
+        // build all patterns once
+        const auto &sigs = Signatures::get_all();
+
+        std::vector< PatternScan::Build::Pattern > patterns;
+
+        for( const auto &s : sigs )
+            patterns.emplace_back( s.m_pattern );
+
+        PatternScan::batch_results_t results;
+
+        // iterate files
+        for( const auto &f : std_fs::recursive_directory_iterator( builds_dir ) ) {
+            if( !f.is_regular_file() || f.path().extension() != L".exe" )
+                continue;
+
+            const auto filename = json_escape( f.path().u8string() );
+
+            MappedImage image;
+            if( !image.init( f.path() ) ) {
+                out << fmt::format( "{{\"file\":\"{}\",\"error\":\"invalid PE file\"}}\n", filename );
+
+                ++failed_amt;
+
+                continue;
+            }
+
+            // one pass over the code section for every signature
+            const auto batch_start = steady_clock_t::now();
+
+            PatternScan::find_batch( image.get_code_start(), image.get_code_size(), patterns, results );
+
+            // extended patterns can't be batched
+            for( size_t i = 0; i < sigs.size(); ++i ) {
+                if( !PatternScan::Build::ExtPattern::is_extended( sigs[ i ].m_pattern ) )
+                    continue;
+
+                auto &res = results[ i ];
+
+                res.m_first = PatternScan::Build::ExtPattern( sigs[ i ].m_pattern ).find( image.get_code_start(), image.get_code_size(), &res.m_count );
+            }
+
+            const auto batch_us = std::chrono::duration_cast< std::chrono::microseconds >( steady_clock_t::now() - batch_start ).count();
+
+            // find out which game this is
+            size_t name_idx = 0;
+
+            while( name_idx < sigs.size() && sigs[ name_idx ].m_id != Signatures::SIG_GAME_NAME )
+                ++name_idx;
+
+            const auto game_id = ( name_idx < sigs.size() ) ? identify_game( image, results[ name_idx ].m_first ) : (int8_t)UMI_GAME_INVALID;
+
+            out << fmt::format( "{{\"file\":\"{}\",\"game\":{},\"batch_us\":{}}}\n", filename, (int32_t)game_id, batch_us );
+
+            // report each signature
+            for( size_t i = 0; i < sigs.size(); ++i ) {
+                const auto &sig = sigs[ i ];
+                const auto &res = results[ i ];
+
+                // time a single scan + offset chain, this is what the loader pays at runtime
+                const auto sig_start = steady_clock_t::now();
+
+                const auto match    = PatternScan::find( image.get_code_start(), image.get_code_size(), sig.m_pattern );
+                const auto resolved = ( match ) ? Signatures::resolve_chain( sig, match, image.get_reloc_delta() ) : 0;
+
+                const auto sig_us = std::chrono::duration_cast< std::chrono::microseconds >( steady_clock_t::now() - sig_start ).count();
+
+                // RVAs, 0 if not found / outside of the image
+                const auto match_rva    = ( match ) ? match - image.get_base() : 0;
+                const auto resolved_rva = ( image.contains( resolved ) ) ? resolved - image.get_base() : 0;
+
+                // only the signatures the loader would use for the detected game count as failures
+                const auto is_for_game = Signatures::get( game_id, sig.m_id ) == &sig;
+                const auto is_unique   = res.m_count == 1;
+
+                if( is_for_game && ( !is_unique || !resolved_rva ) )
+                    ++failed_amt;
+
+                out << fmt::format(
+                    "{{\"file\":\"{}\",\"game\":{},\"sig\":\"{}\",\"sig_game\":{},\"for_game\":{},\"matches\":{},\"unique\":{},\"match_rva\":\"0x{:X}\",\"resolved_rva\":\"0x{:X}\",\"time_us\":{}}}\n",
+                    filename, (int32_t)game_id, sig.m_name, (int32_t)sig.m_game_id, is_for_game, res.m_count, is_unique, match_rva, resolved_rva, sig_us
+                );
+            }
+        }
+
+        return failed_amt;
+    }
+
+} // namespace SigReport
\ No newline at end of file
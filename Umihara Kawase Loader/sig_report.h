@@ -0,0 +1,72 @@
+#pragma once
+
+#include "includes.h"
+
+//
+// offline signature health report
+// maps game executables from disk and checks that every signature still resolves and is unique
+//
+
+namespace SigReport {
+
+    //
+    // an executable mapped from disk with its sections at their virtual addresses
+    //
+
+    class MappedImage {
+    private:
+        // mapped image
+        std::vector< uint8_t > m_image;
+
+        // OptionalHeader.ImageBase
+        uintptr_t m_image_base;
+
+        // OptionalHeader.BaseOfCode / OptionalHeader.SizeOfCode
+        uintptr_t m_code_rva;
+        size_t    m_code_size;
+
+    public:
+        MappedImage() = default;
+
+        // read and map file
+        NOINLINE bool init( const std_fs::path &filename );
+
+        // mapped base
+        FORCEINLINE uintptr_t get_base() const {
+            return (uintptr_t)m_image.data();
+        }
+
+        // size of the mapped image
+        FORCEINLINE size_t get_size() const {
+            return m_image.size();
+        }
+
+        // pointers read from the image must be moved by this amount
+        FORCEINLINE intptr_t get_reloc_delta() const {
+            return (intptr_t)( get_base() - m_image_base );
+        }
+
+        // code section start / size
+        FORCEINLINE uintptr_t get_code_start() const {
+            return get_base() + m_code_rva;
+        }
+
+        FORCEINLINE size_t get_code_size() const {
+            return m_code_size;
+        }
+
+        // is an address inside of the image?
+        FORCEINLINE bool contains( uintptr_t addr ) const {
+            return addr >= get_base() && addr < get_base() + get_size();
+        }
+    };
+
+    //
+    // funcs in source file
+    //
+
+    // map every .exe in a directory (recursive) and write a JSON lines report
+    // returns the amount of signatures that failed (missing or not unique), or -1 on error
+    extern NOINLINE int32_t run( const std_fs::path &builds_dir, const std_fs::path &out_file );
+
+} // namespace SigReport
\ No newline at end of file
@@ -0,0 +1,171 @@
+#include "signatures.h"
+
+namespace Signatures {
+
+    //
+    // signature list
+    //
+
+    static const std::vector< Signature > g_signatures = {
+        // reference to game path wstring
+        // this is pretty silly but my guess is the steam DRM unpacking routine takes a bit to finish, so this one is polled (???)
+        {
+            SIG_GAME_NAME, UMI_GAME_INVALID, "game_name",
+            "0F B7 8A ? ? ? ? 66 85 C9 75 EA 33 C9 66 89 0C 46 EB 77",
+            { { { STEP_ADD, 3 }, { STEP_DEREF, 0 } } }, 2
+        },
+
+        //
+        // every game
+        // one pattern each for the three games, the differing bytes are alternations / gaps:
+        //     UmiharaKawase:           E8 <rel> B8 <imm32>       8B FF
+        //     Shun SE / Sayonara:      E8 <rel> FF 35 <m32>      8B 35
+        //
+
+        {
+            SIG_INPUT_HANDLER, UMI_GAME_INVALID, "input_handler",
+            "E8 ? ? ? ? (B8|FF) [0-1] ? ? ? ? 8B (FF|35)",
+            { { { STEP_FOLLOW_REL, 0 } } }, 1
+        },
+
+        //
+        // Sayonara Umihara Kawase
+        // the mov before the key list is part of its pattern, so its offset chain can't be shared with the other games
+        // note: listed before the key list for the other games, get() returns the first match
+        //
+
+        // skip over (mov [reg+disp32], reg)
+        // (modrm = 2, 0, 6)
+        {
+            SIG_KEY_LIST, UMI_GAME_SAYONARA_KAWASE, "key_list",
+            "89 86 ? ? ? ? B8 ? ? ? ? EB 08",
+            { { { STEP_ADD, 7 }, { STEP_DEREF, 0 }, { STEP_ADD, -4 } } }, 3
+        },
+
+        //
+        // UmiharaKawase / Shun SE
+        //     UmiharaKawase:  B8 <imm32> 8D 9B
+        //     Shun SE:        B8 <imm32> EB 08
+        //
+
+        // actual key list starts 4 bytes back
+        {
+            SIG_KEY_LIST, UMI_GAME_INVALID, "key_list",
+            "B8 ? ? ? ? (8D|EB) (9B|08)",
+            { { { STEP_DEREF, 0 }, { STEP_ADD, -4 } } }, 2
+        }
+    };
+
+    //
+    // funcs
+    //
+
+    NOINLINE const std::vector< Signature > &get_all() {
+        return g_signatures;
+    }
+
+    NOINLINE const Signature *get( int8_t game_id, SigID id ) {
+        for( const auto &s : g_signatures ) {
+            if( s.m_id != id )
+                continue;
+
+            if( s.m_game_id == game_id || s.m_game_id == UMI_GAME_INVALID )
+                return &s;
+        }
+
+        return nullptr;
+    }
+
+    NOINLINE uintptr_t resolve_chain( const Signature &sig, uintptr_t match, intptr_t reloc_delta ) {
+        auto out = match;
+
+        for( size_t i = 0; i < sig.m_num_steps && out; ++i ) {
+            const auto &step = sig.m_steps[ i ];
+
+            switch( step.m_type ) {
+                case STEP_ADD: {
+                    out += step.m_value;
+
+                    break;
+                }
+
+                case STEP_DEREF: {
+                    out = *(uint32_t *)out;
+                    if( out )
+                        out += reloc_delta;
+
+                    break;
+                }
+
+                case STEP_FOLLOW_REL: {
+                    out = Utils::follow_rel_instruction( out );
+
+                    break;
+                }
+
+                default: {
+                    return 0;
+                }
+            }
+        }
+
+        return out;
+    }
+
+    // game window names
+    static constexpr auto GAME_NAMES = PerfectHash::make_map< wchar_t, int8_t >( {
+        { L"UmiharaKawase",           UMI_GAME_KAWASE          },
+        { L"UmiharaKawase Shun SE",   UMI_GAME_KAWASE_SHUN     },
+        { L"Sayonara Umihara Kawase", UMI_GAME_SAYONARA_KAWASE }
+    } );
+
+    NOINLINE int8_t game_id_from_name( std::wstring_view name ) {
+        const auto game_id = GAME_NAMES.find( name );
+
+        return game_id ? *game_id : (int8_t)UMI_GAME_INVALID;
+    }
+
+    NOINLINE uintptr_t find( int8_t game_id, SigID id, PatternScan::ApproxResult *approx_out ) {
+        if( approx_out )
+            *approx_out = PatternScan::ApproxResult{ 0, 0, 0, 0.f };
+
+        const auto sig = get( game_id, id );
+        if( !sig )
+            return 0;
+
+        // exact match
+        const auto match = PatternScan::find( "", sig->m_pattern );
+        if( match )
+            return resolve_chain( *sig, match );
+
+        if( !approx_out || !allows_approx( id ) )
+            return 0;
+
+        // closest match in the code section
+        const auto module = ModuleCache::get( "" );
+        if( !module )
+            return 0;
+
+        const auto &code = module->get_code();
+
+        PatternScan::ApproxResult approx;
+        if( !PatternScan::find_approx( code.get_start(), code.get_size(), sig->m_pattern, APPROX_MAX_MISMATCHES, approx ) )
+            return 0;
+
+        if( approx.m_confidence < APPROX_MIN_CONFIDENCE )
+            return 0;
+
+        // a close match could still be the wrong code, make sure the result is inside of the image
+        const auto image_start = module->get_base();
+        const auto image_end   = image_start + module->get_image_size();
+
+        const auto resolved = resolve_chain( *sig, approx.m_addr );
+        if( resolved < image_start || resolved >= image_end )
+            return 0;
+
+        *approx_out = approx;
+
+        return resolved;
+    }
+
+} // namespace Signatures
\ No newline at end of file
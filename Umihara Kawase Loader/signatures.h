@@ -0,0 +1,96 @@
+#pragma once
+
+#include "includes.h"
+
+// fwd declare
+namespace PatternScan {
+    class ApproxResult;
+}
+
+//
+// per-game signatures and how to get from a match to the address we want
+//
+
+namespace Signatures {
+
+    //
+    // signature types, etc
+    //
+
+    // what a signature resolves to
+    enum SigID : uint8_t {
+        SIG_GAME_NAME = 0, // game path wstring in .rdata
+        SIG_INPUT_HANDLER, // input handler func
+        SIG_KEY_LIST,      // game key list array in .rdata
+        SIG_MAX
+    };
+
+    // a single step applied to a match
+    enum StepType : uint8_t {
+        STEP_ADD = 0,    // add value
+        STEP_DEREF,      // read pointer at address
+        STEP_FOLLOW_REL  // follow relative call / jmp (E8 / E9)
+    };
+
+    class Step {
+    public:
+        StepType m_type;
+        int32_t  m_value;
+    };
+
+    // max steps in an offset chain
+    constexpr size_t MAX_STEPS = 4;
+
+    // approximate fallback limits
+    // used when a game update changed a few bytes of a signature
+    constexpr uint32_t APPROX_MAX_MISMATCHES = 3;
+    constexpr float    APPROX_MIN_CONFIDENCE = 0.75f;
+
+    // can a signature fall back to its closest match?
+    // the input handler gets hooked, a detour on code that only looks like it would crash the game
+    FORCEINLINE constexpr bool allows_approx( SigID id ) {
+        return id != SIG_INPUT_HANDLER;
+    }
+
+    class Signature {
+    public:
+        SigID                         m_id;
+        int8_t                        m_game_id; // UMI_GAME_INVALID means any game
+        std::string_view              m_name;
+        std::string_view              m_pattern;
+        std::array< Step, MAX_STEPS > m_steps;
+        size_t                        m_num_steps;
+    };
+
+    //
+    // funcs in source file
+    //
+
+    // returns every signature for every game
+    extern NOINLINE const std::vector< Signature > &get_all();
+
+    // find a signature for a game
+    extern NOINLINE const Signature *get( int8_t game_id, SigID id );
+
+    // apply offset chain to a match
+    // reloc_delta is added to every pointer read, this is only needed for images that weren't relocated by the windows loader
+    extern NOINLINE uintptr_t resolve_chain( const Signature &sig, uintptr_t match, intptr_t reloc_delta = 0 );
+
+    // convert the game name found with SIG_GAME_NAME to a game ID
+    extern NOINLINE int8_t game_id_from_name( std::wstring_view name );
+
+    // scan the main executable for a signature and apply its offset chain
+    // if approx_out is set and there's no exact match, the closest match is used instead (approx_out->m_addr is 0 otherwise)
+    // note: only for signatures that allows_approx(), and only IDA-style patterns (extended ones have no approximate scan)
+    extern NOINLINE uintptr_t find( int8_t game_id, SigID id, PatternScan::ApproxResult *approx_out = nullptr );
+
+    //
+    // templated funcs
+    //
+
+    // scan the main executable for a signature and apply its offset chain
+    template< typename t = uintptr_t > FORCEINLINE t find( int8_t game_id, SigID id, PatternScan::ApproxResult *approx_out = nullptr ) {
+        return (t)( find( game_id, id, approx_out ) );
+    }
+
+} // namespace Signatures
\ No newline at end of file
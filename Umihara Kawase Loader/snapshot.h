@@ -0,0 +1,113 @@
+#pragma once
+
+#include "includes.h"
+
+//
+// immutable snapshot published through an atomic pointer swap
+// reads never lock or allocate, old snapshots are freed once the reader has moved past them
+//
+// note: there must only be one reader thread (the game's input thread)
+// note: freeing only happens in publish(), so a swapped out snapshot stays alive until the next publish (or until this is destroyed)
+//
+
+template< typename t > class Snapshot {
+private:
+    // retired snapshot and the reader epoch when it was swapped out
+    class Retired {
+    public:
+        const t  *m_ptr;
+        uint32_t m_epoch;
+    };
+
+    // current snapshot
+    std::atomic< const t * > m_current;
+
+    // bumped by the reader after every read
+    std::atomic< uint32_t > m_epoch;
+
+    // writer side only
+    std::mutex              m_writer_mutex;
+    std::vector< Retired >  m_retired;
+
+    // free every snapshot the reader can't be using anymore
+    // a read that started before the swap has finished once the epoch moved
+    FORCEINLINE void reclaim() {
+        const auto epoch = m_epoch.load();
+
+        const auto it = std::remove_if( m_retired.begin(), m_retired.end(),
+            [ & ]( const Retired &r ) {
+                if( r.m_epoch == epoch )
+                    return false;
+
+                delete r.m_ptr;
+
+                return true;
+            }
+        );
+
+        m_retired.erase( it, m_retired.end() );
+    }
+
+public:
+    //
+    // scoped read, use this from the reader thread
+    //
+
+    class Reader {
+    private:
+        Snapshot &m_snapshot;
+        const t  *m_ptr;
+
+    public:
+        FORCEINLINE Reader( Snapshot &snapshot ) : m_snapshot{ snapshot }, m_ptr{ snapshot.m_current.load() } {
+
+        }
+
+        FORCEINLINE ~Reader() {
+            m_snapshot.m_epoch.fetch_add( 1 );
+        }
+
+        Reader( const Reader & )             = delete;
+        Reader &operator =( const Reader & ) = delete;
+
+        // returns snapshot, null if nothing was published yet
+        FORCEINLINE const t *get() const {
+            return m_ptr;
+        }
+
+        FORCEINLINE const t *operator ->() const {
+            return m_ptr;
+        }
+
+        FORCEINLINE operator bool() const {
+            return m_ptr != nullptr;
+        }
+    };
+
+    Snapshot() : m_current{ nullptr }, m_epoch{ 0 }, m_writer_mutex{}, m_retired{} {
+
+    }
+
+    ~Snapshot() {
+        delete m_current.load();
+
+        for( const auto &r : m_retired )
+            delete r.m_ptr;
+    }
+
+    Snapshot( const Snapshot & )             = delete;
+    Snapshot &operator =( const Snapshot & ) = delete;
+
+    // swap in a new snapshot
+    // the old one is kept until a later publish finds the reader has moved past it
+    NOINLINE void publish( std::unique_ptr< const t > snapshot ) {
+        std::lock_guard< std::mutex > lock( m_writer_mutex );
+
+        const auto old = m_current.exchange( snapshot.release() );
+
+        if( old )
+            m_retired.push_back( Retired{ old, m_epoch.load() } );
+
+        reclaim();
+    }
+};
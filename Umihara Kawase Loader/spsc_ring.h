@@ -0,0 +1,110 @@
+#pragma once
+
+#include "includes.h"
+
+//
+// fixed size single-producer / single-consumer ring buffer
+// pushes and pops never lock, wait or allocate, a full ring drops the push
+//
+// note: there must only be one producer thread and one consumer thread
+//
+
+template< typename t, size_t n > class SpscRing {
+private:
+    static_assert( n > 1 && ( n & ( n - 1 ) ) == 0, "SpscRing: size must be a power of 2" );
+
+    static constexpr size_t MASK = n - 1;
+
+    // keep producer / consumer counters on their own cache lines, they're written by different threads
+    static constexpr size_t CACHE_LINE = 64;
+
+    // items, heap allocated since rings can be big
+    std::unique_ptr< t[] > m_items;
+
+    // next slot to write, only written by the producer
+    alignas( CACHE_LINE ) std::atomic< size_t > m_head;
+
+    // next slot to read, only written by the consumer
+    alignas( CACHE_LINE ) std::atomic< size_t > m_tail;
+
+    // producer side copy of m_tail, saves reading the consumer's cache line on every push
+    alignas( CACHE_LINE ) size_t m_cached_tail;
+
+    // pushes dropped because the ring was full
+    std::atomic< size_t > m_dropped;
+
+public:
+    SpscRing() : m_items{ std::make_unique< t[] >( n ) }, m_head{ 0 }, m_tail{ 0 }, m_cached_tail{ 0 }, m_dropped{ 0 } {
+
+    }
+
+    SpscRing( const SpscRing & )             = delete;
+    SpscRing &operator =( const SpscRing & ) = delete;
+
+    //
+    // producer side
+    //
+
+    // get the next free slot to fill in place, null if the ring is full
+    // the slot is only visible to the consumer after commit()
+    FORCEINLINE t *reserve() {
+        const auto head = m_head.load( std::memory_order_relaxed );
+
+        if( head - m_cached_tail >= n ) {
+            m_cached_tail = m_tail.load( std::memory_order_acquire );
+
+            if( head - m_cached_tail >= n ) {
+                m_dropped.fetch_add( 1, std::memory_order_relaxed );
+
+                return nullptr;
+            }
+        }
+
+        return &m_items[ head & MASK ];
+    }
+
+    // publish the slot from reserve()
+    FORCEINLINE void commit() {
+        m_head.store( m_head.load( std::memory_order_relaxed ) + 1, std::memory_order_release );
+    }
+
+    // copy an item in, false if the ring is full
+    FORCEINLINE bool push( const t &item ) {
+        const auto slot = reserve();
+        if( !slot )
+            return false;
+
+        *slot = item;
+
+        commit();
+
+        return true;
+    }
+
+    //
+    // consumer side
+    //
+
+    // call func on every item pushed so far and free their slots, returns item amount
+    template< typename func_t > FORCEINLINE size_t drain( func_t &&func ) {
+        const auto tail = m_tail.load( std::memory_order_relaxed );
+        const auto head = m_head.load( std::memory_order_acquire );
+
+        for( auto i = tail; i != head; ++i )
+            func( (const t &)m_items[ i & MASK ] );
+
+        m_tail.store( head, std::memory_order_release );
+
+        return head - tail;
+    }
+
+    // pushes dropped so far, from any thread
+    FORCEINLINE size_t get_dropped() const {
+        return m_dropped.load( std::memory_order_relaxed );
+    }
+
+    // ring size
+    FORCEINLINE constexpr size_t capacity() const {
+        return n;
+    }
+};
\ No newline at end of file
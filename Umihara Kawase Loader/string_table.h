@@ -0,0 +1,200 @@
+#pragma once
+
+#include "hash.h"
+
+//
+// string interning table
+// every distinct string is stored once, handles are 32-bit and equal handles mean equal strings
+// strings live in fixed blocks that never move, so views returned by get() stay valid until the table is cleared
+//
+// tables made with fold = true ignore ASCII case and store the folded string
+//
+
+template< typename char_t > class StringTable {
+public:
+    // types
+    using str_view_t = std::basic_string_view< char_t >;
+    using handle_t   = uint32_t;
+
+    static constexpr handle_t INVALID_HANDLE = 0xFFFFFFFF;
+
+private:
+    class Entry {
+    public:
+        hash32_t   m_hash;
+        str_view_t m_str;
+    };
+
+    // chars per storage block, longer strings get a block of their own
+    static constexpr size_t BLOCK_SIZE = 4096;
+
+    // min lookup table size (power of 2)
+    static constexpr size_t MIN_INDEX_SIZE = 16;
+
+    // fold ASCII case?
+    bool m_fold;
+
+    // string storage
+    std::vector< std::unique_ptr< char_t[] > > m_blocks;
+    size_t                                     m_block_used;
+    size_t                                     m_block_size;
+
+    // interned strings, indexed by handle
+    std::vector< Entry > m_entries;
+
+    // open-addressing lookup table of handles, load is kept at or below 50%
+    std::vector< handle_t > m_index;
+    size_t                  m_index_mask;
+
+    FORCEINLINE hash32_t make_hash( str_view_t str ) const {
+        return m_fold ? FNV1aHash::get_32_fold( str ) : FNV1aHash::get_32( str );
+    }
+
+    FORCEINLINE bool equals( str_view_t a, str_view_t b ) const {
+        return m_fold ? FNV1aHash::equals_fold( a, b ) : a == b;
+    }
+
+    // copy a string into storage, null terminated
+    NOINLINE str_view_t store( str_view_t str ) {
+        const auto needed = str.size() + 1;
+
+        // start a new block
+        if( m_blocks.empty() || m_block_used + needed > m_block_size ) {
+            m_block_size = std::max( BLOCK_SIZE, needed );
+            m_block_used = 0;
+
+            m_blocks.push_back( std::make_unique< char_t[] >( m_block_size ) );
+        }
+
+        const auto out = m_blocks.back().get() + m_block_used;
+
+        for( size_t i = 0; i < str.size(); ++i )
+            out[ i ] = m_fold ? FNV1aHash::fold_ascii( str[ i ] ) : str[ i ];
+
+        out[ str.size() ] = char_t{ 0 };
+
+        m_block_used += needed;
+
+        return str_view_t( out, str.size() );
+    }
+
+    // find the slot a string is in, or the empty slot it would go in
+    FORCEINLINE size_t find_slot( str_view_t str, hash32_t hash ) const {
+        auto slot = hash.get() & m_index_mask;
+
+        for( ; m_index[ slot ] != INVALID_HANDLE; slot = ( slot + 1 ) & m_index_mask ) {
+            const auto &e = m_entries[ m_index[ slot ] ];
+
+            // hashes match, verify the strings too so colliding strings don't alias
+            if( e.m_hash == hash && equals( e.m_str, str ) )
+                break;
+        }
+
+        return slot;
+    }
+
+    // double the lookup table and reinsert everything
+    NOINLINE void grow_index() {
+        const auto capacity = m_index.empty() ? MIN_INDEX_SIZE : m_index.size() * 2;
+
+        m_index.assign( capacity, INVALID_HANDLE );
+        m_index_mask = capacity - 1;
+
+        for( handle_t i = 0; i < (handle_t)m_entries.size(); ++i ) {
+            auto slot = m_entries[ i ].m_hash.get() & m_index_mask;
+
+            while( m_index[ slot ] != INVALID_HANDLE )
+                slot = ( slot + 1 ) & m_index_mask;
+
+            m_index[ slot ] = i;
+        }
+    }
+
+    // add a string if it's not in the table yet
+    NOINLINE handle_t add( str_view_t str, hash32_t hash, bool copy ) {
+        if( ( m_entries.size() + 1 ) * 2 > m_index.size() )
+            grow_index();
+
+        const auto slot = find_slot( str, hash );
+        if( m_index[ slot ] != INVALID_HANDLE )
+            return m_index[ slot ];
+
+        const auto handle = (handle_t)m_entries.size();
+
+        m_entries.push_back( Entry{ hash, copy ? store( str ) : str } );
+        m_index[ slot ] = handle;
+
+        return handle;
+    }
+
+public:
+    StringTable( bool fold = false ) : m_fold{ fold }, m_blocks{}, m_block_used{ 0 }, m_block_size{ 0 }, m_entries{}, m_index{}, m_index_mask{ 0 } {
+
+    }
+
+    // views point into our blocks, moves keep them in place but copies wouldn't
+    StringTable( const StringTable & )             = delete;
+    StringTable &operator =( const StringTable & ) = delete;
+
+    StringTable( StringTable && )             = default;
+    StringTable &operator =( StringTable && ) = default;
+
+    // add a string if it's not in the table yet, returns its handle
+    // note: hash must be made the same way the table does it (folded or not)
+    FORCEINLINE handle_t intern( str_view_t str, hash32_t hash ) {
+        return add( str, hash, true );
+    }
+
+    FORCEINLINE handle_t intern( str_view_t str ) {
+        return add( str, make_hash( str ), true );
+    }
+
+    // same as intern(), but new strings aren't copied, the table keeps the view
+    // the string must outlive the table, folding tables always copy
+    FORCEINLINE handle_t intern_ref( str_view_t str, hash32_t hash ) {
+        return add( str, hash, m_fold );
+    }
+
+    FORCEINLINE handle_t intern_ref( str_view_t str ) {
+        return add( str, make_hash( str ), m_fold );
+    }
+
+    // find a string without adding it, INVALID_HANDLE if it's not in the table
+    FORCEINLINE handle_t find( str_view_t str, hash32_t hash ) const {
+        if( m_index.empty() )
+            return INVALID_HANDLE;
+
+        return m_index[ find_slot( str, hash ) ];
+    }
+
+    FORCEINLINE handle_t find( str_view_t str ) const {
+        return find( str, make_hash( str ) );
+    }
+
+    // returns interned string
+    // note: copied strings are null terminated, referenced ones are whatever they were
+    FORCEINLINE str_view_t get( handle_t handle ) const {
+        return m_entries[ handle ].m_str;
+    }
+
+    // returns hash of an interned string
+    FORCEINLINE hash32_t get_hash( handle_t handle ) const {
+        return m_entries[ handle ].m_hash;
+    }
+
+    // amount of strings
+    FORCEINLINE size_t size() const {
+        return m_entries.size();
+    }
+
+    // remove all strings, every handle and view is invalid after this
+    FORCEINLINE void clear() {
+        m_blocks.clear();
+        m_entries.clear();
+        m_index.clear();
+
+        m_block_used = 0;
+        m_block_size = 0;
+        m_index_mask = 0;
+    }
+};
\ No newline at end of file
@@ -0,0 +1,348 @@
+#include "text_decode.h"
+
+namespace TextDecode {
+
+    //
+    // helpers
+    //
+
+    // decode a single UTF-8 sequence, advances cur
+    // invalid / overlong / truncated sequences return REPLACEMENT_CHAR and skip one byte
+    static NOINLINE uint32_t read_utf8( const uint8_t *&cur, const uint8_t *end ) {
+        const auto lead = *cur;
+
+        size_t   len;
+        uint32_t cp, min;
+
+        if( lead < 0x80 ) {
+            ++cur;
+
+            return lead;
+        }
+
+        else if( ( lead & 0xE0 ) == 0xC0 ) {
+            len = 2;
+            cp  = lead & 0x1F;
+            min = 0x80;
+        }
+
+        else if( ( lead & 0xF0 ) == 0xE0 ) {
+            len = 3;
+            cp  = lead & 0x0F;
+            min = 0x800;
+        }
+
+        else if( ( lead & 0xF8 ) == 0xF0 ) {
+            len = 4;
+            cp  = lead & 0x07;
+            min = 0x10000;
+        }
+
+        else {
+            ++cur;
+
+            return REPLACEMENT_CHAR;
+        }
+
+        if( (size_t)( end - cur ) < len ) {
+            ++cur;
+
+            return REPLACEMENT_CHAR;
+        }
+
+        for( size_t i = 1; i < len; ++i ) {
+            const auto c = cur[ i ];
+            if( ( c & 0xC0 ) != 0x80 ) {
+                ++cur;
+
+                return REPLACEMENT_CHAR;
+            }
+
+            cp = ( cp << 6 ) | ( c & 0x3F );
+        }
+
+        // overlong, surrogate or out of range
+        if( cp < min || ( cp >= 0xD800 && cp <= 0xDFFF ) || cp > 0x10FFFF ) {
+            ++cur;
+
+            return REPLACEMENT_CHAR;
+        }
+
+        cur += len;
+
+        return cp;
+    }
+
+    // read a UTF-16 code unit
+    static FORCEINLINE uint16_t read_unit( const uint8_t *data, bool big_endian ) {
+        return big_endian ? (uint16_t)( ( data[ 0 ] << 8 ) | data[ 1 ] ) : (uint16_t)( data[ 0 ] | ( data[ 1 ] << 8 ) );
+    }
+
+    // write a code point as UTF-16, returns new end
+    static FORCEINLINE wchar_t *write_utf16( uint32_t cp, wchar_t *dst ) {
+        if( cp < 0x10000 ) {
+            *dst++ = (wchar_t)cp;
+
+            return dst;
+        }
+
+        cp -= 0x10000;
+
+        *dst++ = (wchar_t)( 0xD800 | ( cp >> 10 ) );
+        *dst++ = (wchar_t)( 0xDC00 | ( cp & 0x3FF ) );
+
+        return dst;
+    }
+
+    // write a code point as UTF-8, returns new end
+    static FORCEINLINE char *write_utf8( uint32_t cp, char *dst ) {
+        if( cp < 0x80 ) {
+            *dst++ = (char)cp;
+        }
+
+        else if( cp < 0x800 ) {
+            *dst++ = (char)( 0xC0 | ( cp >> 6 ) );
+            *dst++ = (char)( 0x80 | ( cp & 0x3F ) );
+        }
+
+        else if( cp < 0x10000 ) {
+            *dst++ = (char)( 0xE0 | ( cp >> 12 ) );
+            *dst++ = (char)( 0x80 | ( ( cp >> 6 ) & 0x3F ) );
+            *dst++ = (char)( 0x80 | ( cp & 0x3F ) );
+        }
+
+        else {
+            *dst++ = (char)( 0xF0 | ( cp >> 18 ) );
+            *dst++ = (char)( 0x80 | ( ( cp >> 12 ) & 0x3F ) );
+            *dst++ = (char)( 0x80 | ( ( cp >> 6 ) & 0x3F ) );
+            *dst++ = (char)( 0x80 | ( cp & 0x3F ) );
+        }
+
+        return dst;
+    }
+
+    // write a code point as UTF-16 units in the given byte order
+    static FORCEINLINE void write_utf16_bytes( uint32_t cp, bool big_endian, std::vector< uint8_t > &out ) {
+        const auto put = [ & ]( uint32_t unit ) {
+            if( big_endian ) {
+                out.push_back( (uint8_t)( unit >> 8 ) );
+                out.push_back( (uint8_t)unit );
+            }
+
+            else {
+                out.push_back( (uint8_t)unit );
+                out.push_back( (uint8_t)( unit >> 8 ) );
+            }
+        };
+
+        if( cp < 0x10000 ) {
+            put( cp );
+
+            return;
+        }
+
+        cp -= 0x10000;
+
+        put( 0xD800 | ( cp >> 10 ) );
+        put( 0xDC00 | ( cp & 0x3FF ) );
+    }
+
+    // decode a UTF-16 code point, advances cur
+    // unpaired surrogates return REPLACEMENT_CHAR
+    static FORCEINLINE uint32_t read_utf16( const uint8_t *&cur, const uint8_t *end, bool big_endian ) {
+        const uint32_t hi = read_unit( cur, big_endian );
+
+        cur += 2;
+
+        if( hi < 0xD800 || hi > 0xDFFF )
+            return hi;
+
+        if( hi > 0xDBFF || end - cur < 2 )
+            return REPLACEMENT_CHAR;
+
+        const uint32_t lo = read_unit( cur, big_endian );
+        if( lo < 0xDC00 || lo > 0xDFFF )
+            return REPLACEMENT_CHAR;
+
+        cur += 2;
+
+        return 0x10000 + ( ( hi - 0xD800 ) << 10 ) + ( lo - 0xDC00 );
+    }
+
+    //
+    // funcs
+    //
+
+    NOINLINE Detected detect( const uint8_t *data, size_t size ) {
+        if( size >= 3 && data[ 0 ] == 0xEF && data[ 1 ] == 0xBB && data[ 2 ] == 0xBF )
+            return { ENC_UTF8, 3 };
+
+        if( size >= 2 && data[ 0 ] == 0xFF && data[ 1 ] == 0xFE )
+            return { ENC_UTF16LE, 2 };
+
+        if( size >= 2 && data[ 0 ] == 0xFE && data[ 1 ] == 0xFF )
+            return { ENC_UTF16BE, 2 };
+
+        // no BOM, an ASCII char in UTF-16 has a zero byte
+        if( size >= 2 && data[ 0 ] && !data[ 1 ] )
+            return { ENC_UTF16LE, 0 };
+
+        if( size >= 2 && !data[ 0 ] && data[ 1 ] )
+            return { ENC_UTF16BE, 0 };
+
+        return { ENC_UTF8, 0 };
+    }
+
+    NOINLINE size_t find_newline( const uint8_t *data, size_t size, Encoding encoding ) {
+        if( encoding == ENC_UTF8 ) {
+            const auto found = (const uint8_t *)std::memchr( data, '\n', size );
+
+            return ( found ) ? (size_t)( found - data ) : size;
+        }
+
+        const auto big_endian = encoding == ENC_UTF16BE;
+
+        for( size_t i = 0; i + 1 < size; i += 2 ) {
+            if( read_unit( data + i, big_endian ) == '\n' )
+                return i;
+        }
+
+        return size;
+    }
+
+    NOINLINE void decode( const uint8_t *data, size_t size, Encoding encoding, std::vector< wchar_t > &out ) {
+        const auto start = out.size();
+        const auto end   = data + size;
+
+        auto cur = data;
+
+        // UTF-16 to UTF-16, at most one unit per 2 bytes
+        if( encoding != ENC_UTF8 ) {
+            const auto big_endian = encoding == ENC_UTF16BE;
+
+            out.resize( start + size / 2 + 1 );
+
+            auto dst = out.data() + start;
+
+            // same layout as wchar_t, copy as-is
+            if( sizeof( wchar_t ) == 2 && !big_endian ) {
+                std::memcpy( dst, data, size & ~(size_t)1 );
+
+                dst += size / 2;
+            }
+
+            else {
+                for( ; end - cur >= 2; cur += 2 )
+                    *dst++ = (wchar_t)read_unit( cur, big_endian );
+            }
+
+            out.resize( (size_t)( dst - out.data() ) );
+
+            return;
+        }
+
+        // UTF-8 to UTF-16, never more units than bytes
+        out.resize( start + size );
+
+        auto dst = out.data() + start;
+
+        while( cur < end ) {
+            // ASCII fast path, widen 16 bytes at a time
+            if constexpr( sizeof( wchar_t ) == 2 ) {
+                const auto zero = _mm_setzero_si128();
+
+                while( end - cur >= 16 ) {
+                    const auto block = _mm_loadu_si128( (const __m128i *)cur );
+                    if( _mm_movemask_epi8( block ) )
+                        break;
+
+                    _mm_storeu_si128( (__m128i *)dst, _mm_unpacklo_epi8( block, zero ) );
+                    _mm_storeu_si128( (__m128i *)( dst + 8 ), _mm_unpackhi_epi8( block, zero ) );
+
+                    cur += 16;
+                    dst += 16;
+                }
+
+                if( cur >= end )
+                    break;
+            }
+
+            dst = write_utf16( read_utf8( cur, end ), dst );
+        }
+
+        out.resize( (size_t)( dst - out.data() ) );
+    }
+
+    NOINLINE void decode( const uint8_t *data, size_t size, Encoding encoding, std::vector< char > &out ) {
+        const auto start = out.size();
+        const auto end   = data + size;
+
+        auto cur = data;
+
+        // already UTF-8, no widening needed
+        if( encoding == ENC_UTF8 ) {
+            out.insert( out.end(), (const char *)data, (const char *)end );
+
+            return;
+        }
+
+        // UTF-16 to UTF-8, at most 3 bytes per 2-byte unit (surrogate pairs are 4 bytes per 4)
+        const auto big_endian = encoding == ENC_UTF16BE;
+
+        out.resize( start + ( size / 2 ) * 3 );
+
+        auto dst = out.data() + start;
+
+        while( end - cur >= 2 )
+            dst = write_utf8( read_utf16( cur, end, big_endian ), dst );
+
+        out.resize( (size_t)( dst - out.data() ) );
+    }
+
+    NOINLINE void encode( std::wstring_view str, Encoding encoding, std::vector< uint8_t > &out ) {
+        std::array< char, 4 > utf8;
+
+        for( size_t i = 0; i < str.size(); ++i ) {
+            uint32_t cp = (uint32_t)str[ i ];
+
+            // join surrogate pairs
+            if( sizeof( wchar_t ) == 2 && cp >= 0xD800 && cp <= 0xDBFF && i + 1 < str.size() ) {
+                const auto lo = (uint32_t)str[ i + 1 ];
+                if( lo >= 0xDC00 && lo <= 0xDFFF ) {
+                    cp = 0x10000 + ( ( cp - 0xD800 ) << 10 ) + ( lo - 0xDC00 );
+
+                    ++i;
+                }
+            }
+
+            // unpaired surrogate
+            if( cp >= 0xD800 && cp <= 0xDFFF )
+                cp = REPLACEMENT_CHAR;
+
+            if( encoding == ENC_UTF8 ) {
+                const auto end = write_utf8( cp, utf8.data() );
+
+                out.insert( out.end(), (const uint8_t *)utf8.data(), (const uint8_t *)end );
+            }
+
+            else
+                write_utf16_bytes( cp, encoding == ENC_UTF16BE, out );
+        }
+    }
+
+    NOINLINE void encode( std::string_view str, Encoding encoding, std::vector< uint8_t > &out ) {
+        const auto data = (const uint8_t *)str.data();
+        const auto end  = data + str.size();
+
+        // already UTF-8
+        if( encoding == ENC_UTF8 ) {
+            out.insert( out.end(), data, end );
+
+            return;
+        }
+
+        for( auto cur = data; cur < end; )
+            write_utf16_bytes( read_utf8( cur, end ), encoding == ENC_UTF16BE, out );
+    }
+
+} // namespace TextDecode
\ No newline at end of file
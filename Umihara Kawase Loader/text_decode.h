@@ -0,0 +1,53 @@
+#pragma once
+
+#include "includes.h"
+
+//
+// text file decoding
+// detects the encoding (BOM or a guess), then converts to the parser's code units in bulk
+// pure ASCII runs are widened 16 bytes at a time with SSE2
+//
+
+namespace TextDecode {
+
+    enum Encoding : uint8_t {
+        ENC_UTF8 = 0, // also plain ASCII
+        ENC_UTF16LE,
+        ENC_UTF16BE
+    };
+
+    class Detected {
+    public:
+        Encoding m_encoding;
+        size_t   m_bom_size;  // bytes to skip
+    };
+
+    // replacement character for invalid sequences
+    constexpr uint32_t REPLACEMENT_CHAR = 0xFFFD;
+
+    //
+    // funcs in source file
+    //
+
+    // detect encoding of a buffer
+    // without a BOM, a zero byte in the first code unit means UTF-16, everything else is treated as UTF-8
+    extern NOINLINE Detected detect( const uint8_t *data, size_t size );
+
+    // returns byte offset of the next '\n' code unit, or size if there's none
+    extern NOINLINE size_t find_newline( const uint8_t *data, size_t size, Encoding encoding );
+
+    // decode and append to out
+    // wide output is UTF-16, narrow output is UTF-8 (copied as-is if the input is UTF-8 already)
+    extern NOINLINE void decode( const uint8_t *data, size_t size, Encoding encoding, std::vector< wchar_t > &out );
+    extern NOINLINE void decode( const uint8_t *data, size_t size, Encoding encoding, std::vector< char > &out );
+
+    // encode and append to out, the reverse of decode
+    extern NOINLINE void encode( std::wstring_view str, Encoding encoding, std::vector< uint8_t > &out );
+    extern NOINLINE void encode( std::string_view str, Encoding encoding, std::vector< uint8_t > &out );
+
+    // size of a code unit in bytes
+    FORCEINLINE size_t get_unit_size( Encoding encoding ) {
+        return ( encoding == ENC_UTF8 ) ? 1 : 2;
+    }
+
+} // namespace TextDecode
@@ -30,4 +30,16 @@ namespace Utils {
         return true;
     }
 
+    NOINLINE bool get_file_info( const std_fs::path &file, uint64_t &out_write_time, uint64_t &out_size ) {
+        WIN32_FILE_ATTRIBUTE_DATA data;
+
+        if( !GetFileAttributesExW( file.c_str(), GetFileExInfoStandard, &data ) )
+            return false;
+
+        out_write_time = ( (uint64_t)data.ftLastWriteTime.dwHighDateTime << 32 ) | data.ftLastWriteTime.dwLowDateTime;
+        out_size       = ( (uint64_t)data.nFileSizeHigh << 32 ) | data.nFileSizeLow;
+
+        return true;
+    }
+
 } // namespace Utils
\ No newline at end of file
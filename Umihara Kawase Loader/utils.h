@@ -33,4 +33,7 @@ namespace Utils {
     // get executable image file headers
     extern NOINLINE bool get_pe_file_headers( uintptr_t base, PIMAGE_DOS_HEADER &out_dos, PIMAGE_NT_HEADERS &out_nt );
 
+    // get file last write time and size without opening it
+    extern NOINLINE bool get_file_info( const std_fs::path &file, uint64_t &out_write_time, uint64_t &out_size );
+
 } // namespace Utils
\ No newline at end of file
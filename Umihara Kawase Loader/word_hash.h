@@ -0,0 +1,275 @@
+#pragma once
+
+#include "hash.h"
+
+//
+// helper macro for compile-time word hashes of a string_view / wstring_view
+//
+
+#define CT_WORD_HASH_64( str )                           \
+    []() {                                               \
+        constexpr auto out = WordHash::ct_get_64( str ); \
+                                                         \
+        return out;                                      \
+    }()
+
+//
+// word-at-a-time hash (wyhash style)
+// reads 8 bytes per step instead of 1, much faster than FNV-1a on anything longer than a few bytes
+// not cryptographic, don't use it on anything where collisions can be forced
+//
+// wide strings are hashed as their UTF-16LE bytes, same as on disk
+//
+
+namespace WordHash {
+
+    namespace T {
+
+        //
+        // constants
+        //
+
+        constexpr uint64_t SECRET_0 = 0xA0761D6478BD642F;
+        constexpr uint64_t SECRET_1 = 0xE7037ED1A0B428DB;
+        constexpr uint64_t SECRET_2 = 0x8EBC6AF09C88C6E3;
+        constexpr uint64_t SECRET_3 = 0x589965CC75374CC3;
+
+        constexpr uint64_t DEFAULT_SEED = 0;
+
+        //
+        // byte readers, the same hash code runs on top of each
+        //
+
+        // narrow string, usable at compile time
+        class StrReader {
+        private:
+            const char *m_data;
+
+        public:
+            FORCEINLINE constexpr StrReader( const char *data ) : m_data{ data } {
+
+            }
+
+            FORCEINLINE constexpr uint64_t get_byte( size_t i ) const {
+                return (uint8_t)m_data[ i ];
+            }
+
+            FORCEINLINE constexpr uint64_t get_4( size_t i ) const {
+                return get_byte( i ) | ( get_byte( i + 1 ) << 8 ) | ( get_byte( i + 2 ) << 16 ) | ( get_byte( i + 3 ) << 24 );
+            }
+
+            FORCEINLINE constexpr uint64_t get_8( size_t i ) const {
+                return get_4( i ) | ( get_4( i + 4 ) << 32 );
+            }
+        };
+
+        // wide string as UTF-16LE bytes, usable at compile time
+        class WStrReader {
+        private:
+            const wchar_t *m_data;
+
+        public:
+            FORCEINLINE constexpr WStrReader( const wchar_t *data ) : m_data{ data } {
+
+            }
+
+            FORCEINLINE constexpr uint64_t get_byte( size_t i ) const {
+                return ( (uint16_t)m_data[ i / 2 ] >> ( ( i & 1 ) * 8 ) ) & 0xFF;
+            }
+
+            FORCEINLINE constexpr uint64_t get_4( size_t i ) const {
+                return get_byte( i ) | ( get_byte( i + 1 ) << 8 ) | ( get_byte( i + 2 ) << 16 ) | ( get_byte( i + 3 ) << 24 );
+            }
+
+            FORCEINLINE constexpr uint64_t get_8( size_t i ) const {
+                return get_4( i ) | ( get_4( i + 4 ) << 32 );
+            }
+        };
+
+        // raw memory, run-time only
+        // note: x86 is little-endian, so this matches the readers above
+        class MemReader {
+        private:
+            const uint8_t *m_data;
+
+        public:
+            FORCEINLINE MemReader( const uint8_t *data ) : m_data{ data } {
+
+            }
+
+            FORCEINLINE uint64_t get_byte( size_t i ) const {
+                return m_data[ i ];
+            }
+
+            FORCEINLINE uint64_t get_4( size_t i ) const {
+                uint32_t out;
+
+                std::memcpy( &out, m_data + i, sizeof( out ) );
+
+                return out;
+            }
+
+            FORCEINLINE uint64_t get_8( size_t i ) const {
+                uint64_t out;
+
+                std::memcpy( &out, m_data + i, sizeof( out ) );
+
+                return out;
+            }
+        };
+
+        //
+        // hash core
+        //
+
+        // 64x64 -> 128-bit multiply, returns low / high halves
+        // note: done in 32-bit halves so it works at compile time and on x86
+        FORCEINLINE constexpr void mul_128( uint64_t &a, uint64_t &b ) {
+            const auto a_lo = a & 0xFFFFFFFF;
+            const auto a_hi = a >> 32;
+            const auto b_lo = b & 0xFFFFFFFF;
+            const auto b_hi = b >> 32;
+
+            const auto lo_lo = a_lo * b_lo;
+            const auto hi_lo = a_hi * b_lo;
+            const auto lo_hi = a_lo * b_hi;
+            const auto hi_hi = a_hi * b_hi;
+
+            const auto cross = ( lo_lo >> 32 ) + ( hi_lo & 0xFFFFFFFF ) + lo_hi;
+
+            a = ( cross << 32 ) | ( lo_lo & 0xFFFFFFFF );
+            b = ( hi_lo >> 32 ) + ( cross >> 32 ) + hi_hi;
+        }
+
+        // multiply and fold
+        FORCEINLINE constexpr uint64_t mix( uint64_t a, uint64_t b ) {
+            mul_128( a, b );
+
+            return a ^ b;
+        }
+
+        template< typename reader_t > FORCEINLINE constexpr uint64_t hash( const reader_t &reader, size_t len, uint64_t seed ) {
+            uint64_t a = 0;
+            uint64_t b = 0;
+
+            seed ^= mix( seed ^ SECRET_0, SECRET_1 );
+
+            // short input, 2 overlapping reads at most
+            if( len <= 16 ) {
+                if( len >= 4 ) {
+                    const auto step = ( len >> 3 ) << 2;
+
+                    a = ( reader.get_4( 0 ) << 32 ) | reader.get_4( step );
+                    b = ( reader.get_4( len - 4 ) << 32 ) | reader.get_4( len - 4 - step );
+                }
+
+                else if( len > 0 )
+                    a = ( reader.get_byte( 0 ) << 16 ) | ( reader.get_byte( len >> 1 ) << 8 ) | reader.get_byte( len - 1 );
+            }
+
+            else {
+                size_t pos = 0;
+                size_t i   = len;
+
+                // 3 independent lanes
+                if( i > 48 ) {
+                    auto seed_1 = seed;
+                    auto seed_2 = seed;
+
+                    do {
+                        seed   = mix( reader.get_8( pos      ) ^ SECRET_1, reader.get_8( pos + 8  ) ^ seed   );
+                        seed_1 = mix( reader.get_8( pos + 16 ) ^ SECRET_2, reader.get_8( pos + 24 ) ^ seed_1 );
+                        seed_2 = mix( reader.get_8( pos + 32 ) ^ SECRET_3, reader.get_8( pos + 40 ) ^ seed_2 );
+
+                        pos += 48;
+                        i   -= 48;
+                    } while( i > 48 );
+
+                    seed ^= seed_1 ^ seed_2;
+                }
+
+                while( i > 16 ) {
+                    seed = mix( reader.get_8( pos ) ^ SECRET_1, reader.get_8( pos + 8 ) ^ seed );
+
+                    pos += 16;
+                    i   -= 16;
+                }
+
+                // last 16 bytes, may overlap the previous block
+                a = reader.get_8( pos + i - 16 );
+                b = reader.get_8( pos + i - 8 );
+            }
+
+            a ^= SECRET_1;
+            b ^= seed;
+
+            mul_128( a, b );
+
+            return mix( a ^ SECRET_0 ^ len, b ^ SECRET_1 );
+        }
+
+    } // namespace T
+
+    //
+    // compile-time hashing
+    //
+
+    FORCEINLINE constexpr hash64_t ct_get_64( std::string_view str, uint64_t seed = T::DEFAULT_SEED ) {
+        return T::hash( T::StrReader( str.data() ), str.size(), seed );
+    }
+
+    FORCEINLINE constexpr hash64_t ct_get_64( std::wstring_view wstr, uint64_t seed = T::DEFAULT_SEED ) {
+        return T::hash( T::WStrReader( wstr.data() ), wstr.size() * 2, seed );
+    }
+
+    //
+    // run-time hashing
+    //
+
+    FORCEINLINE hash64_t get_64( const uint8_t *data, size_t len, uint64_t seed = T::DEFAULT_SEED ) {
+        return T::hash( T::MemReader( data ), len, seed );
+    }
+
+    FORCEINLINE hash64_t get_64( std::string_view str, uint64_t seed = T::DEFAULT_SEED ) {
+        return get_64( (const uint8_t *)str.data(), str.size(), seed );
+    }
+
+    // note: wchar_t is only 2 bytes on windows, elsewhere it's read as UTF-16LE like ct_get_64
+    FORCEINLINE hash64_t get_64( std::wstring_view wstr, uint64_t seed = T::DEFAULT_SEED ) {
+        if constexpr( sizeof( wchar_t ) == 2 )
+            return get_64( (const uint8_t *)wstr.data(), wstr.size() * sizeof( wchar_t ), seed );
+
+        else
+            return ct_get_64( wstr, seed );
+    }
+
+    //
+    // hasher type, see FNV1aHash::Hasher32
+    //
+
+    class Hasher64 {
+    public:
+        using hash_t = hash64_t;
+
+        static FORCEINLINE constexpr hash_t ct_get( std::string_view str ) {
+            return ct_get_64( str );
+        }
+
+        static FORCEINLINE constexpr hash_t ct_get( std::wstring_view wstr ) {
+            return ct_get_64( wstr );
+        }
+
+        static FORCEINLINE hash_t get( const uint8_t *data, size_t len ) {
+            return get_64( data, len );
+        }
+
+        static FORCEINLINE hash_t get( std::string_view str ) {
+            return get_64( str );
+        }
+
+        static FORCEINLINE hash_t get( std::wstring_view wstr ) {
+            return get_64( wstr );
+        }
+    };
+
+} // namespace WordHash
\ No newline at end of file
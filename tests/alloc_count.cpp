@@ -0,0 +1,138 @@
+#include "alloc_count.h"
+
+#include <cstdlib>
+#include <new>
+
+namespace AllocCount {
+
+    // every block has its size and the offset to its start right in front of it
+    // the offset is at least alignof( std::max_align_t ), more for over-aligned blocks
+    static constexpr size_t HEADER_SIZE = alignof( std::max_align_t );
+
+    static std::atomic< size_t > g_allocs{ 0 };
+    static std::atomic< size_t > g_bytes{ 0 };
+    static std::atomic< size_t > g_live_bytes{ 0 };
+    static std::atomic< size_t > g_peak_bytes{ 0 };
+    static std::atomic< size_t > g_base_bytes{ 0 };
+
+    static void *allocate( size_t size, size_t align = HEADER_SIZE ) {
+        const auto header = std::max( HEADER_SIZE, align );
+
+        // aligned_alloc wants a multiple of the alignment
+        const auto block = (uint8_t *)std::aligned_alloc( header, ( header + size + header - 1 ) / header * header );
+        if( !block )
+            return nullptr;
+
+        const auto out = block + header;
+
+        ( (size_t *)out )[ -1 ] = size;
+        ( (size_t *)out )[ -2 ] = header;
+
+        g_allocs.fetch_add( 1, std::memory_order_relaxed );
+        g_bytes.fetch_add( size, std::memory_order_relaxed );
+
+        const auto live = g_live_bytes.fetch_add( size, std::memory_order_relaxed ) + size;
+
+        auto peak = g_peak_bytes.load( std::memory_order_relaxed );
+
+        while( live > peak && !g_peak_bytes.compare_exchange_weak( peak, live, std::memory_order_relaxed ) ) {
+
+        }
+
+        return out;
+    }
+
+    static void deallocate( void *ptr ) {
+        if( !ptr )
+            return;
+
+        g_live_bytes.fetch_sub( ( (size_t *)ptr )[ -1 ], std::memory_order_relaxed );
+
+        std::free( (uint8_t *)ptr - ( (size_t *)ptr )[ -2 ] );
+    }
+
+    Counts get() {
+        const auto peak = g_peak_bytes.load( std::memory_order_relaxed );
+        const auto base = g_base_bytes.load( std::memory_order_relaxed );
+
+        return Counts{ g_allocs.load( std::memory_order_relaxed ), g_bytes.load( std::memory_order_relaxed ), ( peak > base ) ? peak - base : 0 };
+    }
+
+    void reset() {
+        const auto live = g_live_bytes.load( std::memory_order_relaxed );
+
+        g_allocs.store( 0, std::memory_order_relaxed );
+        g_bytes.store( 0, std::memory_order_relaxed );
+        g_peak_bytes.store( live, std::memory_order_relaxed );
+        g_base_bytes.store( live, std::memory_order_relaxed );
+    }
+
+} // namespace AllocCount
+
+//
+// global replacements
+//
+
+void *operator new( size_t size ) {
+    const auto out = AllocCount::allocate( size );
+    if( !out )
+        std::abort();
+
+    return out;
+}
+
+void *operator new[]( size_t size ) {
+    return operator new( size );
+}
+
+void *operator new( size_t size, std::align_val_t align ) {
+    const auto out = AllocCount::allocate( size, (size_t)align );
+    if( !out )
+        std::abort();
+
+    return out;
+}
+
+void *operator new[]( size_t size, std::align_val_t align ) {
+    return operator new( size, align );
+}
+
+void *operator new( size_t size, const std::nothrow_t & ) noexcept {
+    return AllocCount::allocate( size );
+}
+
+void *operator new[]( size_t size, const std::nothrow_t & ) noexcept {
+    return AllocCount::allocate( size );
+}
+
+void operator delete( void *ptr ) noexcept {
+    AllocCount::deallocate( ptr );
+}
+
+void operator delete[]( void *ptr ) noexcept {
+    AllocCount::deallocate( ptr );
+}
+
+void operator delete( void *ptr, size_t ) noexcept {
+    AllocCount::deallocate( ptr );
+}
+
+void operator delete[]( void *ptr, size_t ) noexcept {
+    AllocCount::deallocate( ptr );
+}
+
+void operator delete( void *ptr, std::align_val_t ) noexcept {
+    AllocCount::deallocate( ptr );
+}
+
+void operator delete[]( void *ptr, std::align_val_t ) noexcept {
+    AllocCount::deallocate( ptr );
+}
+
+void operator delete( void *ptr, size_t, std::align_val_t ) noexcept {
+    AllocCount::deallocate( ptr );
+}
+
+void operator delete[]( void *ptr, size_t, std::align_val_t ) noexcept {
+    AllocCount::deallocate( ptr );
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include "includes.h"
+
+//
+// counts heap allocations made through operator new
+// only linked into tests that list alloc_count.cpp, it replaces the global operator new / delete (aligned ones too)
+//
+
+namespace AllocCount {
+
+    class Counts {
+    public:
+        size_t m_allocs;     // operator new calls
+        size_t m_bytes;      // bytes asked for
+        size_t m_peak_bytes; // most bytes live at once
+    };
+
+    // counts since the last reset
+    extern Counts get();
+
+    // start counting from zero, live bytes are kept so peaks stay relative to now
+    extern void reset();
+
+} // namespace AllocCount
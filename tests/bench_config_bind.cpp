@@ -0,0 +1,147 @@
+#include "test.h"
+#include "old_ini_parser.h"
+#include "ini_reader.h"
+
+//
+// loading the loader settings: schema bind over the streaming reader vs the getter path init_ini used before the schema
+// the old path parses the whole file with the old parser, then looks up every setting by name
+//
+
+// shipped config.ini with the keybinds turned on, so both paths read every value
+static std_fs::path write_config() {
+    const auto path = std_fs::temp_directory_path() / "umi_bench_config_bind.ini";
+
+    std::wifstream in( std_fs::path( UMI_CONFIG_INI ), std::ios::binary );
+    std::wstring   text( ( std::istreambuf_iterator< wchar_t >( in ) ), std::istreambuf_iterator< wchar_t >() );
+
+    const auto pos = text.find( L"rebind_keys = false" );
+
+    CHECK( pos != std::wstring::npos );
+
+    if( pos != std::wstring::npos )
+        text.replace( pos, 19, L"rebind_keys = true" );
+
+    std::wofstream( path, std::ios::binary ) << text;
+
+    return path;
+}
+
+// old getters had no text bools, "true" / "false" were compared as is
+static bool old_get_bool( const OldINI::Parser &ini, std::wstring_view section, std::wstring_view name, bool default_value ) {
+    const auto info = ini.get_value_info( section, name );
+    if( !info )
+        return default_value;
+
+    return info->m_value == L"true" || info->m_value == L"1";
+}
+
+// getter path, one lookup per schema field, keybinds are single keys
+static bool old_load( const std_fs::path &path, Config::Settings &out ) {
+    OldINI::Parser ini;
+
+    if( !ini.init( path ) )
+        return false;
+
+    const auto base = (uint8_t *)&out;
+
+    for( const auto &f : Config::SCHEMA ) {
+        switch( f.m_type ) {
+            case Config::FIELD_BOOL: {
+                *(bool *)( base + f.m_offset ) = old_get_bool( ini, f.m_section, f.m_name, f.m_default != 0 );
+
+                break;
+            }
+
+            case Config::FIELD_UINT32: {
+                *(uint32_t *)( base + f.m_offset ) = ini.get_value< uint32_t >( f.m_section, f.m_name, f.m_default );
+
+                break;
+            }
+
+            case Config::FIELD_KEYBIND: {
+                auto &keybind = *(Config::Keybind *)( base + f.m_offset );
+
+                keybind                           = {};
+                keybind.m_chords[ 0 ].m_keys[ 0 ] = (uint8_t)ini.get_value< uint32_t >( f.m_section, f.m_name, f.m_default );
+                keybind.m_chords[ 0 ].m_size      = 1;
+                keybind.m_size                    = 1;
+
+                break;
+            }
+
+            default: {
+                break;
+            }
+        }
+    }
+
+    return true;
+}
+
+static bool new_load( const std_fs::path &path, Config::Settings &out ) {
+    auto reader = INIReader( path.wstring() );
+    if( !reader.is_open() )
+        return false;
+
+    const auto result = Config::bind( reader, 0, out );
+
+    return !reader.has_error() && !result.m_unknown && !result.m_duplicate && !result.m_invalid;
+}
+
+// same values either way
+static void test_same( const std_fs::path &path ) {
+    Config::Settings old_settings{}, settings{};
+
+    CHECK( old_load( path, old_settings ) );
+    CHECK( new_load( path, settings ) );
+
+    CHECK( settings.m_rebind_keys );
+    CHECK( settings.m_rebind_keys == old_settings.m_rebind_keys );
+    CHECK( settings.m_signature_report == old_settings.m_signature_report );
+    CHECK( settings.m_hot_reload == old_settings.m_hot_reload );
+    CHECK( settings.m_record_input == old_settings.m_record_input );
+    CHECK( settings.m_record_raw_input == old_settings.m_record_raw_input );
+    CHECK( settings.m_replay_input == old_settings.m_replay_input );
+    CHECK( settings.m_replay_start_key == old_settings.m_replay_start_key );
+    CHECK( settings.m_replay_start_frame == old_settings.m_replay_start_frame );
+
+    for( size_t i = 0; i < Config::KEYBIND_MAX; ++i ) {
+        const auto &keybind     = settings.m_keybinds[ i ];
+        const auto &old_keybind = old_settings.m_keybinds[ i ];
+
+        CHECK( keybind.m_size == 1 && keybind.m_chords[ 0 ].m_size == 1 );
+        CHECK( keybind.m_chords[ 0 ].m_keys[ 0 ] == old_keybind.m_chords[ 0 ].m_keys[ 0 ] );
+    }
+
+    // the shipped defaults
+    CHECK( settings.m_keybinds[ Config::KEYBIND_JUMP ].m_chords[ 0 ].m_keys[ 0 ] == 0x2C );
+    CHECK( settings.m_key_table[ 0x2C ] == UMI_KEY_JUMP );
+}
+
+static void bench_load( const std_fs::path &path ) {
+    constexpr size_t CALLS = 500;
+
+    Config::Settings settings;
+
+    const auto old_ns = Test::time_ns( CALLS, [ & ]( size_t ) {
+        Test::keep( old_load( path, settings ) );
+    } );
+
+    const auto ns = Test::time_ns( CALLS, [ & ]( size_t ) {
+        Test::keep( new_load( path, settings ) );
+    } );
+
+    Test::report( "config.ini load, old getters", old_ns / 1e3, "us" );
+    Test::report( "config.ini load, schema bind", ns / 1e3, "us" );
+}
+
+int main() {
+    const auto path = write_config();
+
+    test_same( path );
+    bench_load( path );
+
+    std_fs::remove( path );
+
+    return Test::result();
+}
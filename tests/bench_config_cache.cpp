@@ -0,0 +1,126 @@
+#include "test.h"
+#include "ini_reader.h"
+#include "config_cache.h"
+
+//
+// settings cache: cold start (no cache, parse + bind + store) vs warm start (cache hit)
+// also checks when the cache is stale, and that a failed store leaves no temp file behind
+//
+
+static const auto g_dir = std_fs::temp_directory_path() / "umi_bench_config_cache";
+
+static bool parse( const std_fs::path &ini_file, int8_t game_id, Config::Settings &out ) {
+    auto reader = INIReader( ini_file.wstring() );
+    if( !reader.is_open() )
+        return false;
+
+    Config::bind( reader, game_id, out );
+
+    return !reader.has_error();
+}
+
+// what init_ini does
+static bool load( const std_fs::path &ini_file, const std_fs::path &cache_file, Config::Settings &out ) {
+    if( Config::load_cache( ini_file, cache_file, UMI_GAME_KAWASE, out ) )
+        return true;
+
+    return parse( ini_file, UMI_GAME_KAWASE, out ) && Config::store_cache( ini_file, cache_file, UMI_GAME_KAWASE, out );
+}
+
+static void test_cache( const std_fs::path &ini_file, const std_fs::path &cache_file ) {
+    Config::Settings parsed{}, cached{};
+
+    CHECK( !Config::load_cache( ini_file, cache_file, UMI_GAME_KAWASE, cached ) );
+    CHECK( parse( ini_file, UMI_GAME_KAWASE, parsed ) );
+    CHECK( Config::store_cache( ini_file, cache_file, UMI_GAME_KAWASE, parsed ) );
+
+    // same settings back
+    CHECK( Config::load_cache( ini_file, cache_file, UMI_GAME_KAWASE, cached ) );
+    CHECK( std::memcmp( &parsed, &cached, sizeof( parsed ) ) == 0 );
+
+    // overlays are merged per game
+    CHECK( !Config::load_cache( ini_file, cache_file, UMI_GAME_KAWASE_SHUN, cached ) );
+
+    // INI changed
+    std::ofstream( ini_file, std::ios::binary | std::ios::app ) << "; edited\r\n";
+
+    CHECK( !Config::load_cache( ini_file, cache_file, UMI_GAME_KAWASE, cached ) );
+
+    // cache damaged
+    CHECK( parse( ini_file, UMI_GAME_KAWASE, parsed ) );
+    CHECK( Config::store_cache( ini_file, cache_file, UMI_GAME_KAWASE, parsed ) );
+
+    std_fs::resize_file( cache_file, std_fs::file_size( cache_file ) - 1 );
+
+    CHECK( !Config::load_cache( ini_file, cache_file, UMI_GAME_KAWASE, cached ) );
+
+    std_fs::remove( cache_file );
+}
+
+static void test_store_failed( const std_fs::path &ini_file ) {
+    Config::Settings settings{};
+
+    CHECK( parse( ini_file, UMI_GAME_KAWASE, settings ) );
+
+    // can't create the temp file
+    CHECK( !Config::store_cache( ini_file, g_dir / "missing" / "config.cache", UMI_GAME_KAWASE, settings ) );
+
+    // temp file written, but it can't be moved over a directory
+    const auto dir_cache = g_dir / "dir.cache";
+
+    std_fs::create_directories( dir_cache / "sub" );
+
+    CHECK( !Config::store_cache( ini_file, dir_cache, UMI_GAME_KAWASE, settings ) );
+
+    // no temp file left behind either way
+    for( const auto &entry : std_fs::directory_iterator( g_dir ) )
+        CHECK( entry.path().extension() != ".tmp" );
+
+    std_fs::remove_all( dir_cache );
+}
+
+static void bench_load( const std_fs::path &ini_file, const std_fs::path &cache_file ) {
+    constexpr size_t CALLS = 200;
+
+    Config::Settings settings;
+
+    // parse, bind and write the cache
+    const auto cold_ns = Test::time_ns( CALLS, [ & ]( size_t ) {
+        std_fs::remove( cache_file );
+
+        Test::keep( load( ini_file, cache_file, settings ) );
+    } );
+
+    // cache hit
+    CHECK( load( ini_file, cache_file, settings ) );
+
+    const auto warm_ns = Test::time_ns( CALLS, [ & ]( size_t ) {
+        Test::keep( load( ini_file, cache_file, settings ) );
+    } );
+
+    // parse and bind only, what a start without the cache costs
+    const auto parse_ns = Test::time_ns( CALLS, [ & ]( size_t ) {
+        Test::keep( parse( ini_file, UMI_GAME_KAWASE, settings ) );
+    } );
+
+    Test::report( "config.ini load, cold (store cache)", cold_ns / 1e3, "us" );
+    Test::report( "config.ini load, parse + bind", parse_ns / 1e3, "us" );
+    Test::report( "config.ini load, warm (cache hit)", warm_ns / 1e3, "us" );
+}
+
+int main() {
+    const auto ini_file   = g_dir / "config.ini";
+    const auto cache_file = g_dir / "config.cache";
+
+    std_fs::remove_all( g_dir );
+    std_fs::create_directories( g_dir );
+    std_fs::copy_file( UMI_CONFIG_INI, ini_file );
+
+    test_cache( ini_file, cache_file );
+    test_store_failed( ini_file );
+    bench_load( ini_file, cache_file );
+
+    std_fs::remove_all( g_dir );
+
+    return Test::result();
+}
@@ -0,0 +1,212 @@
+#include "test.h"
+
+//
+// hash throughput and quality: FNV-1a 32 / 64 and the word-at-a-time hash
+// checks compile-time and run-time hashes agree, then measures collisions, bucket spread and avalanche
+//
+
+// every run-time hash must match its compile-time version, narrow and wide
+static void test_ct_matches_rt() {
+    std::mt19937 rng( 5 );
+
+    for( size_t len = 0; len < 200; ++len ) {
+        std::string  str( len, '\0' );
+        std::wstring wstr( len, L'\0' );
+
+        for( size_t i = 0; i < len; ++i ) {
+            str[ i ]  = (char)( ' ' + rng() % 95 );
+            wstr[ i ] = (wchar_t)( 1 + rng() % 0xD7FF );
+        }
+
+        CHECK( FNV1aHash::get_32( str ) == FNV1aHash::ct_get_32( str ) );
+        CHECK( FNV1aHash::get_32( wstr ) == FNV1aHash::ct_get_32( wstr ) );
+        CHECK( FNV1aHash::get_32_fold( str ) == FNV1aHash::ct_get_32_fold( str ) );
+        CHECK( FNV1aHash::get_32_fold( wstr ) == FNV1aHash::ct_get_32_fold( wstr ) );
+        CHECK( FNV1aHash::get_64( str ) == FNV1aHash::ct_get_64( str ) );
+        CHECK( FNV1aHash::get_64( wstr ) == FNV1aHash::ct_get_64( wstr ) );
+        CHECK( WordHash::get_64( str ) == WordHash::ct_get_64( str ) );
+        CHECK( WordHash::get_64( wstr ) == WordHash::ct_get_64( wstr ) );
+
+        // folding only touches 'A' - 'Z'
+        std::string lower = str;
+
+        std::transform( lower.begin(), lower.end(), lower.begin(), []( char c ) { return FNV1aHash::fold_ascii( c ); } );
+
+        CHECK( FNV1aHash::get_32_fold( str ) == FNV1aHash::get_32( lower ) );
+    }
+
+    // values baked in at compile time
+    static_assert( CT_HASH_32( "settings" ) == FNV1aHash::ct_get_32( std::string_view( "settings" ) ) );
+
+    CHECK( FNV1aHash::get_32( std::wstring_view( L"settings" ) ) == CT_HASH_32( L"settings" ) );
+    CHECK( WordHash::get_64( std::wstring_view( L"settings" ) ) == CT_WORD_HASH_64( L"settings" ) );
+}
+
+// the hashes under test, all return 64 bits (32-bit ones zero extended)
+static const std::array< std::pair< const char *, uint64_t ( * )( std::string_view ) >, 3 > HASHES = { {
+    { "fnv1a 32", []( std::string_view str ) -> uint64_t { return FNV1aHash::get_32( str ); } },
+    { "fnv1a 64", []( std::string_view str ) -> uint64_t { return FNV1aHash::get_64( str ); } },
+    { "word hash 64", []( std::string_view str ) -> uint64_t { return WordHash::get_64( str ); } }
+} };
+
+static void bench_throughput() {
+    std::mt19937 rng( 6 );
+
+    for( const size_t len : { 8, 16, 32, 64, 256, 4096 } ) {
+        std::string str( len, '\0' );
+
+        for( auto &c : str )
+            c = (char)rng();
+
+        for( const auto &[ name, hash ] : HASHES ) {
+            const auto ns = Test::time_ns( 1000000 / len + 1000, [ &, hash = hash ]( size_t ) {
+                Test::keep( hash( str ) );
+            } );
+
+            const auto label = std::string( name ) + ", " + std::to_string( len ) + " bytes";
+
+            Test::report( label.c_str(), len / ns, "GB/s" );
+        }
+    }
+}
+
+// a million distinct keys of one shape
+static std::vector< std::string > make_keys( bool config_like ) {
+    std::mt19937               rng( 7 );
+    std::vector< std::string > out;
+
+    constexpr size_t AMT = 1000000;
+
+    out.reserve( AMT );
+
+    for( size_t i = 0; i < AMT; ++i ) {
+        // "section12.value34", long shared prefixes, only a few bytes differ
+        if( config_like ) {
+            out.push_back( "section" + std::to_string( i / 1000 ) + ".value" + std::to_string( i % 1000 ) );
+
+            continue;
+        }
+
+        // random bytes, every key is different because the index is in it
+        std::string str( 12, '\0' );
+
+        for( auto &c : str )
+            c = (char)rng();
+
+        std::memcpy( str.data(), &i, sizeof( uint32_t ) );
+
+        out.push_back( std::move( str ) );
+    }
+
+    return out;
+}
+
+static void bench_quality() {
+    for( const auto config_like : { true, false } ) {
+        const auto keys  = make_keys( config_like );
+        const auto shape = config_like ? "config keys" : "random keys";
+
+        // a fair 32-bit hash has about n^2 / 2^33 collisions
+        const auto expected = (double)keys.size() * keys.size() / 8589934592.0;
+
+        for( const auto &[ name, hash ] : HASHES ) {
+            std::vector< uint32_t >       low( keys.size() );
+            std::array< uint32_t, 65536 > buckets{};
+
+            for( size_t i = 0; i < keys.size(); ++i ) {
+                low[ i ] = (uint32_t)hash( keys[ i ] );
+
+                // a power of 2 table uses the low bits
+                ++buckets[ low[ i ] & 0xFFFF ];
+            }
+
+            std::sort( low.begin(), low.end() );
+
+            const auto collisions = (size_t)( low.size() - ( std::unique( low.begin(), low.end() ) - low.begin() ) );
+
+            // chi-square over the buckets, about 65535 for a fair hash
+            const auto per_bucket = (double)keys.size() / buckets.size();
+
+            double chi = 0.0;
+
+            for( const auto b : buckets )
+                chi += ( b - per_bucket ) * ( b - per_bucket ) / per_bucket;
+
+            const auto label = std::string( name ) + ", " + shape + ", ";
+
+            Test::report( ( label + "low 32 collisions" ).c_str(), (double)collisions, "" );
+            Test::report( ( label + "low 16 bucket chi^2" ).c_str(), chi, "" );
+
+            // nothing should be far off, the word hash is held to a fair hash
+            CHECK( collisions < expected * 4 + 20 );
+
+            if( name == std::string_view( "word hash 64" ) )
+                CHECK( chi < 65535 * 1.1 );
+        }
+
+        Test::report( ( std::string( "expected low 32 collisions, " ) + shape ).c_str(), expected, "" );
+    }
+}
+
+// flip each input bit, how many output bits change? 0.5 of them for a good mix
+static void bench_avalanche() {
+    constexpr size_t KEYS = 2000;
+    constexpr size_t LEN  = 16;
+
+    std::mt19937 rng( 8 );
+
+    for( const auto &[ name, hash ] : HASHES ) {
+        const auto out_bits = ( name == std::string_view( "fnv1a 32" ) ) ? 32 : 64;
+
+        // per input bit / output bit flip counts, for the worst bias
+        std::vector< uint32_t > flips( LEN * 8 * out_bits );
+
+        double total = 0.0;
+
+        for( size_t k = 0; k < KEYS; ++k ) {
+            std::string str( LEN, '\0' );
+
+            for( auto &c : str )
+                c = (char)rng();
+
+            const auto base = hash( str );
+
+            for( size_t bit = 0; bit < LEN * 8; ++bit ) {
+                str[ bit / 8 ] ^= (char)( 1 << ( bit % 8 ) );
+
+                const auto diff = base ^ hash( str );
+
+                str[ bit / 8 ] ^= (char)( 1 << ( bit % 8 ) );
+
+                total += std::bitset< 64 >( diff ).count();
+
+                for( int o = 0; o < out_bits; ++o )
+                    flips[ bit * out_bits + o ] += ( diff >> o ) & 1;
+            }
+        }
+
+        const auto average = total / ( KEYS * LEN * 8 * out_bits );
+
+        double worst = 0.0;
+
+        for( const auto f : flips )
+            worst = std::max( worst, std::abs( (double)f / KEYS - 0.5 ) );
+
+        Test::report( ( std::string( name ) + ", avalanche, bits flipped" ).c_str(), average, "" );
+        Test::report( ( std::string( name ) + ", avalanche, worst bit bias" ).c_str(), worst, "" );
+
+        if( name == std::string_view( "word hash 64" ) ) {
+            CHECK( std::abs( average - 0.5 ) < 0.01 );
+            CHECK( worst < 0.1 );
+        }
+    }
+}
+
+int main() {
+    test_ct_matches_rt();
+    bench_throughput();
+    bench_quality();
+    bench_avalanche();
+
+    return Test::result();
+}
@@ -0,0 +1,109 @@
+#include "test.h"
+#include "old_ini_parser.h"
+
+//
+// typed INI getters, values decoded once at parse time vs the old wcsto* call per get
+// also checks the decoded values against the old conversions
+//
+
+static const std::array< const char *, 8 > NAMES = { "Int", "Negative", "Hex", "Octal", "Big", "Double", "Bool", "Text" };
+
+static std_fs::path write_config() {
+    const auto path = std_fs::temp_directory_path() / "umi_bench_ini_getters.ini";
+
+    std::ofstream( path, std::ios::binary ) <<
+        "[Values]\r\n"
+        "Int = 1234\r\n"
+        "Negative = -77\r\n"
+        "Hex = 0x1F\r\n"
+        "Octal = 017\r\n"
+        "Big = 18446744073709551615\r\n"
+        "Double = 2.5\r\n"
+        "Bool = true\r\n"
+        "Text = hello\r\n";
+
+    return path;
+}
+
+static void test_decode( INIParser &ini, const OldINI::Parser &old ) {
+    for( const auto name : NAMES ) {
+        const auto wname = std_fs::path( name ).wstring();
+
+        CHECK( ini.get_value_int32( L"Values", wname, -1 ) == old.get_value< int32_t >( L"Values", wname, -1 ) );
+        CHECK( ini.get_value_uint64( L"Values", wname, 1 ) == old.get_value< uint64_t >( L"Values", wname, 1 ) || name == std::string_view( "Negative" ) );
+        CHECK( ini.get_value_double( L"Values", wname, -1.0 ) == old.get_value< double >( L"Values", wname, -1.0 ) || name == std::string_view( "Octal" ) );
+    }
+
+    // where they differ on purpose
+    // the old conversions wrapped negatives around, decoded values are range checked
+    CHECK( old.get_value< uint64_t >( L"Values", L"Negative", 1 ) == (uint64_t)-77 );
+    CHECK( ini.get_value_uint64( L"Values", L"Negative", 1 ) == 1 );
+
+    // integers read as doubles keep their base, wcstod read "017" as decimal
+    CHECK( old.get_value< double >( L"Values", L"Octal", 0.0 ) == 17.0 );
+    CHECK( ini.get_value_double( L"Values", L"Octal", 0.0 ) == 15.0 );
+
+    CHECK( ini.get_value_bool( L"Values", L"Bool", false ) );
+    CHECK( ini.get_value_str( L"Values", L"Text", L"" ) == L"hello" );
+
+    CHECK( INIParser::parse_uint( L"0x10" ) == 16u );
+    CHECK( INIParser::parse_uint( L"010" ) == 8u );
+    CHECK( !INIParser::parse_uint( L"12a" ) );
+    CHECK( !INIParser::parse_uint( L"18446744073709551616" ) );
+}
+
+static void bench_getters( INIParser &ini, const OldINI::Parser &old ) {
+    constexpr size_t CALLS = 1000000;
+
+    const auto report = [ & ]( const char *what, double old_ns, double new_ns ) {
+        const auto old_name = std::string( what ) + ", convert per get";
+        const auto new_name = std::string( what ) + ", decoded at parse";
+
+        Test::report( old_name.c_str(), old_ns, "ns" );
+        Test::report( new_name.c_str(), new_ns, "ns" );
+    };
+
+    report( "get int32",
+        Test::time_ns( CALLS, [ & ]( size_t ) { Test::keep( old.get_value< int32_t >( L"Values", L"Int", 0 ) ); } ),
+        Test::time_ns( CALLS, [ & ]( size_t ) { Test::keep( ini.get_value_int32( L"Values", L"Int", 0 ) ); } )
+    );
+
+    report( "get uint64, hex",
+        Test::time_ns( CALLS, [ & ]( size_t ) { Test::keep( old.get_value< uint64_t >( L"Values", L"Hex", 0 ) ); } ),
+        Test::time_ns( CALLS, [ & ]( size_t ) { Test::keep( ini.get_value_uint64( L"Values", L"Hex", 0 ) ); } )
+    );
+
+    report( "get double",
+        Test::time_ns( CALLS, [ & ]( size_t ) { Test::keep( old.get_value< double >( L"Values", L"Double", 0.0 ) ); } ),
+        Test::time_ns( CALLS, [ & ]( size_t ) { Test::keep( ini.get_value_double( L"Values", L"Double", 0.0 ) ); } )
+    );
+
+    // no old equivalent
+    const auto bool_ns = Test::time_ns( CALLS, [ & ]( size_t ) {
+        Test::keep( ini.get_value_bool( L"Values", L"Bool", false ) );
+    } );
+
+    const auto parse_uint_ns = Test::time_ns( CALLS, [ & ]( size_t ) {
+        Test::keep( INIParser::parse_uint( L"0x1F" ) );
+    } );
+
+    Test::report( "get bool, decoded at parse", bool_ns, "ns" );
+    Test::report( "parse_uint \"0x1F\"", parse_uint_ns, "ns" );
+}
+
+int main() {
+    const auto path = write_config();
+
+    INIParser      ini( path.wstring() );
+    OldINI::Parser old;
+
+    CHECK( ini.is_valid() );
+    CHECK( old.init( path ) );
+
+    test_decode( ini, old );
+    bench_getters( ini, old );
+
+    std_fs::remove( path );
+
+    return Test::result();
+}
@@ -0,0 +1,115 @@
+#include "test.h"
+#include "old_ini_parser.h"
+
+//
+// INI lookups with thousands of keys, flat index vs the old linear search by hash
+// also checks the index against what was written, duplicate detection and case-insensitive lookups
+//
+
+class Key {
+public:
+    std::wstring m_section;
+    std::wstring m_value;
+};
+
+// sections * values keys, every value is its key's number
+// dupes is how many keys are written a second time (with a different value) at the end of their section
+static std_fs::path write_config( size_t sections, size_t values, size_t dupes, std::vector< Key > &keys ) {
+    const auto path = std_fs::temp_directory_path() / "umi_bench_ini_lookup.ini";
+
+    std::ofstream file( path, std::ios::binary );
+
+    keys.clear();
+
+    for( size_t s = 0; s < sections; ++s ) {
+        file << "[Section" << s << "]\r\n";
+
+        for( size_t v = 0; v < values; ++v ) {
+            file << "SomeLongerValueName" << v << " = " << keys.size() << "\r\n";
+
+            keys.push_back( Key{ L"Section" + std::to_wstring( s ), L"SomeLongerValueName" + std::to_wstring( v ) } );
+        }
+
+        for( size_t v = 0; v < values && s * values + v < dupes; ++v )
+            file << "SomeLongerValueName" << v << " = 999999\r\n";
+    }
+
+    return path;
+}
+
+static void test_index() {
+    std::vector< Key > keys;
+
+    const auto path = write_config( 32, 128, 100, keys );
+
+    INIParser ini( path.wstring() );
+
+    CHECK( ini.is_valid() );
+    CHECK( ini.get_duplicate_count() == 100 );
+
+    // first one wins
+    for( size_t i = 0; i < keys.size(); ++i )
+        CHECK( ini.get_value_uint32( keys[ i ].m_section, keys[ i ].m_value, ~0u ) == i );
+
+    // misses
+    CHECK( ini.get_value_uint32( L"Section0", L"NotThere", 7 ) == 7 );
+    CHECK( ini.get_value_uint32( L"NotThere", L"SomeLongerValueName0", 7 ) == 7 );
+    CHECK( ini.get_value_uint32( L"section0", L"SomeLongerValueName0", 7 ) == 7 );
+
+    // case-insensitive
+    INIParser folded( path.wstring(), true );
+
+    CHECK( folded.get_value_uint32( L"SECTION3", L"somelongervaluename5", ~0u ) == 3 * 128 + 5 );
+    CHECK( folded.get_duplicate_count() == 100 );
+
+    std_fs::remove( path );
+}
+
+static void bench_lookup( size_t sections, size_t values ) {
+    std::vector< Key > keys;
+
+    const auto path = write_config( sections, values, 0, keys );
+
+    INIParser      ini( path.wstring() );
+    INIParser      folded( path.wstring(), true );
+    OldINI::Parser old;
+
+    CHECK( old.init( path ) );
+
+    // random order, so the old search doesn't always find keys early
+    std::mt19937 rng( 4 );
+
+    std::shuffle( keys.begin(), keys.end(), rng );
+
+    const auto time_lookups = [ & ]( auto &&get ) {
+        return Test::time_ns( keys.size(), [ & ]( size_t i ) {
+            Test::keep( get( keys[ i ] ) );
+        } );
+    };
+
+    const auto old_ns = time_lookups( [ & ]( const Key &k ) { return old.get_value< uint32_t >( k.m_section, k.m_value, 0 ); } );
+    const auto new_ns = time_lookups( [ & ]( const Key &k ) { return ini.get_value_uint32( k.m_section, k.m_value, 0 ); } );
+    const auto fold_ns = time_lookups( [ & ]( const Key &k ) { return folded.get_value_uint32( k.m_section, k.m_value, 0 ); } );
+
+    const auto report = [ & ]( const char *what, double value ) {
+        const auto name = std::to_string( sections * values ) + " keys, " + what;
+
+        Test::report( name.c_str(), value, "ns" );
+    };
+
+    report( "linear lookup", old_ns );
+    report( "indexed lookup", new_ns );
+    report( "indexed lookup, ignore case", fold_ns );
+
+    std_fs::remove( path );
+}
+
+int main() {
+    test_index();
+
+    bench_lookup( 16, 16 );
+    bench_lookup( 64, 64 );
+    bench_lookup( 128, 128 );
+
+    return Test::result();
+}
@@ -0,0 +1,118 @@
+#include "test.h"
+#include "alloc_count.h"
+#include "old_ini_parser.h"
+
+//
+// INI parse time and heap allocations, mapped file parser vs the old getline parser
+// configs are generated from 1 KiB to 10 MiB, both parsers must agree on what they read
+//
+
+// config of about size bytes, 16 values per section
+static std::string make_config( size_t size ) {
+    std::string out;
+
+    for( size_t s = 0; out.size() < size; ++s ) {
+        out += "; section " + std::to_string( s ) + "\r\n";
+        out += "[Section" + std::to_string( s ) + "]\r\n";
+
+        for( size_t v = 0; v < 16; ++v )
+            out += "Value" + std::to_string( v ) + " = " + std::to_string( s * 16 + v ) + "\r\n";
+
+        out += "\r\n";
+    }
+
+    return out;
+}
+
+static std_fs::path write_config( const std::string &text ) {
+    const auto path = std_fs::temp_directory_path() / "umi_bench_ini_parse.ini";
+
+    std::ofstream( path, std::ios::binary ) << text;
+
+    return path;
+}
+
+static size_t count_values( const INIParser &ini ) {
+    size_t out = 0;
+
+    for( const auto &s : ini.get_all_sections() )
+        out += s.get_all_values().size();
+
+    return out;
+}
+
+static size_t count_values( const OldINI::Parser &ini ) {
+    size_t out = 0;
+
+    for( const auto &s : ini.m_sections )
+        out += s.m_values.size();
+
+    return out;
+}
+
+static void bench_parse( size_t size, const char *label ) {
+    const auto path = write_config( make_config( size ) );
+
+    // both read the same thing
+    {
+        INIParser      ini( path.wstring() );
+        OldINI::Parser old;
+
+        CHECK( ini.is_valid() );
+        CHECK( old.init( path ) );
+        CHECK( ini.get_all_sections().size() == old.m_sections.size() );
+        CHECK( count_values( ini ) == count_values( old ) );
+        CHECK( ini.get_value_uint32( L"Section0", L"Value15", 0 ) == 15 );
+        CHECK( old.get_value< uint32_t >( L"Section0", L"Value15", 0 ) == 15 );
+    }
+
+    // allocations for one parse, the parser is destroyed after so the peak is all it held
+    const auto count_allocs = [ & ]( auto &&parse ) {
+        AllocCount::reset();
+
+        parse();
+
+        return AllocCount::get();
+    };
+
+    const auto new_allocs = count_allocs( [ & ]() { INIParser ini( path.wstring() ); } );
+    const auto old_allocs = count_allocs( [ & ]() { OldINI::Parser old; old.init( path ); } );
+
+    const auto new_ns = Test::time_ns( 1, [ & ]( size_t ) {
+        INIParser ini( path.wstring() );
+
+        Test::keep( ini );
+    } );
+
+    const auto old_ns = Test::time_ns( 1, [ & ]( size_t ) {
+        OldINI::Parser old;
+
+        old.init( path );
+
+        Test::keep( old );
+    } );
+
+    const auto report = [ & ]( const char *what, double value, const char *unit ) {
+        const auto name = std::string( label ) + ", " + what;
+
+        Test::report( name.c_str(), value, unit );
+    };
+
+    report( "getline parse", old_ns / 1e6, "ms" );
+    report( "mapped parse", new_ns / 1e6, "ms" );
+    report( "getline parse allocations", (double)old_allocs.m_allocs, "" );
+    report( "mapped parse allocations", (double)new_allocs.m_allocs, "" );
+    report( "getline parse peak heap", old_allocs.m_peak_bytes / 1024.0, "KiB" );
+    report( "mapped parse peak heap", new_allocs.m_peak_bytes / 1024.0, "KiB" );
+
+    std_fs::remove( path );
+}
+
+int main() {
+    bench_parse( 1 << 10, "1 KiB config" );
+    bench_parse( 64 << 10, "64 KiB config" );
+    bench_parse( 1 << 20, "1 MiB config" );
+    bench_parse( 10 << 20, "10 MiB config" );
+
+    return Test::result();
+}
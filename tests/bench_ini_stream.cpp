@@ -0,0 +1,123 @@
+#include "test.h"
+#include "alloc_count.h"
+#include "ini_reader.h"
+
+//
+// streaming reader vs the whole document parser on a large config, time and peak heap
+// the config is the loader settings, an overlay for UmiharaKawase, then a few MiB of plugin sections
+// binding for UmiharaKawase stops after its overlay, binding for another game has to read the whole file
+//
+
+constexpr size_t PLUGIN_VALUES = 16;
+
+// every schema field with a valid value
+static std::string schema_section( std::string_view name ) {
+    std::string out = "[" + std::string( name ) + "]\r\n";
+
+    for( const auto &f : Config::SCHEMA ) {
+        const auto value = ( f.m_type == Config::FIELD_BOOL ) ? "true" : ( f.m_type == Config::FIELD_UINT32 ) ? "0" : "0x2C";
+
+        out += std::string( f.m_name.begin(), f.m_name.end() ) + " = " + value + "\r\n";
+    }
+
+    return out + "\r\n";
+}
+
+static std_fs::path write_config( size_t size, size_t &plugin_sections ) {
+    const auto path = std_fs::temp_directory_path() / "umi_bench_ini_stream.ini";
+
+    auto text = schema_section( "settings" ) + schema_section( "settings.UMI_GAME_KAWASE" );
+
+    for( plugin_sections = 0; text.size() < size; ++plugin_sections ) {
+        text += "; plugin " + std::to_string( plugin_sections ) + "\r\n";
+        text += "[plugin" + std::to_string( plugin_sections ) + "]\r\n";
+
+        for( size_t v = 0; v < PLUGIN_VALUES; ++v )
+            text += "value" + std::to_string( v ) + " = " + std::to_string( v * 31 ) + "\r\n";
+
+        text += "\r\n";
+    }
+
+    std::ofstream( path, std::ios::binary ) << text;
+
+    return path;
+}
+
+static size_t read_all( const std_fs::path &path ) {
+    auto reader = INIReader( path.wstring() );
+
+    size_t out = 0;
+
+    CHECK( reader.for_each( [ & ]( const INIReader::Event & ) {
+        ++out;
+
+        return true;
+    } ) );
+
+    return out;
+}
+
+static size_t parse_all( const std_fs::path &path ) {
+    const auto ini = INIParser( path.wstring() );
+
+    size_t out = 0;
+
+    for( const auto &s : ini.get_all_sections() )
+        out += s.get_all_values().size();
+
+    return out;
+}
+
+static Config::BindResult bind( const std_fs::path &path, int8_t game_id ) {
+    Config::Settings settings;
+
+    auto reader = INIReader( path.wstring() );
+
+    const auto result = Config::bind( reader, game_id, settings );
+
+    CHECK( !reader.has_error() );
+
+    return result;
+}
+
+template< typename func_t > static void measure( const char *name, func_t &&func ) {
+    AllocCount::reset();
+
+    func();
+
+    const auto allocs = AllocCount::get();
+    const auto ns     = Test::time_ns( 3, [ & ]( size_t ) {
+        Test::keep( func() );
+    } );
+
+    Test::report( name, ns / 1e6, "ms" );
+    Test::report( ( std::string( name ) + ", peak heap" ).c_str(), allocs.m_peak_bytes / 1024.0, "KiB" );
+}
+
+int main() {
+    size_t plugin_sections;
+
+    const auto path      = write_config( 4 << 20, plugin_sections );
+    const auto value_amt = Config::SCHEMA.size() * 2 + plugin_sections * PLUGIN_VALUES;
+
+    // both read everything
+    CHECK( read_all( path ) == value_amt );
+    CHECK( parse_all( path ) == value_amt );
+
+    // UmiharaKawase is done after its overlay and never sees the plugin values
+    CHECK( bind( path, UMI_GAME_KAWASE ).m_unknown == 0 );
+
+    // other games keep reading in case their overlay comes later
+    CHECK( bind( path, UMI_GAME_KAWASE_SHUN ).m_unknown == plugin_sections * PLUGIN_VALUES );
+
+    std::printf( "4 MiB config, %zu values\n", value_amt );
+
+    measure( "INIReader, every value", [ & ]() { return read_all( path ); } );
+    measure( "INIParser, whole document", [ & ]() { return parse_all( path ); } );
+    measure( "Config::bind, stops after overlay", [ & ]() { return bind( path, UMI_GAME_KAWASE ).m_unknown; } );
+    measure( "Config::bind, whole file", [ & ]() { return bind( path, UMI_GAME_KAWASE_SHUN ).m_unknown; } );
+
+    std_fs::remove( path );
+
+    return Test::result();
+}
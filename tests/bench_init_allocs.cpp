@@ -0,0 +1,111 @@
+#include "test.h"
+#include "alloc_count.h"
+#include "ini_reader.h"
+
+//
+// heap allocations and peak heap of the portable parts of loader init
+// building every signature pattern and binding config.ini, with and without the init arena
+//
+
+using namespace PatternScan;
+
+// the istringstream pattern parser init used before the arena, for comparison
+static std::vector< Build::PatternByte > old_parse_pattern( std::string_view str ) {
+    std::vector< Build::PatternByte > out;
+    std::string                       token;
+
+    auto sstream = std::istringstream( std::string( str ) );
+
+    while( std::getline( sstream, token, ' ' ) ) {
+        if( token.empty() || token.size() > 2 )
+            return {};
+
+        if( token[ 0 ] == '?' )
+            out.emplace_back( 0, true );
+        else
+            out.emplace_back( (uint8_t)std::strtoul( token.c_str(), nullptr, 16 ), false );
+    }
+
+    return out;
+}
+
+// parse every signature the way init does, the results are thrown away
+template< typename parse_t > static size_t build_patterns( parse_t &&parse ) {
+    size_t bytes = 0;
+
+    for( const auto &sig : Signatures::get_all() )
+        bytes += parse( sig.m_pattern );
+
+    return bytes;
+}
+
+static void bind_config() {
+    Config::Settings settings;
+
+    auto reader = INIReader( std_fs::path( UMI_CONFIG_INI ).wstring() );
+
+    CHECK( reader.is_open() );
+
+    Config::bind( reader, 0, settings );
+
+    CHECK( !reader.has_error() );
+}
+
+static void report( const char *name, const AllocCount::Counts &counts ) {
+    Test::report( ( std::string( name ) + ", heap allocations" ).c_str(), (double)counts.m_allocs, "" );
+    Test::report( ( std::string( name ) + ", peak heap" ).c_str(), counts.m_peak_bytes / 1024.0, "KiB" );
+}
+
+template< typename func_t > static AllocCount::Counts count( func_t &&func ) {
+    AllocCount::reset();
+
+    func();
+
+    return AllocCount::get();
+}
+
+int main() {
+    // same results either way
+    for( const auto &sig : Signatures::get_all() ) {
+        const auto pattern = Build::Pattern( sig.m_pattern );
+        const auto old     = old_parse_pattern( sig.m_pattern );
+
+        CHECK( pattern.size() == old.size() );
+
+        for( size_t i = 0; i < old.size() && i < pattern.size(); ++i )
+            CHECK( pattern[ i ].get_byte() == old[ i ].get_byte() && pattern[ i ].is_wildcard() == old[ i ].is_wildcard() );
+    }
+
+    const auto parse_old = []( std::string_view str ) {
+        return old_parse_pattern( str ).size();
+    };
+
+    const auto parse_new = []( std::string_view str ) {
+        return Build::Pattern( str ).size();
+    };
+
+    report( "signature patterns, istringstream", count( [ & ]() { build_patterns( parse_old ); } ) );
+    report( "signature patterns, heap", count( [ & ]() { build_patterns( parse_new ); } ) );
+
+    report( "config.ini bind", count( [ & ]() { bind_config(); } ) );
+
+    // everything at once inside the arena, as init_thread does it
+    // the arena's blocks are the only heap allocations it makes
+    size_t arena_allocs = 0;
+
+    const auto arena_counts = count( [ & ]() {
+        Arena        arena;
+        Arena::Scope scope( arena );
+
+        build_patterns( parse_new );
+        bind_config();
+
+        arena_allocs = arena.get_alloc_count();
+    } );
+
+    report( "patterns + config.ini, init arena", arena_counts );
+
+    Test::report( "patterns + config.ini, init arena, arena allocations", (double)arena_allocs, "" );
+
+    return Test::result();
+}
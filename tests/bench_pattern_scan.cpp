@@ -0,0 +1,131 @@
+#include "test.h"
+#include "compiled_pattern.h"
+
+//
+// compiled (SSE2) pattern scan vs the byte by byte scanner
+// results are checked against std::search on random data, then both are timed on a 16 MiB buffer
+//
+
+using namespace PatternScan;
+
+// the byte by byte scanner PatternScan::find falls back to
+static uintptr_t find_bytes( const uint8_t *data, size_t size, const Build::Pattern &pattern ) {
+    const auto it = std::search( data, data + size, pattern.cbegin(), pattern.cend(),
+        []( const uint8_t &a, const Build::PatternByte &b ) {
+            return b.compare( a );
+        }
+    );
+
+    return ( it != data + size ) ? (uintptr_t)it : 0;
+}
+
+// IDA-style pattern for len bytes at data, some bytes are wildcards
+static std::string make_pattern( std::mt19937 &rng, const uint8_t *data, size_t len, uint32_t wildcard_pct ) {
+    std::string out;
+
+    for( size_t i = 0; i < len; ++i ) {
+        char byte[ 4 ];
+
+        if( i )
+            out += ' ';
+
+        if( rng() % 100 < wildcard_pct ) {
+            out += "??";
+
+            continue;
+        }
+
+        std::snprintf( byte, sizeof( byte ), "%02X", data[ i ] );
+
+        out += byte;
+    }
+
+    return out;
+}
+
+static void test_matches_reference() {
+    std::mt19937 rng( 1 );
+
+    for( size_t iter = 0; iter < 3000; ++iter ) {
+        // small alphabet, so there are plenty of partial matches
+        std::vector< uint8_t > data( 1 + rng() % 4096 );
+
+        for( auto &b : data )
+            b = (uint8_t)( rng() % 4 );
+
+        const auto len   = 1 + rng() % std::min< size_t >( 48, data.size() );
+        const auto pos   = rng() % ( data.size() - len + 1 );
+        const auto str   = make_pattern( rng, data.data() + pos, len, 25 );
+        const auto start = (uintptr_t)data.data();
+
+        const auto pattern  = Build::Pattern( str );
+        const auto compiled = Build::CompiledPattern( pattern );
+        const auto expected = find_bytes( data.data(), data.size(), pattern );
+
+        CHECK( expected != 0 );
+        CHECK( PatternScan::find( start, data.size(), str ) == expected );
+
+        if( compiled )
+            CHECK( find_compiled( start, data.size(), compiled ) == expected );
+    }
+
+    // no match
+    const std::vector< uint8_t > zeros( 1000 );
+
+    CHECK( PatternScan::find( (uintptr_t)zeros.data(), zeros.size(), "00 00 01" ) == 0 );
+}
+
+static void bench_scan() {
+    constexpr size_t SIZE = 16 << 20;
+
+    std::mt19937           rng( 2 );
+    std::vector< uint8_t > data( SIZE );
+
+    for( auto &b : data )
+        b = (uint8_t)rng();
+
+    // game-name style signature, placed at the very end so the whole buffer is scanned
+    const auto str = "68 ?? ?? ?? ?? 8D 4C 24 ?? E8 ?? ?? ?? ?? 8B F0 85 F6";
+
+    const auto pattern  = Build::Pattern( str );
+    const auto compiled = Build::CompiledPattern( pattern );
+
+    for( size_t i = 0; i < pattern.size(); ++i )
+        data[ SIZE - pattern.size() + i ] = pattern[ i ].get_byte();
+
+    const auto expected = (uintptr_t)( data.data() + SIZE - pattern.size() );
+
+    CHECK( find_bytes( data.data(), SIZE, pattern ) == expected );
+    CHECK( find_compiled( (uintptr_t)data.data(), SIZE, compiled ) == expected );
+
+    const auto bytes_ns = Test::time_ns( 1, [ & ]( size_t ) {
+        Test::keep( find_bytes( data.data(), SIZE, pattern ) );
+    } );
+
+    const auto compiled_ns = Test::time_ns( 1, [ & ]( size_t ) {
+        Test::keep( find_compiled( (uintptr_t)data.data(), SIZE, compiled ) );
+    } );
+
+    // parse + compile, what a cache miss costs
+    const auto build_ns = Test::time_ns( 10000, [ & ]( size_t ) {
+        Test::keep( Build::CompiledPattern( Build::Pattern( str ) ) );
+    } );
+
+    // cache hit
+    const auto cached_ns = Test::time_ns( 10000, [ & ]( size_t ) {
+        Test::keep( Build::get_compiled( str ) );
+    } );
+
+    Test::report( "16 MiB scan, byte by byte", bytes_ns / 1e6, "ms" );
+    Test::report( "16 MiB scan, compiled", compiled_ns / 1e6, "ms" );
+    Test::report( "parse + compile pattern", build_ns, "ns" );
+    Test::report( "compiled pattern cache hit", cached_ns, "ns" );
+}
+
+int main() {
+    // timed first, the reference test fills the compiled pattern cache with thousands of patterns
+    bench_scan();
+    test_matches_reference();
+
+    return Test::result();
+}
\ No newline at end of file
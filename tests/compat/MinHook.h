@@ -0,0 +1,15 @@
+#pragma once
+
+//
+// MinHook declarations for detour.h, nothing is hooked on linux
+//
+
+enum MH_STATUS {
+    MH_OK = 0
+};
+
+MH_STATUS MH_Initialize();
+MH_STATUS MH_CreateHook( void *target, void *dest, void **orig );
+MH_STATUS MH_EnableHook( void *target );
+MH_STATUS MH_DisableHook( void *target );
+MH_STATUS MH_RemoveHook( void *target );
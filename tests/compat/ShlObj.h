@@ -0,0 +1,3 @@
+#pragma once
+
+// nothing from this header is used by the portable code
\ No newline at end of file
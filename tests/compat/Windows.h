@@ -0,0 +1,271 @@
+#pragma once
+
+//
+// just enough of Windows.h for the loader's portable code to build on linux
+// only what the headers in includes.h and the tested sources use is here, see compat.cpp
+//
+
+#include <cstdint>
+#include <cstddef>
+#include <cwchar>
+
+//
+// calling conventions / attributes
+//
+
+#define FORCEINLINE        inline __attribute__( ( always_inline ) )
+#define __forceinline      inline __attribute__( ( always_inline ) )
+#define __declspec( attr ) __attribute__( ( attr ) )
+#define __fastcall
+#define __stdcall
+#define __thiscall
+#define __cdecl
+#define WINAPI
+
+//
+// types
+// DWORD / LONG are 32-bit like on windows, the PE header structs depend on it
+//
+
+using HANDLE    = void *;
+using HMODULE   = void *;
+using HINSTANCE = void *;
+using FARPROC   = void *;
+using DWORD     = uint32_t;
+using WORD      = unsigned short;
+using BYTE      = unsigned char;
+using LONG      = int32_t;
+using LONGLONG  = int64_t;
+using ULONGLONG = uint64_t;
+using HRESULT   = long;
+using BOOL      = int;
+using PWSTR     = wchar_t *;
+using LPVOID    = void *;
+using LPCVOID   = const void *;
+
+union LARGE_INTEGER {
+    struct {
+        DWORD LowPart;
+        LONG  HighPart;
+    } u;
+
+    LONGLONG QuadPart;
+};
+
+struct FILETIME {
+    DWORD dwLowDateTime;
+    DWORD dwHighDateTime;
+};
+
+struct WIN32_FILE_ATTRIBUTE_DATA {
+    DWORD    dwFileAttributes;
+    FILETIME ftCreationTime;
+    FILETIME ftLastAccessTime;
+    FILETIME ftLastWriteTime;
+    DWORD    nFileSizeHigh;
+    DWORD    nFileSizeLow;
+};
+
+enum GET_FILEEX_INFO_LEVELS {
+    GetFileExInfoStandard
+};
+
+//
+// PE headers (32-bit layout)
+//
+
+#define IMAGE_DOS_SIGNATURE          0x5A4D
+#define IMAGE_NT_SIGNATURE           0x00004550
+#define IMAGE_NT_OPTIONAL_HDR_MAGIC  0x10B
+#define IMAGE_FILE_DLL               0x2000
+#define IMAGE_SCN_CNT_CODE           0x00000020
+#define IMAGE_SCN_MEM_EXECUTE        0x20000000
+#define IMAGE_SIZEOF_SHORT_NAME      8
+#define IMAGE_DIRECTORY_ENTRY_EXPORT 0
+
+struct IMAGE_DOS_HEADER {
+    WORD e_magic;
+    WORD e_unused[ 29 ];
+    LONG e_lfanew;
+};
+
+struct IMAGE_FILE_HEADER {
+    WORD  Machine;
+    WORD  NumberOfSections;
+    DWORD TimeDateStamp;
+    DWORD PointerToSymbolTable;
+    DWORD NumberOfSymbols;
+    WORD  SizeOfOptionalHeader;
+    WORD  Characteristics;
+};
+
+struct IMAGE_DATA_DIRECTORY {
+    DWORD VirtualAddress;
+    DWORD Size;
+};
+
+struct IMAGE_OPTIONAL_HEADER {
+    WORD                 Magic;
+    BYTE                 MajorLinkerVersion;
+    BYTE                 MinorLinkerVersion;
+    DWORD                SizeOfCode;
+    DWORD                SizeOfInitializedData;
+    DWORD                SizeOfUninitializedData;
+    DWORD                AddressOfEntryPoint;
+    DWORD                BaseOfCode;
+    DWORD                BaseOfData;
+    DWORD                ImageBase;
+    DWORD                SectionAlignment;
+    DWORD                FileAlignment;
+    WORD                 Versions[ 6 ];
+    DWORD                Win32VersionValue;
+    DWORD                SizeOfImage;
+    DWORD                SizeOfHeaders;
+    DWORD                CheckSum;
+    WORD                 Subsystem;
+    WORD                 DllCharacteristics;
+    DWORD                SizeOfStackReserve;
+    DWORD                SizeOfStackCommit;
+    DWORD                SizeOfHeapReserve;
+    DWORD                SizeOfHeapCommit;
+    DWORD                LoaderFlags;
+    DWORD                NumberOfRvaAndSizes;
+    IMAGE_DATA_DIRECTORY DataDirectory[ 16 ];
+};
+
+struct IMAGE_NT_HEADERS {
+    DWORD                 Signature;
+    IMAGE_FILE_HEADER     FileHeader;
+    IMAGE_OPTIONAL_HEADER OptionalHeader;
+};
+
+struct IMAGE_SECTION_HEADER {
+    BYTE Name[ IMAGE_SIZEOF_SHORT_NAME ];
+
+    union {
+        DWORD PhysicalAddress;
+        DWORD VirtualSize;
+    } Misc;
+
+    DWORD VirtualAddress;
+    DWORD SizeOfRawData;
+    DWORD PointerToRawData;
+    DWORD PointerToRelocations;
+    DWORD PointerToLinenumbers;
+    WORD  NumberOfRelocations;
+    WORD  NumberOfLinenumbers;
+    DWORD Characteristics;
+};
+
+using PIMAGE_DOS_HEADER     = IMAGE_DOS_HEADER *;
+using PIMAGE_NT_HEADERS     = IMAGE_NT_HEADERS *;
+using PIMAGE_SECTION_HEADER = IMAGE_SECTION_HEADER *;
+
+#define IMAGE_FIRST_SECTION( nt ) ( (PIMAGE_SECTION_HEADER)( (uintptr_t)&( nt )->OptionalHeader + ( nt )->FileHeader.SizeOfOptionalHeader ) )
+
+//
+// constants
+//
+
+#define TRUE  1
+#define FALSE 0
+#define S_OK  0
+
+#define INVALID_HANDLE_VALUE ( (HANDLE)(intptr_t)-1 )
+
+#define GENERIC_READ          0x80000000L
+#define GENERIC_WRITE         0x40000000L
+#define FILE_SHARE_READ       0x1
+#define FILE_SHARE_WRITE      0x2
+#define FILE_SHARE_DELETE     0x4
+#define CREATE_ALWAYS         2
+#define OPEN_EXISTING         3
+#define FILE_ATTRIBUTE_NORMAL 0x80
+
+#define PAGE_READONLY          0x02
+#define PAGE_READWRITE         0x04
+#define PAGE_EXECUTE_READ      0x20
+#define PAGE_EXECUTE_READWRITE 0x40
+#define FILE_MAP_READ          0x04
+#define MEM_COMMIT             0x1000
+#define MEM_RESERVE            0x2000
+#define MEM_RELEASE            0x8000
+
+#define INFINITE      0xFFFFFFFF
+#define WAIT_OBJECT_0 0
+#define WAIT_TIMEOUT  258
+
+#define MOVEFILE_REPLACE_EXISTING 0x1
+#define MOVEFILE_WRITE_THROUGH    0x8
+
+#define FILE_NOTIFY_CHANGE_FILE_NAME  0x01
+#define FILE_NOTIFY_CHANGE_SIZE       0x08
+#define FILE_NOTIFY_CHANGE_LAST_WRITE 0x10
+
+#define FILE_ACTION_ADDED            1
+#define FILE_ACTION_REMOVED          2
+#define FILE_ACTION_MODIFIED         3
+#define FILE_ACTION_RENAMED_OLD_NAME 4
+#define FILE_ACTION_RENAMED_NEW_NAME 5
+
+#define DLL_PROCESS_ATTACH 1
+#define DLL_PROCESS_DETACH 0
+
+#define MB_ICONERROR 0x10
+
+//
+// funcs, only the ones in compat.cpp link
+// file funcs also take char paths, std_fs::path::c_str() is char on linux
+//
+
+HMODULE GetModuleHandleA( const char *name );
+HMODULE GetModuleHandleW( const wchar_t *name );
+HMODULE LoadLibraryW( const wchar_t *name );
+FARPROC GetProcAddress( HMODULE module, const char *name );
+int     MessageBoxW( void *wnd, const wchar_t *text, const wchar_t *caption, unsigned type );
+void    ExitProcess( unsigned code );
+void    Sleep( DWORD ms );
+DWORD   GetTickCount();
+DWORD   GetCurrentThreadId();
+HANDLE  GetCurrentProcess();
+BOOL    CloseHandle( HANDLE handle );
+BOOL    DeleteObject( HANDLE handle );
+
+// thread funcs return the loader's ulong_t, msvc's DWORD is an unsigned long
+HANDLE CreateThread( void *attr, size_t stack_size, unsigned long ( *func )( void * ), void *arg, DWORD flags, DWORD *thread_id );
+HANDLE CreateEventW( void *attr, BOOL manual_reset, BOOL initial_state, const wchar_t *name );
+BOOL   SetEvent( HANDLE event );
+DWORD  WaitForSingleObject( HANDLE handle, DWORD ms );
+DWORD  WaitForMultipleObjects( DWORD count, const HANDLE *handles, BOOL wait_all, DWORD ms );
+
+BOOL QueryPerformanceCounter( LARGE_INTEGER *out );
+BOOL QueryPerformanceFrequency( LARGE_INTEGER *out );
+
+HANDLE CreateFileW( const wchar_t *path, DWORD access, DWORD share, void *attr, DWORD disposition, DWORD flags, HANDLE templ );
+HANDLE CreateFileW( const char *path, DWORD access, DWORD share, void *attr, DWORD disposition, DWORD flags, HANDLE templ );
+BOOL   GetFileSizeEx( HANDLE file, LARGE_INTEGER *out );
+BOOL   GetFileTime( HANDLE file, FILETIME *creation, FILETIME *access, FILETIME *write );
+BOOL   GetFileAttributesExW( const wchar_t *path, GET_FILEEX_INFO_LEVELS level, void *out );
+BOOL   GetFileAttributesExW( const char *path, GET_FILEEX_INFO_LEVELS level, void *out );
+BOOL   ReadFile( HANDLE file, void *data, DWORD size, DWORD *read, void *overlapped );
+BOOL   WriteFile( HANDLE file, const void *data, DWORD size, DWORD *written, void *overlapped );
+BOOL   FlushFileBuffers( HANDLE file );
+BOOL   MoveFileExW( const wchar_t *from, const wchar_t *to, DWORD flags );
+BOOL   MoveFileExW( const char *from, const char *to, DWORD flags );
+BOOL   DeleteFileW( const wchar_t *path );
+BOOL   DeleteFileW( const char *path );
+
+HANDLE CreateFileMappingW( HANDLE file, void *attr, DWORD protect, DWORD size_high, DWORD size_low, const wchar_t *name );
+void   *MapViewOfFile( HANDLE mapping, DWORD access, DWORD offset_high, DWORD offset_low, size_t size );
+BOOL   UnmapViewOfFile( const void *view );
+
+void *VirtualAlloc( void *addr, size_t size, DWORD type, DWORD protect );
+BOOL VirtualFree( void *addr, size_t size, DWORD type );
+BOOL VirtualProtect( void *addr, size_t size, DWORD protect, DWORD *old_protect );
+BOOL FlushInstructionCache( HANDLE process, const void *addr, size_t size );
+BOOL GetModuleInformation( HANDLE process, HMODULE module, void *out, DWORD size );
+
+HANDLE FindFirstChangeNotificationW( const wchar_t *path, BOOL subtree, DWORD filter );
+HANDLE FindFirstChangeNotificationW( const char *path, BOOL subtree, DWORD filter );
+BOOL   FindNextChangeNotification( HANDLE handle );
+BOOL   FindCloseChangeNotification( HANDLE handle );
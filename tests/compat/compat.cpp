@@ -0,0 +1,373 @@
+#include "includes.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <thread>
+#include <condition_variable>
+
+//
+// posix versions of the win32 funcs the portable code calls
+// handles are heap objects, CloseHandle deletes them
+//
+
+// the loader's log, messages are dropped
+std::shared_ptr< spdlog::logger > g_log = std::make_shared< spdlog::logger >( "tests", spdlog::sinks_init_list{} );
+
+namespace Compat {
+
+    class Handle {
+    public:
+        virtual ~Handle() = default;
+    };
+
+    class FileHandle : public Handle {
+    public:
+        int m_fd;
+
+        FileHandle( int fd ) : m_fd{ fd } {
+
+        }
+
+        ~FileHandle() override {
+            close( m_fd );
+        }
+    };
+
+    class MappingHandle : public Handle {
+    public:
+        int    m_fd;
+        size_t m_size;
+
+        MappingHandle( int fd, size_t size ) : m_fd{ dup( fd ) }, m_size{ size } {
+
+        }
+
+        ~MappingHandle() override {
+            close( m_fd );
+        }
+    };
+
+    class EventHandle : public Handle {
+    public:
+        std::mutex              m_mutex;
+        std::condition_variable m_cv;
+        bool                    m_manual_reset;
+        bool                    m_set;
+
+        EventHandle( bool manual_reset, bool set ) : m_manual_reset{ manual_reset }, m_set{ set } {
+
+        }
+    };
+
+    class ThreadHandle : public Handle {
+    public:
+        std::mutex              m_mutex;
+        std::condition_variable m_cv;
+        bool                    m_done;
+        std::thread             m_thread;
+
+        ThreadHandle() : m_done{ false } {
+
+        }
+
+        ~ThreadHandle() override {
+            if( m_thread.joinable() )
+                m_thread.detach();
+        }
+    };
+
+    // mapped views and their sizes, for UnmapViewOfFile
+    static std::mutex                                       g_views_mutex;
+    static std::vector< std::pair< const void *, size_t > > g_views;
+
+    static std::string to_path( const wchar_t *path ) {
+        return std_fs::path( path ).string();
+    }
+
+    static HANDLE open_file( const char *path, DWORD access, DWORD disposition ) {
+        const auto flags = ( access & GENERIC_WRITE ) ? ( O_RDWR | ( disposition == CREATE_ALWAYS ? O_CREAT | O_TRUNC : 0 ) ) : O_RDONLY;
+
+        const auto fd = open( path, flags, 0644 );
+        if( fd < 0 )
+            return INVALID_HANDLE_VALUE;
+
+        return new FileHandle( fd );
+    }
+
+    static FILETIME to_filetime( const timespec &time ) {
+        const auto ticks = (uint64_t)time.tv_sec * 10000000 + (uint64_t)time.tv_nsec / 100;
+
+        return FILETIME{ (DWORD)ticks, (DWORD)( ticks >> 32 ) };
+    }
+
+} // namespace Compat
+
+using namespace Compat;
+
+//
+// misc
+//
+
+HMODULE GetModuleHandleA( const char *name ) {
+    return nullptr;
+}
+
+FARPROC GetProcAddress( HMODULE module, const char *name ) {
+    return nullptr;
+}
+
+DWORD GetCurrentThreadId() {
+    return (DWORD)syscall( SYS_gettid );
+}
+
+void Sleep( DWORD ms ) {
+    std::this_thread::sleep_for( std::chrono::milliseconds( ms ) );
+}
+
+BOOL CloseHandle( HANDLE handle ) {
+    if( !handle || handle == INVALID_HANDLE_VALUE )
+        return FALSE;
+
+    delete (Handle *)handle;
+
+    return TRUE;
+}
+
+BOOL QueryPerformanceCounter( LARGE_INTEGER *out ) {
+    timespec now;
+
+    clock_gettime( CLOCK_MONOTONIC, &now );
+
+    out->QuadPart = (LONGLONG)now.tv_sec * 1000000000 + now.tv_nsec;
+
+    return TRUE;
+}
+
+BOOL QueryPerformanceFrequency( LARGE_INTEGER *out ) {
+    out->QuadPart = 1000000000;
+
+    return TRUE;
+}
+
+//
+// threads / events
+//
+
+HANDLE CreateThread( void *attr, size_t stack_size, unsigned long ( *func )( void * ), void *arg, DWORD flags, DWORD *thread_id ) {
+    const auto thread = new ThreadHandle();
+
+    thread->m_thread = std::thread( [ thread, func, arg ]() {
+        func( arg );
+
+        std::lock_guard< std::mutex > lock( thread->m_mutex );
+
+        thread->m_done = true;
+        thread->m_cv.notify_all();
+    } );
+
+    return thread;
+}
+
+HANDLE CreateEventW( void *attr, BOOL manual_reset, BOOL initial_state, const wchar_t *name ) {
+    return new EventHandle( manual_reset != FALSE, initial_state != FALSE );
+}
+
+BOOL SetEvent( HANDLE event ) {
+    const auto e = (EventHandle *)event;
+
+    std::lock_guard< std::mutex > lock( e->m_mutex );
+
+    e->m_set = true;
+    e->m_cv.notify_all();
+
+    return TRUE;
+}
+
+DWORD WaitForSingleObject( HANDLE handle, DWORD ms ) {
+    const auto wait = [ ms ]( std::unique_lock< std::mutex > &lock, std::condition_variable &cv, auto &&ready ) {
+        if( ms == INFINITE ) {
+            cv.wait( lock, ready );
+
+            return true;
+        }
+
+        return cv.wait_for( lock, std::chrono::milliseconds( ms ), ready );
+    };
+
+    if( const auto thread = dynamic_cast< ThreadHandle * >( (Handle *)handle ) ) {
+        std::unique_lock< std::mutex > lock( thread->m_mutex );
+
+        if( !wait( lock, thread->m_cv, [ thread ]() { return thread->m_done; } ) )
+            return WAIT_TIMEOUT;
+
+        lock.unlock();
+
+        if( thread->m_thread.joinable() )
+            thread->m_thread.join();
+
+        return WAIT_OBJECT_0;
+    }
+
+    const auto e = (EventHandle *)handle;
+
+    std::unique_lock< std::mutex > lock( e->m_mutex );
+
+    if( !wait( lock, e->m_cv, [ e ]() { return e->m_set; } ) )
+        return WAIT_TIMEOUT;
+
+    if( !e->m_manual_reset )
+        e->m_set = false;
+
+    return WAIT_OBJECT_0;
+}
+
+//
+// files
+//
+
+HANDLE CreateFileW( const wchar_t *path, DWORD access, DWORD share, void *attr, DWORD disposition, DWORD flags, HANDLE templ ) {
+    return open_file( to_path( path ).c_str(), access, disposition );
+}
+
+HANDLE CreateFileW( const char *path, DWORD access, DWORD share, void *attr, DWORD disposition, DWORD flags, HANDLE templ ) {
+    return open_file( path, access, disposition );
+}
+
+BOOL GetFileSizeEx( HANDLE file, LARGE_INTEGER *out ) {
+    struct stat st;
+
+    if( fstat( ( (FileHandle *)file )->m_fd, &st ) )
+        return FALSE;
+
+    out->QuadPart = st.st_size;
+
+    return TRUE;
+}
+
+BOOL GetFileTime( HANDLE file, FILETIME *creation, FILETIME *access, FILETIME *write ) {
+    struct stat st;
+
+    if( fstat( ( (FileHandle *)file )->m_fd, &st ) )
+        return FALSE;
+
+    if( creation )
+        *creation = to_filetime( st.st_ctim );
+
+    if( access )
+        *access = to_filetime( st.st_atim );
+
+    if( write )
+        *write = to_filetime( st.st_mtim );
+
+    return TRUE;
+}
+
+BOOL GetFileAttributesExW( const char *path, GET_FILEEX_INFO_LEVELS level, void *out ) {
+    struct stat st;
+
+    if( stat( path, &st ) )
+        return FALSE;
+
+    const auto data = (WIN32_FILE_ATTRIBUTE_DATA *)out;
+
+    *data = {};
+
+    data->ftCreationTime   = to_filetime( st.st_ctim );
+    data->ftLastAccessTime = to_filetime( st.st_atim );
+    data->ftLastWriteTime  = to_filetime( st.st_mtim );
+    data->nFileSizeHigh    = (DWORD)( (uint64_t)st.st_size >> 32 );
+    data->nFileSizeLow     = (DWORD)st.st_size;
+
+    return TRUE;
+}
+
+BOOL GetFileAttributesExW( const wchar_t *path, GET_FILEEX_INFO_LEVELS level, void *out ) {
+    return GetFileAttributesExW( to_path( path ).c_str(), level, out );
+}
+
+BOOL ReadFile( HANDLE file, void *data, DWORD size, DWORD *read_size, void *overlapped ) {
+    const auto ret = read( ( (FileHandle *)file )->m_fd, data, size );
+    if( ret < 0 )
+        return FALSE;
+
+    *read_size = (DWORD)ret;
+
+    return TRUE;
+}
+
+BOOL WriteFile( HANDLE file, const void *data, DWORD size, DWORD *written, void *overlapped ) {
+    const auto ret = write( ( (FileHandle *)file )->m_fd, data, size );
+    if( ret < 0 )
+        return FALSE;
+
+    *written = (DWORD)ret;
+
+    return TRUE;
+}
+
+BOOL FlushFileBuffers( HANDLE file ) {
+    return fsync( ( (FileHandle *)file )->m_fd ) == 0;
+}
+
+BOOL MoveFileExW( const char *from, const char *to, DWORD flags ) {
+    return rename( from, to ) == 0;
+}
+
+BOOL MoveFileExW( const wchar_t *from, const wchar_t *to, DWORD flags ) {
+    return MoveFileExW( to_path( from ).c_str(), to_path( to ).c_str(), flags );
+}
+
+BOOL DeleteFileW( const char *path ) {
+    return unlink( path ) == 0;
+}
+
+BOOL DeleteFileW( const wchar_t *path ) {
+    return DeleteFileW( to_path( path ).c_str() );
+}
+
+//
+// file mapping
+//
+
+HANDLE CreateFileMappingW( HANDLE file, void *attr, DWORD protect, DWORD size_high, DWORD size_low, const wchar_t *name ) {
+    LARGE_INTEGER size;
+
+    if( !GetFileSizeEx( file, &size ) || !size.QuadPart )
+        return nullptr;
+
+    return new MappingHandle( ( (FileHandle *)file )->m_fd, (size_t)size.QuadPart );
+}
+
+void *MapViewOfFile( HANDLE mapping, DWORD access, DWORD offset_high, DWORD offset_low, size_t size ) {
+    const auto m = (MappingHandle *)mapping;
+
+    const auto view = mmap( nullptr, m->m_size, PROT_READ, MAP_PRIVATE, m->m_fd, 0 );
+    if( view == MAP_FAILED )
+        return nullptr;
+
+    std::lock_guard< std::mutex > lock( g_views_mutex );
+
+    g_views.emplace_back( view, m->m_size );
+
+    return view;
+}
+
+BOOL UnmapViewOfFile( const void *view ) {
+    std::lock_guard< std::mutex > lock( g_views_mutex );
+
+    for( auto it = g_views.begin(); it != g_views.end(); ++it ) {
+        if( it->first != view )
+            continue;
+
+        munmap( (void *)it->first, it->second );
+
+        g_views.erase( it );
+
+        return TRUE;
+    }
+
+    return FALSE;
+}
\ No newline at end of file
@@ -0,0 +1,43 @@
+#pragma once
+
+//
+// the dinput bits sdk.h / config.h / dinput8_wrapper.h refer to
+//
+
+#define DI_OK 0
+
+using LPUNKNOWN       = void *;
+using LPCDIDATAFORMAT = const void *;
+
+struct IID {
+    uint32_t m_data[ 4 ];
+};
+
+// dinput8.dll exports, dinput8_wrapper.h takes their types
+HRESULT         DirectInput8Create( HINSTANCE inst, DWORD version, const IID &riid, LPVOID *out, LPUNKNOWN outer );
+HRESULT         DllCanUnloadNow();
+HRESULT         DllGetClassObject( const IID &clsid, const IID &riid, LPVOID *out );
+HRESULT         DllRegisterServer();
+HRESULT         DllUnregisterServer();
+LPCDIDATAFORMAT GetdfDIJoystick();
+
+struct IDirectInputDevice8W {
+    virtual HRESULT GetDeviceState( DWORD size, void *data ) = 0;
+};
+
+enum {
+    DIK_ESCAPE = 0x01,
+    DIK_TAB    = 0x0F,
+    DIK_RETURN = 0x1C,
+    DIK_A      = 0x1E,
+    DIK_S      = 0x1F,
+    DIK_Z      = 0x2C,
+    DIK_X      = 0x2D,
+    DIK_SPACE  = 0x39,
+    DIK_UP     = 0xC8,
+    DIK_PRIOR  = 0xC9,
+    DIK_LEFT   = 0xCB,
+    DIK_RIGHT  = 0xCD,
+    DIK_DOWN   = 0xD0,
+    DIK_NEXT   = 0xD1
+};
@@ -0,0 +1,35 @@
+#pragma once
+
+//
+// msvc bit scan intrinsics on top of the gcc / clang builtins
+//
+
+#include <immintrin.h>
+#include <x86intrin.h>
+
+static inline unsigned char _BitScanForward( unsigned long *index, unsigned long mask ) {
+    if( !mask )
+        return 0;
+
+    *index = (unsigned long)__builtin_ctzl( mask );
+
+    return 1;
+}
+
+static inline unsigned char _BitScanForward64( unsigned long *index, unsigned long long mask ) {
+    if( !mask )
+        return 0;
+
+    *index = (unsigned long)__builtin_ctzll( mask );
+
+    return 1;
+}
+
+static inline unsigned char _BitScanReverse( unsigned long *index, unsigned long mask ) {
+    if( !mask )
+        return 0;
+
+    *index = (unsigned long)( sizeof( mask ) * 8 - 1 - __builtin_clzl( mask ) );
+
+    return 1;
+}
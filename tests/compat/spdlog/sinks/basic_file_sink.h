@@ -0,0 +1,3 @@
+#pragma once
+
+// sinks are declared in spdlog.h
\ No newline at end of file
@@ -0,0 +1,86 @@
+#pragma once
+
+//
+// spdlog stand-in, the wide-char logging the loader uses is windows-only in spdlog
+// messages are dropped, tests check results directly
+// fmt is spdlog's bundled copy, some of the loader's output (e.g. the signature report) is formatted with it
+//
+
+#include <memory>
+#include <string>
+#include <initializer_list>
+
+#define FMT_HEADER_ONLY
+#include <spdlog/fmt/bundled/format.h>
+
+namespace spdlog {
+
+    namespace level {
+
+        enum level_enum {
+            trace,
+            debug,
+            info,
+            warn,
+            err
+        };
+
+    } // namespace level
+
+    namespace sinks {
+
+        class sink {
+        public:
+            virtual ~sink() = default;
+        };
+
+        class basic_file_sink_mt : public sink {
+        public:
+            basic_file_sink_mt( const std::string &, bool ) {
+
+            }
+        };
+
+        class stdout_color_sink_mt : public sink {
+        };
+
+    } // namespace sinks
+
+    using sinks_init_list = std::initializer_list< std::shared_ptr< sinks::sink > >;
+
+    class logger {
+    public:
+        logger( const std::string &, sinks_init_list ) {
+
+        }
+
+        template< typename... args_t > void trace( args_t &&... ) {
+
+        }
+
+        template< typename... args_t > void debug( args_t &&... ) {
+
+        }
+
+        template< typename... args_t > void info( args_t &&... ) {
+
+        }
+
+        template< typename... args_t > void warn( args_t &&... ) {
+
+        }
+
+        template< typename... args_t > void error( args_t &&... ) {
+
+        }
+
+        void flush_on( level::level_enum ) {
+
+        }
+
+        void set_pattern( const std::string & ) {
+
+        }
+    };
+
+} // namespace spdlog
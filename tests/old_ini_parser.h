@@ -0,0 +1,140 @@
+#pragma once
+
+#include "includes.h"
+
+#include <fstream>
+
+//
+// the INI parser as it was before it moved to a mapped file, kept as a baseline for the INI benchmarks
+// wifstream + getline, a string copy per name and value, lookups are linear by hash, getters convert with wcsto*
+//
+
+namespace OldINI {
+
+    class ValueInfo {
+    public:
+        std::wstring m_name;
+        hash32_t     m_name_hash;
+        std::wstring m_value;
+
+        template< typename t > std::optional< t > convert() const {
+            wchar_t *end = nullptr;
+            t        out;
+
+            if constexpr( std::is_same_v< t, double > )
+                out = (t)std::wcstod( m_value.c_str(), &end );
+
+            else if constexpr( std::is_unsigned_v< t > )
+                out = (t)std::wcstoull( m_value.c_str(), &end, 0 );
+
+            else
+                out = (t)std::wcstoll( m_value.c_str(), &end, 0 );
+
+            if( end == m_value.c_str() || *end != L'\0' )
+                return {};
+
+            return out;
+        }
+    };
+
+    class SectionInfo {
+    public:
+        std::wstring             m_name;
+        hash32_t                 m_name_hash;
+        std::vector< ValueInfo > m_values;
+    };
+
+    class Parser {
+    public:
+        bool                       m_valid = false;
+        std::vector< SectionInfo > m_sections;
+
+        bool init( const std_fs::path &filename ) {
+            std::wstring cur_line;
+            SectionInfo *section_info = nullptr;
+
+            auto file = std::wifstream( filename, std::ios::binary );
+            if( !file )
+                return false;
+
+            while( std::getline( file, cur_line ) ) {
+                if( cur_line.empty() )
+                    continue;
+
+                cur_line.erase( std::remove_if( cur_line.begin(), cur_line.end(), []( int c ) { return std::isspace( c ); } ), cur_line.end() );
+
+                if( cur_line.empty() || cur_line[ 0 ] == L';' || cur_line[ 0 ] == L'#' )
+                    continue;
+
+                if( cur_line[ 0 ] == L'[' ) {
+                    const auto end_bracket_delim = cur_line.find_first_of( L']' );
+                    if( end_bracket_delim == std::wstring::npos )
+                        return false;
+
+                    const auto section_name      = cur_line.substr( 1, end_bracket_delim - 1 );
+                    const auto section_name_hash = FNV1aHash::get_32( section_name );
+
+                    const auto sec_exists_it = std::find_if( m_sections.begin(), m_sections.end(), [ & ]( const SectionInfo &s ) {
+                        return s.m_name_hash == section_name_hash;
+                    } );
+
+                    if( sec_exists_it != m_sections.end() ) {
+                        section_info = &( *sec_exists_it );
+
+                        continue;
+                    }
+
+                    m_sections.push_back( SectionInfo{ section_name, section_name_hash, {} } );
+
+                    section_info = &m_sections.back();
+                }
+
+                else {
+                    if( !section_info )
+                        return false;
+
+                    const auto equal_delim = cur_line.find_first_of( L'=' );
+                    if( equal_delim == std::wstring::npos )
+                        return false;
+
+                    const auto value_name = cur_line.substr( 0, equal_delim );
+
+                    section_info->m_values.push_back( ValueInfo{ value_name, FNV1aHash::get_32( value_name ), cur_line.substr( equal_delim + 1 ) } );
+                }
+            }
+
+            m_valid = true;
+
+            return true;
+        }
+
+        const ValueInfo *get_value_info( std::wstring_view section_name, std::wstring_view value_name ) const {
+            const auto section_hash = FNV1aHash::get_32( section_name );
+            const auto value_hash   = FNV1aHash::get_32( value_name );
+
+            const auto section_it = std::find_if( m_sections.begin(), m_sections.end(), [ & ]( const SectionInfo &s ) {
+                return s.m_name_hash == section_hash;
+            } );
+
+            if( section_it == m_sections.end() )
+                return nullptr;
+
+            const auto value_it = std::find_if( section_it->m_values.begin(), section_it->m_values.end(), [ & ]( const ValueInfo &v ) {
+                return v.m_name_hash == value_hash;
+            } );
+
+            return ( value_it != section_it->m_values.end() ) ? &( *value_it ) : nullptr;
+        }
+
+        template< typename t > t get_value( std::wstring_view section_name, std::wstring_view value_name, t default_value ) const {
+            const auto info = get_value_info( section_name, value_name );
+            if( !info )
+                return default_value;
+
+            const auto out = info->convert< t >();
+
+            return ( out ) ? *out : default_value;
+        }
+    };
+
+} // namespace OldINI
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "includes.h"
+
+#include <cstdio>
+#include <random>
+
+//
+// minimal test / benchmark helpers
+// every test is its own executable, main() returns Test::result()
+//
+
+#define CHECK( cond ) Test::check( ( cond ), #cond, __FILE__, __LINE__ )
+
+namespace Test {
+
+    // failed checks so far
+    inline size_t g_failed = 0;
+
+    FORCEINLINE bool check( bool ok, const char *expr, const char *file, int line ) {
+        if( !ok ) {
+            std::printf( "%s:%d: check failed: %s\n", file, line, expr );
+
+            ++g_failed;
+        }
+
+        return ok;
+    }
+
+    // exit code for main()
+    inline int result() {
+        if( g_failed )
+            std::printf( "%zu check(s) failed\n", g_failed );
+
+        return g_failed ? 1 : 0;
+    }
+
+    // keep a value from being optimized out
+    template< typename t > FORCEINLINE void keep( const t &value ) {
+        asm volatile( "" : : "g"( &value ) : "memory" );
+    }
+
+    // nanoseconds per call of func, best of a few runs
+    template< typename func_t > NOINLINE double time_ns( size_t calls, func_t &&func ) {
+        constexpr size_t RUNS = 5;
+
+        auto best = std::numeric_limits< double >::max();
+
+        for( size_t run = 0; run < RUNS; ++run ) {
+            const auto start = std::chrono::steady_clock::now();
+
+            for( size_t i = 0; i < calls; ++i )
+                func( i );
+
+            const auto end = std::chrono::steady_clock::now();
+
+            best = std::min( best, std::chrono::duration< double, std::nano >( end - start ).count() / (double)calls );
+        }
+
+        return best;
+    }
+
+    // print a benchmark result
+    inline void report( const char *name, double value, const char *unit ) {
+        std::printf( "%-48s %12.2f %s\n", name, value, unit );
+    }
+
+} // namespace Test
@@ -0,0 +1,214 @@
+#include "test.h"
+#include "ini_reader.h"
+
+//
+// per-game overlays, "[settings.<game>]" sections merged on top of "[settings]"
+// the result must not depend on where the sections are in the file, every order is bound and compared
+// also times binding with large overlays (every field, keybinds with the most chords / keys)
+//
+
+using section_t = std::pair< std::string, std::vector< std::string > >;
+
+// keybind with chord_amt chords of key_amt keys, keys start at first
+static std::string make_keybind( uint32_t first, size_t chord_amt, size_t key_amt ) {
+    std::string out;
+
+    for( size_t c = 0; c < chord_amt; ++c ) {
+        if( c )
+            out += ", ";
+
+        for( size_t k = 0; k < key_amt; ++k ) {
+            if( k )
+                out += " + ";
+
+            out += std::to_string( ( first + c * key_amt + k ) % 0xFF + 1 );
+        }
+    }
+
+    return out;
+}
+
+// every schema field, values depend on seed so each layer is different
+static std::vector< std::string > make_values( uint32_t seed, size_t chord_amt, size_t key_amt ) {
+    std::vector< std::string > out;
+
+    for( size_t i = 0; i < Config::SCHEMA.size(); ++i ) {
+        const auto &f    = Config::SCHEMA[ i ];
+        const auto  name = std::string( f.m_name.begin(), f.m_name.end() );
+
+        if( f.m_type == Config::FIELD_BOOL )
+            out.push_back( name + " = " + ( ( ( seed + i ) % 2 ) ? "true" : "false" ) );
+
+        else if( f.m_type == Config::FIELD_UINT32 )
+            out.push_back( name + " = " + std::to_string( seed * 100 + i ) );
+
+        else
+            out.push_back( name + " = " + make_keybind( seed * 7 + (uint32_t)i, chord_amt, key_amt ) );
+    }
+
+    return out;
+}
+
+static std::string make_config( const std::vector< section_t > &sections ) {
+    std::string out;
+
+    for( const auto &[ name, values ] : sections ) {
+        out += "[" + name + "]\r\n";
+
+        for( const auto &v : values )
+            out += v + "\r\n";
+
+        out += "\r\n";
+    }
+
+    return out;
+}
+
+static std_fs::path write_config( const std::string &text ) {
+    const auto path = std_fs::temp_directory_path() / "umi_test_config_overlay.ini";
+
+    std::ofstream( path, std::ios::binary ) << text;
+
+    return path;
+}
+
+static Config::Settings bind( const std_fs::path &path, int8_t game_id, Config::BindResult &result ) {
+    Config::Settings out{};
+
+    auto reader = INIReader( path.wstring() );
+
+    result = Config::bind( reader, game_id, out );
+
+    CHECK( !reader.has_error() );
+
+    return out;
+}
+
+// settings are zeroed before binding, padding compares equal too
+static bool same( const Config::Settings &a, const Config::Settings &b ) {
+    return std::memcmp( &a, &b, sizeof( a ) ) == 0;
+}
+
+static void test_order() {
+    // base has every field, overlays only some, one game has none
+    auto base = make_values( 1, 2, 2 );
+    auto kawa = make_values( 2, 1, 1 );
+    auto shun = make_values( 3, 3, 2 );
+
+    kawa.resize( 10 );
+    shun.erase( shun.begin(), shun.begin() + 5 );
+
+    // base split over 2 sections, the same section name continues
+    const auto half = base.size() / 2;
+
+    std::vector< section_t > sections = {
+        { "settings", { base.begin(), base.begin() + half } },
+        { "settings", { base.begin() + half, base.end() } },
+        { "settings.UMI_GAME_KAWASE", kawa },
+        { "settings.UMI_GAME_KAWASE_SHUN", shun },
+        { "plugin", { "KEY_UP = 0x01", "value = 1" } }
+    };
+
+    std::sort( sections.begin(), sections.end() );
+
+    // expected, from the first order
+    std::array< Config::Settings, 3 > expected;
+
+    const auto first_path = write_config( make_config( sections ) );
+
+    for( int8_t game_id = 0; game_id < 3; ++game_id ) {
+        Config::BindResult result;
+
+        expected[ game_id ] = bind( first_path, game_id, result );
+
+        CHECK( result.m_duplicate == 0 && result.m_invalid == 0 );
+    }
+
+    // overlay values won, the rest are the base values
+    CHECK( expected[ UMI_GAME_KAWASE ].m_replay_start_key == 206 );
+    CHECK( expected[ UMI_GAME_KAWASE ].m_keybinds[ Config::KEYBIND_SKIP ].m_size == 2 );
+    CHECK( expected[ UMI_GAME_KAWASE_SHUN ].m_replay_start_key == 306 );
+    CHECK( expected[ UMI_GAME_KAWASE_SHUN ].m_keybinds[ Config::KEYBIND_SKIP ].m_size == 3 );
+    CHECK( expected[ UMI_GAME_SAYONARA_KAWASE ].m_replay_start_key == 106 );
+    CHECK( !same( expected[ UMI_GAME_KAWASE ], expected[ UMI_GAME_SAYONARA_KAWASE ] ) );
+
+    // every other order gives the same settings
+    size_t orders = 0;
+
+    while( std::next_permutation( sections.begin(), sections.end() ) ) {
+        const auto path = write_config( make_config( sections ) );
+
+        for( int8_t game_id = 0; game_id < 3; ++game_id ) {
+            Config::BindResult result;
+
+            CHECK( same( bind( path, game_id, result ), expected[ game_id ] ) );
+        }
+
+        ++orders;
+    }
+
+    CHECK( orders == 5 * 4 * 3 * 2 - 1 );
+
+    std_fs::remove( first_path );
+}
+
+// overlay with every field but one, so binding never stops before the end of the file
+static std::vector< std::string > make_overlay( uint32_t seed ) {
+    auto out = make_values( seed, Config::MAX_KEYBIND_CHORDS, Config::MAX_CHORD_KEYS );
+
+    out.erase( out.begin() + 7 );
+
+    return out;
+}
+
+static void bench_merge() {
+    constexpr size_t CALLS = 200;
+
+    // every field in [settings] and nearly every field in all 3 overlays, 8 chords of 4 keys per keybind
+    const std::vector< section_t > sections = {
+        { "settings.UMI_GAME_KAWASE", make_overlay( 2 ) },
+        { "settings.UMI_GAME_KAWASE_SHUN", make_overlay( 3 ) },
+        { "settings.UMI_GAME_SAYONARA_KAWASE", make_overlay( 4 ) },
+        { "settings", make_values( 1, Config::MAX_KEYBIND_CHORDS, Config::MAX_CHORD_KEYS ) }
+    };
+
+    Config::BindResult result;
+
+    const auto base_path = write_config( make_config( { sections.back() } ) );
+
+    const auto base_ns = Test::time_ns( CALLS, [ & ]( size_t ) {
+        Test::keep( bind( base_path, UMI_GAME_KAWASE, result ) );
+    } );
+
+    const auto path = write_config( make_config( sections ) );
+
+    for( int8_t game_id = 0; game_id < 3; ++game_id ) {
+        const auto settings = bind( path, game_id, result );
+
+        CHECK( result.m_unknown == 0 && result.m_duplicate == 0 && result.m_invalid == 0 );
+        CHECK( settings.m_replay_start_key == 100u * ( 2 + game_id ) + 6 );
+        CHECK( settings.m_replay_start_frame == 107 );
+    }
+
+    const auto first_ns = Test::time_ns( CALLS, [ & ]( size_t ) {
+        Test::keep( bind( path, UMI_GAME_KAWASE, result ) );
+    } );
+
+    const auto last_ns = Test::time_ns( CALLS, [ & ]( size_t ) {
+        Test::keep( bind( path, UMI_GAME_SAYONARA_KAWASE, result ) );
+    } );
+
+    Test::report( "bind, [settings] only", base_ns / 1e3, "us" );
+    Test::report( "bind, 3 overlays, first overlay used", first_ns / 1e3, "us" );
+    Test::report( "bind, 3 overlays, last overlay used", last_ns / 1e3, "us" );
+
+    std_fs::remove( base_path );
+    std_fs::remove( path );
+}
+
+int main() {
+    test_order();
+    bench_merge();
+
+    return Test::result();
+}
@@ -0,0 +1,282 @@
+#include "test.h"
+#include "ini_reader.h"
+#include "config_watcher.h"
+#include "snapshot.h"
+
+#include <thread>
+#include <condition_variable>
+
+//
+// hot reload: Snapshot publish / reclaim, and the watcher -> bind -> publish path main.cpp uses
+// the watcher runs on the inotify backend here, the debounce / change check is the same code as on windows
+//
+
+// counts live instances, so reclaim can be checked
+class Counted {
+public:
+    static inline std::atomic< int > s_alive = 0;
+
+    uint32_t m_value;
+    uint32_t m_check;
+
+    Counted( uint32_t value ) : m_value{ value }, m_check{ ~value } {
+        ++s_alive;
+    }
+
+    ~Counted() {
+        m_check = 0;
+
+        --s_alive;
+    }
+};
+
+static std::unique_ptr< const Counted > make( uint32_t value ) {
+    return std::make_unique< const Counted >( value );
+}
+
+static void test_snapshot() {
+    {
+        Snapshot< Counted > snapshot;
+
+        CHECK( !Snapshot< Counted >::Reader( snapshot ) );
+
+        snapshot.publish( make( 1 ) );
+
+        {
+            // a read in progress keeps its snapshot alive over a publish
+            const auto reader = Snapshot< Counted >::Reader( snapshot );
+
+            snapshot.publish( make( 2 ) );
+
+            CHECK( reader->m_value == 1 && reader->m_check == ~1u );
+            CHECK( Counted::s_alive == 2 );
+        }
+
+        // the reader moved on, 1 goes, 2 is kept until the reader moves past it too
+        snapshot.publish( make( 3 ) );
+
+        CHECK( Counted::s_alive == 2 );
+        CHECK( Snapshot< Counted >::Reader( snapshot )->m_value == 3 );
+
+        snapshot.publish( make( 4 ) );
+
+        CHECK( Counted::s_alive == 2 );
+
+        // no reads between publishes, nothing can be freed
+        snapshot.publish( make( 5 ) );
+        snapshot.publish( make( 6 ) );
+
+        CHECK( Counted::s_alive == 4 );
+        CHECK( Snapshot< Counted >::Reader( snapshot )->m_value == 6 );
+    }
+
+    // the rest are freed with the snapshot
+    CHECK( Counted::s_alive == 0 );
+
+    // reader thread against a publishing thread, reads must always see a live snapshot
+    {
+        constexpr uint32_t PUBLISHES = 20000;
+
+        Snapshot< Counted > snapshot;
+
+        snapshot.publish( make( 0 ) );
+
+        std::atomic< bool > done  = false;
+        size_t              bad   = 0;
+        size_t              reads = 0;
+
+        std::thread reader( [ & ]() {
+            uint32_t last = 0;
+
+            while( !done ) {
+                const auto read = Snapshot< Counted >::Reader( snapshot );
+
+                // published in order, freed snapshots have m_check cleared
+                if( read->m_check != ~read->m_value || read->m_value < last )
+                    ++bad;
+
+                last = read->m_value;
+
+                ++reads;
+            }
+        } );
+
+        for( uint32_t i = 1; i <= PUBLISHES; ++i )
+            snapshot.publish( make( i ) );
+
+        done = true;
+
+        reader.join();
+
+        CHECK( bad == 0 );
+        CHECK( reads > 0 );
+
+        // one more read, then everything retired before it is freed on the next publish
+        CHECK( Snapshot< Counted >::Reader( snapshot )->m_value == PUBLISHES );
+
+        snapshot.publish( make( 0 ) );
+
+        CHECK( Counted::s_alive == 2 );
+    }
+
+    CHECK( Counted::s_alive == 0 );
+}
+
+//
+// reload path
+//
+
+static const auto g_dir = std_fs::temp_directory_path() / "umi_test_config_watcher";
+
+static Snapshot< Config::Settings > g_settings;
+
+static std::mutex              g_reload_mutex;
+static std::condition_variable g_reload_cond;
+static size_t                  g_reloads = 0;
+
+static std::chrono::steady_clock::time_point g_reload_time;
+
+// what main.cpp's reload does, bind and publish
+static void reload( const std_fs::path &file ) {
+    auto settings = std::make_unique< Config::Settings >();
+
+    auto reader = INIReader( file.wstring() );
+
+    Config::bind( reader, UMI_GAME_KAWASE, *settings );
+
+    if( reader.has_error() )
+        return;
+
+    g_settings.publish( std::move( settings ) );
+
+    std::lock_guard< std::mutex > lock( g_reload_mutex );
+
+    ++g_reloads;
+
+    g_reload_time = std::chrono::steady_clock::now();
+
+    g_reload_cond.notify_all();
+}
+
+// wait for reload number count, false on timeout
+static bool wait_reloads( size_t count ) {
+    std::unique_lock< std::mutex > lock( g_reload_mutex );
+
+    return g_reload_cond.wait_for( lock, std::chrono::seconds( 5 ), [ & ]() { return g_reloads >= count; } );
+}
+
+static size_t reloads() {
+    std::lock_guard< std::mutex > lock( g_reload_mutex );
+
+    return g_reloads;
+}
+
+static void write_config( const std_fs::path &path, uint32_t frame ) {
+    std::ofstream( path, std::ios::binary ) << "[settings]\r\nreplay_start_frame = " << frame << "\r\n";
+}
+
+static uint32_t current_frame() {
+    const auto read = Snapshot< Config::Settings >::Reader( g_settings );
+
+    return read ? read->m_replay_start_frame : 0;
+}
+
+// idle time after a change, longer than SETTLE_TIME so a reload would have happened
+static void idle() {
+    std::this_thread::sleep_for( std::chrono::milliseconds( Config::Watcher::SETTLE_TIME * 3 ) );
+}
+
+static void test_reload() {
+    const auto ini_file = g_dir / "config.ini";
+
+    std_fs::remove_all( g_dir );
+    std_fs::create_directories( g_dir );
+
+    write_config( ini_file, 1 );
+
+    Config::Watcher watcher;
+
+    CHECK( !watcher.start( g_dir / "missing.ini", reload ) );
+    CHECK( watcher.start( ini_file, reload ) );
+    CHECK( !watcher.start( ini_file, reload ) );
+
+    // a burst of writes, closer together than SETTLE_TIME, is one reload with the last contents
+    std::chrono::steady_clock::time_point last_write;
+
+    for( uint32_t frame = 2; frame <= 6; ++frame ) {
+        last_write = std::chrono::steady_clock::now();
+
+        write_config( ini_file, frame );
+
+        std::this_thread::sleep_for( std::chrono::milliseconds( 20 ) );
+    }
+
+    CHECK( wait_reloads( 1 ) );
+
+    idle();
+
+    CHECK( reloads() == 1 );
+    CHECK( current_frame() == 6 );
+
+    const auto latency_ms = std::chrono::duration< double, std::milli >( g_reload_time - last_write ).count();
+
+    CHECK( latency_ms >= Config::Watcher::SETTLE_TIME );
+
+    // other files in the directory are ignored
+    for( size_t i = 0; i < 5; ++i )
+        std::ofstream( g_dir / "other.txt", std::ios::binary ) << i;
+
+    idle();
+
+    CHECK( reloads() == 1 );
+
+    // replaced by a rename, the way editors save
+    write_config( g_dir / "config.ini.tmp", 7 );
+
+    std_fs::rename( g_dir / "config.ini.tmp", ini_file );
+
+    CHECK( wait_reloads( 2 ) );
+    CHECK( current_frame() == 7 );
+
+    // deleted, nothing to reload, then back
+    std_fs::remove( ini_file );
+
+    idle();
+
+    CHECK( reloads() == 2 );
+
+    write_config( ini_file, 8 );
+
+    CHECK( wait_reloads( 3 ) );
+    CHECK( current_frame() == 8 );
+
+    // stop wakes the thread right away, in the middle of a settle wait too
+    write_config( ini_file, 9 );
+
+    std::this_thread::sleep_for( std::chrono::milliseconds( 20 ) );
+
+    const auto stop_start = std::chrono::steady_clock::now();
+
+    watcher.stop();
+
+    const auto stop_ms = std::chrono::duration< double, std::milli >( std::chrono::steady_clock::now() - stop_start ).count();
+
+    CHECK( !watcher.is_running() );
+    CHECK( stop_ms < Config::Watcher::SETTLE_TIME );
+
+    idle();
+
+    CHECK( reloads() == 3 );
+
+    Test::report( "reload, after the last write", latency_ms, "ms" );
+    Test::report( "stop, during a settle wait", stop_ms, "ms" );
+
+    std_fs::remove_all( g_dir );
+}
+
+int main() {
+    test_snapshot();
+    test_reload();
+
+    return Test::result();
+}
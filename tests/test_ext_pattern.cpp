@@ -0,0 +1,185 @@
+#include "test.h"
+#include "ext_pattern.h"
+
+//
+// extended patterns ("[a-b]" gaps, "(a|b)" alternation) against a brute force matcher
+// also times wide optional gaps, which must not cost more per byte as the gap gets wider
+//
+
+using namespace PatternScan;
+
+// a pattern as the test made it
+class Token {
+public:
+    std::array< bool, 256 > m_set; // bytes this token matches, unused for gaps
+    size_t                  m_gap_min;
+    size_t                  m_gap_max; // 0 if this isn't a gap
+};
+
+using tokens_t = std::vector< Token >;
+
+// does tokens[ idx... ] match [cur, end) exactly?
+static bool ref_match( const tokens_t &tokens, size_t idx, const uint8_t *cur, const uint8_t *end ) {
+    if( idx == tokens.size() )
+        return cur == end;
+
+    const auto &t = tokens[ idx ];
+
+    if( t.m_gap_max ) {
+        for( auto n = t.m_gap_min; n <= t.m_gap_max && n <= (size_t)( end - cur ); ++n ) {
+            if( ref_match( tokens, idx + 1, cur + n, end ) )
+                return true;
+        }
+
+        return false;
+    }
+
+    return cur != end && t.m_set[ *cur ] && ref_match( tokens, idx + 1, cur + 1, end );
+}
+
+// random pattern over a small alphabet, returns its string
+static std::string make_pattern( std::mt19937 &rng, tokens_t &tokens ) {
+    std::string out;
+
+    tokens.clear();
+
+    const auto amt = 1 + rng() % 6;
+
+    for( size_t i = 0; i < amt; ++i ) {
+        Token t{};
+
+        if( !out.empty() )
+            out += ' ';
+
+        // gaps can't come first
+        const auto kind = ( i == 0 ) ? rng() % 2 : rng() % 4;
+
+        if( kind == 0 ) {
+            const auto b = rng() % 4;
+
+            t.m_set[ b ] = true;
+
+            out += "0" + std::to_string( b );
+        }
+
+        else if( kind == 1 ) {
+            t.m_set[ 0 ] = t.m_set[ 2 ] = true;
+
+            out += "(00|02)";
+        }
+
+        else if( kind == 2 ) {
+            t.m_set.fill( true );
+
+            out += "??";
+        }
+
+        else {
+            t.m_gap_min = rng() % 3;
+            t.m_gap_max = t.m_gap_min + 1 + rng() % 3;
+
+            out += "[" + std::to_string( t.m_gap_min ) + "-" + std::to_string( t.m_gap_max ) + "]";
+        }
+
+        tokens.push_back( t );
+    }
+
+    return out;
+}
+
+static void test_matches_reference() {
+    std::mt19937 rng( 3 );
+
+    for( size_t iter = 0; iter < 2000; ++iter ) {
+        tokens_t   tokens;
+        const auto str     = make_pattern( rng, tokens );
+        const auto pattern = Build::ExtPattern( str );
+
+        CHECK( pattern );
+
+        std::vector< uint8_t > data( 1 + rng() % 200 );
+
+        for( auto &b : data )
+            b = (uint8_t)( rng() % 4 );
+
+        const auto begin = data.data();
+        const auto size  = data.size();
+
+        // first match: earliest end, then earliest start
+        // count: distinct starts
+        uintptr_t              expected = 0;
+        std::vector< uint8_t > is_start( size );
+
+        for( size_t e = 1; e <= size; ++e ) {
+            for( size_t s = 0; s < e; ++s ) {
+                if( !ref_match( tokens, 0, begin + s, begin + e ) )
+                    continue;
+
+                if( !expected )
+                    expected = (uintptr_t)( begin + s );
+
+                is_start[ s ] = 1;
+            }
+        }
+
+        size_t count = 0;
+
+        CHECK( pattern.find( (uintptr_t)begin, size ) == expected );
+        CHECK( pattern.find( (uintptr_t)begin, size, &count ) == expected );
+        CHECK( count == (size_t)std::count( is_start.begin(), is_start.end(), 1 ) );
+    }
+}
+
+static void test_count() {
+    // one start, three gap lengths
+    const std::array< uint8_t, 5 > data = { 0xAA, 0xBB, 0xBB, 0xBB, 0xCC };
+
+    size_t count = 0;
+
+    CHECK( Build::ExtPattern( "AA [0-2] BB" ).find( (uintptr_t)data.data(), data.size(), &count ) == (uintptr_t)data.data() );
+    CHECK( count == 1 );
+
+    // two starts
+    const std::array< uint8_t, 6 > two = { 0xAA, 0xBB, 0xAA, 0x00, 0xBB, 0xCC };
+
+    CHECK( Build::ExtPattern( "AA [0-2] BB" ).find( (uintptr_t)two.data(), two.size(), &count ) == (uintptr_t)two.data() );
+    CHECK( count == 2 );
+}
+
+static void bench_wide_gap() {
+    constexpr size_t SIZE = 1 << 20;
+
+    // "AA", gap bytes, "BB" repeated, every "BB" ends a match
+    // the old backtracking search took ~2^gap steps per match end
+    for( const size_t gap : { 4, 16, 30 } ) {
+        std::vector< uint8_t > data;
+
+        while( data.size() < SIZE ) {
+            data.push_back( 0xAA );
+            data.insert( data.end(), gap, 0x00 );
+            data.push_back( 0xBB );
+        }
+
+        const auto pattern = Build::ExtPattern( "AA [0-30] BB" );
+
+        size_t count = 0;
+
+        const auto ns = Test::time_ns( 1, [ & ]( size_t ) {
+            Test::keep( pattern.find( (uintptr_t)data.data(), data.size(), &count ) );
+        } );
+
+        CHECK( count == data.size() / ( gap + 2 ) );
+
+        const auto name = "1 MiB scan, AA [0-30] BB, real gap " + std::to_string( gap );
+
+        Test::report( name.c_str(), ns / 1e6, "ms" );
+    }
+}
+
+int main() {
+    test_matches_reference();
+    test_count();
+    bench_wide_gap();
+
+    return Test::result();
+}
\ No newline at end of file
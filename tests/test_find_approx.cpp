@@ -0,0 +1,234 @@
+#include "test.h"
+#include "pattern_scan.h"
+#include "signatures.h"
+
+//
+// approximate (shift-add) scan against a brute force closest match
+// also times the fallback on an 8 MiB buffer, what an outdated signature costs at startup
+//
+
+using namespace PatternScan;
+
+// closest match with at most max_mismatches non-wildcard bytes differing, same rules as find_approx
+static bool ref_approx( const std::vector< uint8_t > &data, const Build::Pattern &pattern, uint32_t max_mismatches, ApproxResult &out ) {
+    out = ApproxResult{ 0, 0, 0, 0.f };
+
+    const auto fixed_amt = (uint32_t)std::count_if( pattern.cbegin(), pattern.cend(), []( const Build::PatternByte &b ) { return !b.is_wildcard(); } );
+
+    if( !fixed_amt || max_mismatches >= fixed_amt || pattern.size() > data.size() )
+        return false;
+
+    auto best_dist = max_mismatches + 1;
+
+    for( size_t pos = 0; pos + pattern.size() <= data.size(); ++pos ) {
+        uint32_t dist = 0;
+
+        for( size_t j = 0; j < pattern.size(); ++j )
+            dist += !pattern[ j ].compare( data[ pos + j ] );
+
+        if( dist < best_dist ) {
+            best_dist        = dist;
+            out.m_addr       = (uintptr_t)( data.data() + pos );
+            out.m_best_count = 1;
+        }
+
+        else if( dist == best_dist )
+            ++out.m_best_count;
+    }
+
+    if( !out.m_addr )
+        return false;
+
+    out.m_distance   = best_dist;
+    out.m_confidence = ( (float)( fixed_amt - best_dist ) / (float)fixed_amt ) / (float)out.m_best_count;
+
+    return true;
+}
+
+// IDA-style pattern for len bytes at data, some bytes are wildcards and up to errors bytes are changed
+static std::string make_pattern( std::mt19937 &rng, const uint8_t *data, size_t len, uint32_t errors ) {
+    std::vector< int > bytes( data, data + len );
+
+    for( uint32_t i = 0; i < errors; ++i )
+        bytes[ rng() % len ] = (int)( rng() % 4 );
+
+    std::string out;
+
+    for( size_t i = 0; i < len; ++i ) {
+        char byte[ 4 ];
+
+        if( i )
+            out += ' ';
+
+        if( rng() % 8 == 0 ) {
+            out += "??";
+
+            continue;
+        }
+
+        std::snprintf( byte, sizeof( byte ), "%02X", bytes[ i ] );
+
+        out += byte;
+    }
+
+    return out;
+}
+
+static void test_matches_reference() {
+    std::mt19937 rng( 4 );
+
+    for( size_t iter = 0; iter < 3000; ++iter ) {
+        // small alphabet, plenty of near matches
+        std::vector< uint8_t > data( 1 + rng() % 2048 );
+
+        for( auto &b : data )
+            b = (uint8_t)( rng() % 4 );
+
+        // long patterns don't fit into the 64-bit state, their tail is checked per candidate
+        const auto len            = 1 + rng() % std::min< size_t >( 48, data.size() );
+        const auto pos            = rng() % ( data.size() - len + 1 );
+        const auto max_mismatches = (uint32_t)( rng() % 5 );
+        const auto str            = make_pattern( rng, data.data() + pos, len, (uint32_t)( rng() % 6 ) );
+
+        ApproxResult expected, result;
+
+        const auto expected_found = ref_approx( data, Build::Pattern( str ), max_mismatches, expected );
+        const auto found          = find_approx( (uintptr_t)data.data(), data.size(), str, max_mismatches, result );
+
+        CHECK( found == expected_found );
+
+        if( !found || !expected_found )
+            continue;
+
+        CHECK( result.m_addr == expected.m_addr );
+        CHECK( result.m_distance == expected.m_distance );
+        CHECK( result.m_best_count == expected.m_best_count );
+        CHECK( result.m_confidence == expected.m_confidence );
+    }
+}
+
+static void test_cases() {
+    // 8 unique bytes in filler
+    const std::array< uint8_t, 8 > sig = { 0x89, 0x86, 0x10, 0x20, 0x30, 0x40, 0xEB, 0x08 };
+
+    std::vector< uint8_t > data( 4096, 0xCC );
+
+    const auto place = [ & ]( size_t pos, std::initializer_list< size_t > changed ) {
+        std::copy( sig.begin(), sig.end(), data.begin() + pos );
+
+        for( const auto i : changed )
+            data[ pos + i ] ^= 0xFF;
+    };
+
+    const auto str = "89 86 10 20 30 40 EB 08";
+    const auto at  = [ & ]( size_t pos ) {
+        return (uintptr_t)( data.data() + pos );
+    };
+
+    ApproxResult out;
+
+    // exact
+    place( 100, {} );
+
+    CHECK( find_approx( (uintptr_t)data.data(), data.size(), str, 3, out ) );
+    CHECK( out.m_addr == at( 100 ) && out.m_distance == 0 && out.m_best_count == 1 && out.m_confidence == 1.f );
+
+    // 1 error, a worse match before it doesn't win
+    std::fill( data.begin(), data.end(), 0xCC );
+    place( 50, { 0, 3 } );
+    place( 300, { 5 } );
+
+    CHECK( find_approx( (uintptr_t)data.data(), data.size(), str, 3, out ) );
+    CHECK( out.m_addr == at( 300 ) && out.m_distance == 1 && out.m_best_count == 1 );
+    CHECK( out.m_confidence == 7.f / 8.f );
+
+    // k errors, at the limit and over it
+    std::fill( data.begin(), data.end(), 0xCC );
+    place( 200, { 0, 4, 7 } );
+
+    CHECK( find_approx( (uintptr_t)data.data(), data.size(), str, 3, out ) );
+    CHECK( out.m_addr == at( 200 ) && out.m_distance == 3 );
+    CHECK( !find_approx( (uintptr_t)data.data(), data.size(), str, 2, out ) );
+    CHECK( out.m_addr == 0 );
+
+    // two equally close matches halve the confidence
+    place( 1000, { 2 } );
+    place( 2000, { 6 } );
+
+    CHECK( find_approx( (uintptr_t)data.data(), data.size(), str, 3, out ) );
+    CHECK( out.m_addr == at( 1000 ) && out.m_best_count == 2 );
+    CHECK( out.m_confidence == 7.f / 8.f / 2.f );
+
+    // wildcards never mismatch
+    CHECK( find_approx( (uintptr_t)data.data(), data.size(), "89 86 ? 20 30 40 EB 08", 3, out ) );
+    CHECK( out.m_addr == at( 1000 ) && out.m_distance == 0 );
+
+    // match at the very end of the range
+    std::fill( data.begin(), data.end(), 0xCC );
+    place( data.size() - sig.size(), { 1 } );
+
+    CHECK( find_approx( (uintptr_t)data.data(), data.size(), str, 3, out ) );
+    CHECK( out.m_addr == at( data.size() - sig.size() ) );
+
+    // no match
+    std::fill( data.begin(), data.end(), 0xCC );
+
+    CHECK( !find_approx( (uintptr_t)data.data(), data.size(), str, 3, out ) );
+
+    // as many allowed mismatches as fixed bytes would match anything
+    CHECK( !find_approx( (uintptr_t)data.data(), data.size(), "89 ? 86", 2, out ) );
+
+    // hooked addresses never fall back
+    CHECK( !Signatures::allows_approx( Signatures::SIG_INPUT_HANDLER ) );
+    CHECK( Signatures::allows_approx( Signatures::SIG_KEY_LIST ) );
+}
+
+static void bench_approx() {
+    constexpr size_t SIZE = 8 << 20;
+
+    std::mt19937           rng( 5 );
+    std::vector< uint8_t > data( SIZE );
+
+    for( auto &b : data )
+        b = (uint8_t)rng();
+
+    // key list signature with a changed byte near the end of the buffer
+    // with 5 fixed bytes, random data has a few other matches 2 bytes off
+    const auto str = "89 86 ? ? ? ? B8 ? ? ? ? EB 08";
+    const auto pos = SIZE - 100;
+
+    const std::array< uint8_t, 13 > bytes = { 0x89, 0x86, 1, 2, 3, 4, 0xB8, 5, 6, 7, 8, 0xEB, 0x08 };
+
+    std::copy( bytes.begin(), bytes.end(), data.begin() + pos );
+
+    data[ pos + 12 ] = 0x09;
+
+    ApproxResult out;
+
+    CHECK( find_approx( (uintptr_t)data.data(), SIZE, str, 3, out ) );
+    CHECK( out.m_addr == (uintptr_t)( data.data() + pos ) && out.m_distance == 1 );
+
+    for( const uint32_t k : { 1, 3 } ) {
+        const auto ns = Test::time_ns( 1, [ & ]( size_t ) {
+            Test::keep( find_approx( (uintptr_t)data.data(), SIZE, str, k, out ) );
+        } );
+
+        const auto name = "8 MiB approx scan, " + std::to_string( k ) + " mismatch(es)";
+
+        Test::report( name.c_str(), ns / 1e6, "ms" );
+    }
+
+    const auto exact_ns = Test::time_ns( 1, [ & ]( size_t ) {
+        Test::keep( PatternScan::find( (uintptr_t)data.data(), SIZE, str ) );
+    } );
+
+    Test::report( "8 MiB exact scan, no match", exact_ns / 1e6, "ms" );
+}
+
+int main() {
+    test_matches_reference();
+    test_cases();
+    bench_approx();
+
+    return Test::result();
+}
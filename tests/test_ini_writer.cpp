@@ -0,0 +1,187 @@
+#include "test.h"
+#include "ini_writer.h"
+
+//
+// INI writer edits, and values / names that would change the file's structure if they were written
+//
+
+static std_fs::path write_file( const std::string &text ) {
+    const auto path = std_fs::temp_directory_path() / "umi_test_ini_writer.ini";
+
+    std::ofstream( path, std::ios::binary ) << text;
+
+    return path;
+}
+
+static std::string read_file( const std_fs::path &path ) {
+    std::ifstream      file( path, std::ios::binary );
+    std::ostringstream out;
+
+    out << file.rdbuf();
+
+    return out.str();
+}
+
+static void test_edit() {
+    const auto path = write_file( "; keep me\r\n[settings]\r\nhot_reload = 0 \r\n" );
+
+    INIWriter writer;
+
+    CHECK( writer.init( path ) );
+    CHECK( writer.set_value( L"settings", L"hot_reload", L"1" ) );
+    CHECK( writer.set_value( L"settings", L"new_value", L"2" ) );
+    CHECK( writer.set_value( L"other", L"x", L"3" ) );
+    CHECK( writer.save( path ) );
+
+    CHECK( read_file( path ) == "; keep me\r\n[settings]\r\nhot_reload = 1 \r\nnew_value = 2\r\n\r\n[other]\r\nx = 3\r\n" );
+
+    // nothing left behind
+    auto tmp_path = path;
+    tmp_path += ".tmp";
+
+    CHECK( !std_fs::exists( tmp_path ) );
+
+    std_fs::remove( path );
+}
+
+static void test_rejected() {
+    const auto text = std::string( "[settings]\r\nhot_reload = 0\r\n" );
+    const auto path = write_file( text );
+
+    INIWriter writer;
+
+    CHECK( writer.init( path ) );
+
+    // new lines in any part would add lines of their own
+    CHECK( !writer.set_value( L"settings", L"hot_reload", L"1\r\n[evil]\r\nx = 1" ) );
+    CHECK( !writer.set_value( L"settings", L"hot_reload", L"1\n" ) );
+    CHECK( !writer.set_value( L"settings", L"a\nb", L"1" ) );
+    CHECK( !writer.set_value( L"settings\r\n[evil]", L"x", L"1" ) );
+
+    // structure characters in names
+    CHECK( !writer.set_value( L"settings]", L"x", L"1" ) );
+    CHECK( !writer.set_value( L"[settings", L"x", L"1" ) );
+    CHECK( !writer.set_value( L"settings", L"x=y", L"1" ) );
+    CHECK( !writer.set_value( L"settings", L"[x]", L"1" ) );
+    CHECK( !writer.set_value( L"settings", L";x", L"1" ) );
+    CHECK( !writer.set_value( L"settings", L"x y", L"1" ) );
+    CHECK( !writer.set_value( L"", L"x", L"1" ) );
+    CHECK( !writer.set_value( L"settings", L"", L"1" ) );
+
+    // '=' and brackets are fine in values, the first '=' splits the line
+    CHECK( writer.set_value( L"settings", L"hot_reload", L"a=[b]" ) );
+    CHECK( writer.save( path ) );
+
+    CHECK( read_file( path ) == "[settings]\r\nhot_reload = a=[b]\r\n" );
+
+    std_fs::remove( path );
+}
+
+static void test_index() {
+    // section continued further down, a duplicate value, a line without '=' and a value before any section
+    const auto path = write_file( "x = 0\n[a]\nv = 1\nv = 2\n[b]\nw = 3\n[ a ]\nbad line\nu = 4\n" );
+
+    INIWriter writer;
+
+    CHECK( writer.init( path ) );
+    CHECK( writer.set_value( L"a", L"v", L"5" ) );
+    CHECK( writer.set_value( L"a", L"u", L"6" ) );
+    CHECK( writer.set_value( L"a", L"new", L"7" ) );
+    CHECK( writer.set_value( L"b", L"new", L"8" ) );
+    CHECK( writer.set_value( L"c", L"y", L"9" ) );
+    CHECK( writer.set_value( L"c", L"z", L"10" ) );
+
+    // set again, the last text wins
+    CHECK( writer.set_value( L"a", L"v", L"11" ) );
+    CHECK( writer.set_value( L"c", L"y", L"12" ) );
+    CHECK( writer.save( path ) );
+
+    // first value wins, new values go after the section's last value (in any of its blocks)
+    CHECK( read_file( path ) == "x = 0\n[a]\nv = 11\nv = 2\n[b]\nw = 3\nnew = 8\n[ a ]\nbad line\nu = 6\nnew = 7\n\n[c]\ny = 12\nz = 10\n" );
+
+    // the index is rebuilt after saving
+    CHECK( writer.set_value( L"c", L"z", L"13" ) );
+    CHECK( writer.set_value( L"a", L"new", L"14" ) );
+    CHECK( writer.save( path ) );
+
+    CHECK( read_file( path ) == "x = 0\n[a]\nv = 11\nv = 2\n[b]\nw = 3\nnew = 8\n[ a ]\nbad line\nu = 6\nnew = 14\n\n[c]\ny = 12\nz = 13\n" );
+
+    std_fs::remove( path );
+}
+
+static void test_utf16() {
+    // UTF-16LE with a BOM, names with non-ASCII chars
+    const std::u16string text = u"\uFEFF[s\u00E9]\r\nk\u3042 = 1\r\n";
+
+    const auto path = write_file( std::string( (const char *)text.data(), text.size() * 2 ) );
+
+    INIWriter writer;
+
+    CHECK( writer.init( path ) );
+    CHECK( writer.set_value( L"s\u00E9", L"k\u3042", L"\u00FC" ) );
+    CHECK( writer.save( path ) );
+
+    const std::u16string expected = u"\uFEFF[s\u00E9]\r\nk\u3042 = \u00FC\r\n";
+
+    CHECK( read_file( path ) == std::string( (const char *)expected.data(), expected.size() * 2 ) );
+
+    std_fs::remove( path );
+}
+
+// edits on a large config, what a plugin writing many values costs
+static void bench_rewrite() {
+    constexpr size_t SECTIONS = 1000;
+
+    std::string text;
+
+    for( size_t s = 0; s < SECTIONS; ++s ) {
+        text += "; section " + std::to_string( s ) + "\r\n[section" + std::to_string( s ) + "]\r\n";
+
+        for( size_t v = 0; v < 16; ++v )
+            text += "value" + std::to_string( v ) + " = " + std::to_string( v ) + "\r\n";
+    }
+
+    const auto path = write_file( text );
+
+    std::mt19937 rng( 3 );
+
+    // 1000 existing values and 100 new ones across the file
+    std::vector< std::pair< std::wstring, std::wstring > > keys;
+
+    for( size_t i = 0; i < 1000; ++i )
+        keys.emplace_back( L"section" + std::to_wstring( rng() % SECTIONS ), L"value" + std::to_wstring( rng() % 16 ) );
+
+    for( size_t i = 0; i < 100; ++i )
+        keys.emplace_back( L"section" + std::to_wstring( rng() % SECTIONS ), L"added" + std::to_wstring( i ) );
+
+    INIWriter writer;
+
+    const auto ns = Test::time_ns( 1, [ & ]( size_t ) {
+        writer.init( path );
+
+        for( const auto &[ section, name ] : keys )
+            writer.set_value( section, name, L"1" );
+
+        Test::keep( writer.has_edits() );
+    } );
+
+    // init alone, the rest is the edits
+    const auto init_ns = Test::time_ns( 1, [ & ]( size_t ) {
+        Test::keep( writer.init( path ) );
+    } );
+
+    Test::report( "INIWriter init, 17k lines", init_ns / 1e6, "ms" );
+    Test::report( "INIWriter init + 1100 set_value", ns / 1e6, "ms" );
+
+    std_fs::remove( path );
+}
+
+int main() {
+    test_edit();
+    test_rejected();
+    test_index();
+    test_utf16();
+    bench_rewrite();
+
+    return Test::result();
+}
@@ -0,0 +1,334 @@
+#include "test.h"
+#include "input_record.h"
+
+//
+// input recording: what the hook records is what a replay decodes
+// replays must survive cut off files and bad data, and seek across chunks
+// also times record(), the part that runs inside the game's input hook, and the decoder
+//
+
+using namespace InputRecord;
+
+// a few keys change per frame, like real input
+class Input {
+public:
+    uint32_t                        m_key_state;
+    std::array< uint8_t, RAW_SIZE > m_raw;
+};
+
+static std::vector< Input > make_inputs( size_t amt ) {
+    std::mt19937         rng( 9 );
+    std::vector< Input > out;
+    Input                cur{};
+
+    for( size_t i = 0; i < amt; ++i ) {
+        // most frames change nothing
+        if( rng() % 4 == 0 ) {
+            const auto key = rng() % RAW_SIZE;
+
+            cur.m_raw[ key ] ^= 0x80;
+            cur.m_key_state  ^= 1u << ( key % 32 );
+        }
+
+        out.push_back( cur );
+    }
+
+    return out;
+}
+
+static const auto g_rec_path = std_fs::temp_directory_path() / "umi_test_input_record.rec";
+
+// record inputs in batches, the writer drains the ring between batches so nothing is dropped
+// every batch is timed, returns the best ns per record() call
+static double record_file( const std::vector< Input > &inputs, size_t batch_size ) {
+    Recorder recorder;
+
+    CHECK( recorder.start( g_rec_path, 0, true ) );
+
+    auto best = std::numeric_limits< double >::max();
+
+    for( size_t start = 0; start < inputs.size(); start += batch_size ) {
+        const auto end = std::min( start + batch_size, inputs.size() );
+
+        const auto batch_start = std::chrono::steady_clock::now();
+
+        for( auto i = start; i < end; ++i )
+            recorder.record( inputs[ i ].m_key_state, inputs[ i ].m_raw.data() );
+
+        const auto batch_end = std::chrono::steady_clock::now();
+
+        best = std::min( best, std::chrono::duration< double, std::nano >( batch_end - batch_start ).count() / ( end - start ) );
+
+        // past a flush, so each batch is its own chunk
+        if( end < inputs.size() )
+            Sleep( 700 );
+    }
+
+    // writes the last batch
+    recorder.stop();
+
+    CHECK( !recorder.is_recording() );
+
+    return best;
+}
+
+static void test_round_trip( const std::vector< Input > &inputs ) {
+    Player player( g_rec_path );
+
+    CHECK( player.is_valid() );
+    CHECK( player.has_raw() );
+    CHECK( player.get_frame_amt() == inputs.size() );
+
+    Frame    frame;
+    uint64_t prev_time = 0;
+    size_t   i         = 0;
+
+    for( ; player.next( frame ); ++i ) {
+        if( i >= inputs.size() )
+            break;
+
+        CHECK( frame.m_key_state == inputs[ i ].m_key_state );
+        CHECK( frame.m_raw == inputs[ i ].m_raw );
+        CHECK( frame.m_time >= prev_time );
+
+        prev_time = frame.m_time;
+    }
+
+    CHECK( i == inputs.size() );
+}
+
+static std::vector< uint8_t > read_file( const std_fs::path &path ) {
+    std::ifstream file( path, std::ios::binary );
+
+    return std::vector< uint8_t >( std::istreambuf_iterator< char >( file ), {} );
+}
+
+static void write_file( const std_fs::path &path, const uint8_t *data, size_t size ) {
+    std::ofstream( path, std::ios::binary ).write( (const char *)data, (std::streamsize)size );
+}
+
+// offset and header of every complete chunk
+static std::vector< std::pair< size_t, ChunkHeader > > get_chunks( const std::vector< uint8_t > &data ) {
+    std::vector< std::pair< size_t, ChunkHeader > > out;
+
+    for( auto offset = sizeof( FileHeader ); offset + sizeof( ChunkHeader ) <= data.size(); ) {
+        ChunkHeader header;
+
+        std::memcpy( &header, data.data() + offset, sizeof( header ) );
+
+        if( header.m_size > data.size() - offset - sizeof( header ) )
+            break;
+
+        out.emplace_back( offset, header );
+
+        offset += sizeof( header ) + header.m_size;
+    }
+
+    return out;
+}
+
+static bool matches( const Frame &frame, const Input &input ) {
+    return frame.m_key_state == input.m_key_state && frame.m_raw == input.m_raw;
+}
+
+static void test_seek( const std::vector< Input > &inputs ) {
+    Player player( g_rec_path );
+    Frame  frame;
+
+    const auto chunks = get_chunks( read_file( g_rec_path ) );
+
+    CHECK( chunks.size() >= 3 );
+
+    // decode across every chunk boundary
+    for( const auto &[ offset, chunk ] : chunks ) {
+        const auto first = chunk.m_first_frame;
+        if( !first )
+            continue;
+
+        CHECK( player.seek( first - 1 ) );
+        CHECK( player.next( frame ) && matches( frame, inputs[ first - 1 ] ) );
+        CHECK( player.next( frame ) && matches( frame, inputs[ first ] ) );
+
+        CHECK( player.seek( first ) );
+        CHECK( player.get_frame() == first );
+        CHECK( player.next( frame ) && matches( frame, inputs[ first ] ) );
+    }
+
+    // anywhere, backwards too
+    std::mt19937 rng( 10 );
+
+    for( size_t i = 0; i < 200; ++i ) {
+        const auto target = rng() % inputs.size();
+
+        CHECK( player.seek( target ) );
+        CHECK( player.next( frame ) && matches( frame, inputs[ target ] ) );
+    }
+
+    CHECK( !player.seek( inputs.size() ) );
+}
+
+static void test_truncated( const std::vector< Input > &inputs ) {
+    const auto data   = read_file( g_rec_path );
+    const auto chunks = get_chunks( data );
+    const auto path   = std_fs::temp_directory_path() / "umi_test_input_record_cut.rec";
+
+    // frames in the chunks that fit in size bytes
+    const auto complete_frames = [ & ]( size_t size ) {
+        uint64_t out = 0;
+
+        for( const auto &[ offset, chunk ] : chunks ) {
+            if( offset + sizeof( ChunkHeader ) + chunk.m_size <= size )
+                out += chunk.m_frame_amt;
+        }
+
+        return out;
+    };
+
+    // cut inside the file header, inside a chunk header, inside chunk frames, right after a chunk
+    const std::array< size_t, 5 > cuts = {
+        sizeof( FileHeader ) - 1,
+        sizeof( FileHeader ),
+        chunks[ 1 ].first + sizeof( ChunkHeader ) / 2,
+        chunks[ 1 ].first + sizeof( ChunkHeader ) + chunks[ 1 ].second.m_size / 2,
+        chunks[ 2 ].first
+    };
+
+    for( const auto cut : cuts ) {
+        write_file( path, data.data(), cut );
+
+        Player player( path );
+
+        if( cut < sizeof( FileHeader ) ) {
+            CHECK( !player.is_valid() );
+
+            continue;
+        }
+
+        CHECK( player.is_valid() );
+        CHECK( player.get_frame_amt() == complete_frames( cut ) );
+
+        // everything that's left decodes as recorded
+        Frame  frame;
+        size_t i = 0;
+
+        for( ; player.next( frame ); ++i )
+            CHECK( i < inputs.size() && matches( frame, inputs[ i ] ) );
+
+        CHECK( i == player.get_frame_amt() );
+    }
+
+    std_fs::remove( path );
+}
+
+// a raw state recording with one chunk holding a single changed frame
+// runs are ( unchanged byte amt, changed byte amt ) pairs, changed bytes are all 0x80
+// size_cut bytes are cut off the end of the chunk
+static std::vector< uint8_t > make_raw_frame( const std::vector< std::pair< uint64_t, uint64_t > > &runs, uint32_t size_cut = 0 ) {
+    std::vector< uint8_t > frames;
+
+    // no time change, state changed, no game keys changed
+    T::put_varint( frames, 1 );
+    T::put_varint( frames, 0 );
+
+    for( const auto &[ same, diff ] : runs ) {
+        T::put_varint( frames, same );
+        T::put_varint( frames, diff );
+
+        frames.insert( frames.end(), (size_t)std::min< uint64_t >( diff, RAW_SIZE ), 0x80 );
+    }
+
+    FileHeader  file{ FILE_MAGIC, FILE_VERSION, FLAG_RAW, 0, 1000, 0 };
+    ChunkHeader chunk{ (uint32_t)frames.size() - size_cut, 1, 0, 0 };
+
+    std::vector< uint8_t > out( sizeof( file ) + sizeof( chunk ) + chunk.m_size );
+
+    std::memcpy( out.data(), &file, sizeof( file ) );
+    std::memcpy( out.data() + sizeof( file ), &chunk, sizeof( chunk ) );
+    std::memcpy( out.data() + sizeof( file ) + sizeof( chunk ), frames.data(), chunk.m_size );
+
+    return out;
+}
+
+static void test_bad_runs() {
+    const auto path = std_fs::temp_directory_path() / "umi_test_input_record_bad.rec";
+
+    const auto decodes = [ & ]( const std::vector< uint8_t > &data, Frame &frame ) {
+        write_file( path, data.data(), data.size() );
+
+        Player player( path );
+
+        CHECK( player.is_valid() );
+
+        const auto out = player.next( frame );
+
+        // bad data ends the recording
+        if( !out )
+            CHECK( !player.next( frame ) );
+
+        return out;
+    };
+
+    Frame frame;
+
+    // byte 10 pressed, then the rest unchanged
+    CHECK( decodes( make_raw_frame( { { 10, 1 }, { 245, 0 } } ), frame ) );
+    CHECK( frame.m_raw[ 10 ] == 0x80 );
+    CHECK( std::count( frame.m_raw.begin(), frame.m_raw.end(), 0 ) == RAW_SIZE - 1 );
+
+    // unchanged run past the end of the state
+    CHECK( !decodes( make_raw_frame( { { RAW_SIZE + 1, 0 } } ), frame ) );
+
+    // changed run past the end of the state
+    CHECK( !decodes( make_raw_frame( { { 200, 100 } } ), frame ) );
+
+    // empty run, would never finish
+    CHECK( !decodes( make_raw_frame( { { 0, 0 } } ), frame ) );
+
+    // changed bytes past the end of the chunk
+    CHECK( !decodes( make_raw_frame( { { 10, 4 }, { 242, 0 } }, 4 ), frame ) );
+
+    // run length cut off mid varint
+    CHECK( !decodes( make_raw_frame( { { 10, 1 }, { 300, 0 } }, 2 ), frame ) );
+
+    std_fs::remove( path );
+}
+
+static void bench_decode( const std::vector< Input > &inputs ) {
+    Player player( g_rec_path );
+    Frame  frame;
+
+    const auto decode_ns = Test::time_ns( 1, [ & ]( size_t ) {
+        player.seek( 0 );
+
+        while( player.next( frame ) )
+            Test::keep( frame );
+    } ) / inputs.size();
+
+    std::mt19937 rng( 11 );
+
+    const auto seek_ns = Test::time_ns( 1000, [ & ]( size_t ) {
+        player.seek( rng() % inputs.size() );
+    } );
+
+    Test::report( "decode per frame, raw state", decode_ns, "ns" );
+    Test::report( "seek to a random frame", seek_ns, "ns" );
+}
+
+int main() {
+    const auto inputs = make_inputs( 3000 );
+
+    const auto record_ns = record_file( inputs, 1000 );
+
+    test_round_trip( inputs );
+    test_seek( inputs );
+    test_truncated( inputs );
+    test_bad_runs();
+
+    Test::report( "record() per frame, raw state", record_ns, "ns" );
+
+    bench_decode( inputs );
+
+    std_fs::remove( g_rec_path );
+
+    return Test::result();
+}
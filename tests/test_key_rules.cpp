@@ -0,0 +1,242 @@
+#include "test.h"
+#include "key_state.h"
+
+//
+// chord rules: overlapping chords, chords across 64-key blocks, and the AVX mask test against plain checks
+// the benchmark fills every rule slot (14 keybinds x 8 chords = 112 rules)
+//
+
+using state_t = std::array< uint8_t, 256 >;
+
+static state_t make_state( std::initializer_list< uint8_t > keys ) {
+    state_t out{};
+
+    for( const auto key : keys )
+        out[ key ] = 0x80;
+
+    return out;
+}
+
+// defaults with some keybinds replaced
+static Config::Settings make_settings( std::initializer_list< std::pair< Config::KeybindID, std::wstring_view > > keybinds ) {
+    Config::Settings out{};
+
+    Config::set_defaults( out );
+
+    for( const auto &[ id, str ] : keybinds )
+        CHECK( Config::parse_keybind( str, out.m_keybinds[ id ] ) );
+
+    Config::build_key_table( out );
+
+    return out;
+}
+
+// reference, every key of the rule checked one at a time
+static NOINLINE uint32_t get_rule_state_scalar( const Config::KeyRule *rules, size_t rule_amt, const uint8_t *key_states ) {
+    uint32_t out = 0;
+
+    for( size_t i = 0; i < rule_amt; ++i ) {
+        auto held = true;
+
+        for( size_t key = 0; held && key < 256; ++key ) {
+            if( ( rules[ i ].m_mask[ key >> 3 ] >> ( key & 7 ) ) & 1 )
+                held = ( key_states[ key ] & 0x80 ) != 0;
+        }
+
+        if( held )
+            out |= rules[ i ].m_state;
+    }
+
+    return out;
+}
+
+// without AVX, 32 bits of the mask at a time
+static NOINLINE uint32_t get_rule_state_words( const Config::KeyRule *rules, size_t rule_amt, const KeyState::pressed_mask_t &pressed ) {
+    uint32_t out = 0;
+
+    for( size_t i = 0; i < rule_amt; ++i ) {
+        uint32_t missing = 0;
+
+        for( size_t w = 0; w < pressed.size(); ++w ) {
+            uint32_t mask;
+
+            std::memcpy( &mask, rules[ i ].m_mask.data() + w * 4, sizeof( mask ) );
+
+            missing |= mask & ~pressed[ w ];
+        }
+
+        if( !missing )
+            out |= rules[ i ].m_state;
+    }
+
+    return out;
+}
+
+static void test_overlap() {
+    // ctrl + space, ctrl + shift + space, and space on its own (KEY_START's default)
+    const auto settings = make_settings( {
+        { Config::KEYBIND_SKIP, L"0x1D+0x39" },
+        { Config::KEYBIND_BACK, L"0x1D+0x2A+0x39" }
+    } );
+
+    CHECK( settings.m_key_rule_amt == 2 );
+
+    const auto get = [ & ]( std::initializer_list< uint8_t > keys ) {
+        const auto state = make_state( keys );
+
+        return KeyState::get( settings, state.data() );
+    };
+
+    CHECK( get( { 0x39 } ) == UMI_KEY_START );
+    CHECK( get( { 0x1D, 0x39 } ) == ( UMI_KEY_START | UMI_KEY_SKIP ) );
+
+    // the longer chord doesn't hide the shorter one, or the single key
+    CHECK( get( { 0x1D, 0x2A, 0x39 } ) == ( UMI_KEY_START | UMI_KEY_SKIP | UMI_KEY_BACK ) );
+
+    // part of a chord is nothing
+    CHECK( get( { 0x1D } ) == 0 );
+    CHECK( get( { 0x1D, 0x2A } ) == 0 );
+
+    // extra keys don't matter
+    CHECK( get( { 0x1D, 0x39, 0x10, 0xF0 } ) == ( UMI_KEY_START | UMI_KEY_SKIP ) );
+}
+
+static void test_blocks() {
+    // first and last key, and keys in different 64-key blocks
+    const auto settings = make_settings( {
+        { Config::KEYBIND_SKIP, L"0x00+0xFF" },
+        { Config::KEYBIND_BACK, L"0x3F+0x40+0x80+0xC1" }
+    } );
+
+    const auto get = [ & ]( std::initializer_list< uint8_t > keys ) {
+        const auto state = make_state( keys );
+
+        return KeyState::get( settings, state.data() );
+    };
+
+    CHECK( get( { 0x00, 0xFF } ) == UMI_KEY_SKIP );
+    CHECK( get( { 0x00 } ) == 0 && get( { 0xFF } ) == 0 );
+    CHECK( get( { 0x3F, 0x40, 0x80, 0xC1 } ) == UMI_KEY_BACK );
+    CHECK( get( { 0x3F, 0x40, 0x80 } ) == 0 );
+    CHECK( get( { 0x40, 0x80, 0xC1 } ) == 0 );
+}
+
+// every rule slot, 2 - 4 keys each from a small key range so random states hit some of them
+static Config::Settings make_full_settings( std::mt19937 &rng ) {
+    Config::Settings out{};
+
+    Config::set_defaults( out );
+
+    for( auto &keybind : out.m_keybinds ) {
+        keybind.m_size = (uint8_t)Config::MAX_KEYBIND_CHORDS;
+
+        for( auto &chord : keybind.m_chords ) {
+            chord.m_size = (uint8_t)( 2 + rng() % 3 );
+
+            for( size_t k = 0; k < chord.m_size; ++k )
+                chord.m_keys[ k ] = (uint8_t)( 0x10 + rng() % 32 + k * 64 );
+        }
+    }
+
+    Config::build_key_table( out );
+
+    return out;
+}
+
+static std::vector< state_t > make_states( std::mt19937 &rng, size_t amt, size_t held ) {
+    std::vector< state_t > out( amt );
+
+    for( auto &state : out ) {
+        state.fill( 0 );
+
+        // same key range as the chords
+        for( size_t k = 0; k < held; ++k )
+            state[ 0x10 + rng() % 32 + ( rng() % 4 ) * 64 ] = 0x80;
+    }
+
+    return out;
+}
+
+static void test_random( const Config::Settings &settings, std::mt19937 &rng ) {
+    size_t fired = 0;
+
+    for( const auto &state : make_states( rng, 20000, 12 ) ) {
+        KeyState::pressed_mask_t pressed;
+
+        KeyState::get_table_state( settings.m_key_table, state.data(), pressed );
+
+        const auto rule_state = KeyState::get_rule_state( settings.m_key_rules.data(), settings.m_key_rule_amt, pressed );
+
+        CHECK( rule_state == get_rule_state_scalar( settings.m_key_rules.data(), settings.m_key_rule_amt, state.data() ) );
+        CHECK( rule_state == get_rule_state_words( settings.m_key_rules.data(), settings.m_key_rule_amt, pressed ) );
+
+        fired += rule_state != 0;
+    }
+
+    // not a test of nothing
+    CHECK( fired > 100 );
+}
+
+static void bench_rules( const Config::Settings &settings, std::mt19937 &rng ) {
+    constexpr size_t STATES = 4096;
+
+    std::printf( "%u rules\n", settings.m_key_rule_amt );
+
+    for( const size_t held : { 0, 4 } ) {
+        const auto states = make_states( rng, STATES, held );
+
+        // pressed masks up front, only the rules are timed
+        std::vector< KeyState::pressed_mask_t > pressed( STATES );
+
+        for( size_t i = 0; i < STATES; ++i )
+            KeyState::get_table_state( settings.m_key_table, states[ i ].data(), pressed[ i ] );
+
+        const auto avx_ns = Test::time_ns( 20, [ & ]( size_t ) {
+            uint32_t sum = 0;
+
+            for( const auto &p : pressed )
+                sum += KeyState::get_rule_state( settings.m_key_rules.data(), settings.m_key_rule_amt, p );
+
+            Test::keep( sum );
+        } ) / STATES;
+
+        const auto words_ns = Test::time_ns( 20, [ & ]( size_t ) {
+            uint32_t sum = 0;
+
+            for( const auto &p : pressed )
+                sum += get_rule_state_words( settings.m_key_rules.data(), settings.m_key_rule_amt, p );
+
+            Test::keep( sum );
+        } ) / STATES;
+
+        const auto total_ns = Test::time_ns( 20, [ & ]( size_t ) {
+            uint32_t sum = 0;
+
+            for( const auto &state : states )
+                sum += KeyState::get( settings, state.data() );
+
+            Test::keep( sum );
+        } ) / STATES;
+
+        const auto suffix = ", " + std::to_string( held ) + " keys held";
+
+        Test::report( ( "rules, 32 bits at a time" + suffix ).c_str(), words_ns, "ns" );
+        Test::report( ( "rules, AVX testc" + suffix ).c_str(), avx_ns, "ns" );
+        Test::report( ( "KeyState::get, table + rules" + suffix ).c_str(), total_ns, "ns" );
+    }
+}
+
+int main() {
+    std::mt19937 rng( 14 );
+
+    const auto settings = make_full_settings( rng );
+
+    CHECK( settings.m_key_rule_amt >= 100 );
+
+    test_overlap();
+    test_blocks();
+    test_random( settings, rng );
+    bench_rules( settings, rng );
+
+    return Test::result();
+}
@@ -0,0 +1,266 @@
+#include "test.h"
+#include "ini_reader.h"
+#include "key_state.h"
+
+//
+// keybinds: parsing (hex / decimal codes, malformed values and names, duplicates), the key table they build,
+// and the per-frame table lookup against the per-keybind loop it replaced
+//
+
+using Config::Keybind;
+
+static bool parse( std::wstring_view str, Keybind &out ) {
+    return Config::parse_keybind( str, out );
+}
+
+static bool parse_ok( std::wstring_view str ) {
+    Keybind keybind;
+
+    return parse( str, keybind );
+}
+
+// single key, single chord
+static bool is_key( std::wstring_view str, uint8_t key ) {
+    Keybind keybind;
+
+    return parse( str, keybind ) && keybind.m_size == 1 && keybind.m_chords[ 0 ].m_size == 1 && keybind.m_chords[ 0 ].m_keys[ 0 ] == key;
+}
+
+static void test_parse() {
+    // hex, any case, decimal and octal
+    CHECK( is_key( L"0x2C", 0x2C ) );
+    CHECK( is_key( L"0X2c", 0x2C ) );
+    CHECK( is_key( L"0xff", 0xFF ) );
+    CHECK( is_key( L"0x00", 0x00 ) );
+    CHECK( is_key( L"44", 0x2C ) );
+    CHECK( is_key( L"054", 0x2C ) );
+
+    // not a dinput key
+    CHECK( !parse_ok( L"0x100" ) );
+    CHECK( !parse_ok( L"256" ) );
+    CHECK( !parse_ok( L"-1" ) );
+    CHECK( !parse_ok( L"-0" ) );
+    CHECK( !parse_ok( L"0xFFFFFFFFFFFFFFFFFF" ) );
+
+    // key names aren't supported, neither are half written codes
+    CHECK( !parse_ok( L"DIK_Z" ) );
+    CHECK( !parse_ok( L"Z" ) );
+    CHECK( !parse_ok( L"0x" ) );
+    CHECK( !parse_ok( L"0x2G" ) );
+    CHECK( !parse_ok( L"08" ) );
+    CHECK( !parse_ok( L"0x2C;" ) );
+
+    // empty keys and chords
+    CHECK( !parse_ok( L"" ) );
+    CHECK( !parse_ok( L"0x1D+" ) );
+    CHECK( !parse_ok( L"+0x1D+0x2C" ) );
+    CHECK( !parse_ok( L"0x1D++0x2C" ) );
+    CHECK( !parse_ok( L"0x2C," ) );
+    CHECK( !parse_ok( L",0x2C" ) );
+    CHECK( !parse_ok( L"0x2C,,0x39" ) );
+
+    // whitespace is stripped by the INI parser before this, it's malformed here
+    CHECK( !parse_ok( L"0x1D + 0x2C" ) );
+
+    // chords and keys
+    Keybind keybind;
+
+    CHECK( parse( L"0x1D+0x2C,0x39,0x2A+0x1D+0x38+0x2C", keybind ) );
+    CHECK( keybind.m_size == 3 );
+    CHECK( keybind.m_chords[ 0 ].m_size == 2 && keybind.m_chords[ 0 ].m_keys[ 0 ] == 0x1D && keybind.m_chords[ 0 ].m_keys[ 1 ] == 0x2C );
+    CHECK( keybind.m_chords[ 1 ].m_size == 1 && keybind.m_chords[ 1 ].m_keys[ 0 ] == 0x39 );
+    CHECK( keybind.m_chords[ 2 ].m_size == 4 && keybind.m_chords[ 2 ].m_keys[ 3 ] == 0x2C );
+
+    // limits
+    CHECK( parse_ok( L"1+2+3+4" ) );
+    CHECK( !parse_ok( L"1+2+3+4+5" ) );
+    CHECK( parse_ok( L"1,2,3,4,5,6,7,8" ) );
+    CHECK( !parse_ok( L"1,2,3,4,5,6,7,8,9" ) );
+
+    // duplicates in a keybind are kept as written
+    CHECK( parse( L"0x2C,0x2C+0x2C", keybind ) );
+    CHECK( keybind.m_size == 2 && keybind.m_chords[ 1 ].m_size == 2 );
+}
+
+static void test_key_table() {
+    Config::Settings settings{};
+
+    Config::set_defaults( settings );
+
+    const auto set = [ & ]( Config::KeybindID id, std::wstring_view str ) {
+        CHECK( parse( str, settings.m_keybinds[ id ] ) );
+    };
+
+    // the same key on two keybinds sets both states
+    set( Config::KEYBIND_JUMP, L"0x2C" );
+    set( Config::KEYBIND_START, L"0x2C,0x39" );
+
+    // a key repeated in a chord is a single key
+    set( Config::KEYBIND_HOOK, L"0x1E+0x1E" );
+
+    // the same chord on two keybinds, in any key order, is one rule
+    set( Config::KEYBIND_SKIP, L"0x1D+0x2D" );
+    set( Config::KEYBIND_BACK, L"0x2D+0x1D,0x01" );
+
+    Config::build_key_table( settings );
+
+    CHECK( settings.m_key_table[ 0x2C ] == ( UMI_KEY_JUMP | UMI_KEY_START ) );
+    CHECK( settings.m_key_table[ 0x39 ] == UMI_KEY_START );
+    CHECK( settings.m_key_table[ 0x1E ] == UMI_KEY_HOOK );
+    CHECK( settings.m_key_table[ 0x01 ] == UMI_KEY_BACK );
+    CHECK( settings.m_key_table[ 0x1D ] == 0 && settings.m_key_table[ 0x2D ] == 0 );
+
+    CHECK( settings.m_key_rule_amt == 1 );
+    CHECK( settings.m_key_rules[ 0 ].m_state == ( UMI_KEY_SKIP | UMI_KEY_BACK ) );
+    CHECK( settings.m_key_rules[ 0 ].m_mask[ 0x1D >> 3 ] == ( 1 << ( 0x1D & 7 ) ) );
+    CHECK( settings.m_key_rules[ 0 ].m_mask[ 0x2D >> 3 ] == ( 1 << ( 0x2D & 7 ) ) );
+}
+
+//
+// through the INI, malformed names and duplicate values
+//
+
+static Config::BindResult bind_text( const std::string &text, Config::Settings &out ) {
+    const auto path = std_fs::temp_directory_path() / "umi_test_keybinds.ini";
+
+    std::ofstream( path, std::ios::binary ) << text;
+
+    auto reader = INIReader( path.wstring() );
+
+    const auto result = Config::bind( reader, UMI_GAME_KAWASE, out );
+
+    CHECK( !reader.has_error() );
+
+    std_fs::remove( path );
+
+    return result;
+}
+
+static void test_bind() {
+    Config::Settings settings{};
+
+    // names are case sensitive and must be in [settings]
+    auto result = bind_text(
+        "[settings]\r\n"
+        "KEY_JUMP = 0x1E\r\n"
+        "KEY_UPP = 0x10\r\n"
+        "key_hook = 0x11\r\n"
+        "KEY_HOOK  =  0x1D + 0x2C , 0x39\r\n"
+        "KEY_JUMP = 0x2C\r\n"
+        "KEY_L = DIK_Q\r\n"
+        "KEY_R = 0x1FF\r\n"
+        "[keys]\r\n"
+        "KEY_SKIP = 0x12\r\n",
+        settings );
+
+    CHECK( result.m_unknown == 3 );
+    CHECK( result.m_duplicate == 1 );
+    CHECK( result.m_invalid == 2 );
+
+    // first value wins
+    CHECK( settings.m_key_table[ 0x1E ] == UMI_KEY_JUMP );
+    CHECK( !( settings.m_key_table[ 0x2C ] & UMI_KEY_JUMP ) );
+
+    // whitespace around keys is fine
+    CHECK( settings.m_keybinds[ Config::KEYBIND_HOOK ].m_size == 2 );
+    CHECK( settings.m_key_table[ 0x39 ] == ( UMI_KEY_HOOK | UMI_KEY_START ) );
+    CHECK( settings.m_key_rule_amt == 1 );
+
+    // invalid values keep the defaults
+    CHECK( settings.m_key_table[ DIK_PRIOR ] == UMI_KEY_L );
+    CHECK( settings.m_key_table[ DIK_NEXT ] == UMI_KEY_R );
+    CHECK( settings.m_key_table[ DIK_X ] == UMI_KEY_SKIP );
+    CHECK( settings.m_key_table[ 0x10 ] == 0 && settings.m_key_table[ 0x11 ] == 0 && settings.m_key_table[ 0x12 ] == 0 );
+}
+
+//
+// lookup
+//
+
+// what modify_input_data did before the key table, one check per keybind
+// extended to every single key chord, so keybinds with more than one key give the same result
+static NOINLINE uint32_t get_state_per_keybind( const Config::Settings &settings, const uint8_t *key_states ) {
+    uint32_t out = 0;
+
+    for( size_t i = 0; i < settings.m_keybinds.size(); ++i ) {
+        const auto &keybind = settings.m_keybinds[ i ];
+
+        for( size_t j = 0; j < keybind.m_size; ++j ) {
+            if( keybind.m_chords[ j ].m_size == 1 && ( key_states[ keybind.m_chords[ j ].m_keys[ 0 ] ] & 0x80 ) )
+                out |= Config::KEYBIND_STATES[ i ];
+        }
+    }
+
+    return out;
+}
+
+static NOINLINE uint32_t get_state_table( const Config::Settings &settings, const uint8_t *key_states ) {
+    KeyState::pressed_mask_t pressed;
+
+    return KeyState::get_table_state( settings.m_key_table, key_states, pressed );
+}
+
+// random keyboard states with held keys pressed
+static std::vector< std::array< uint8_t, 256 > > make_states( std::mt19937 &rng, size_t amt, size_t held ) {
+    std::vector< std::array< uint8_t, 256 > > out( amt );
+
+    for( auto &state : out ) {
+        state.fill( 0 );
+
+        for( size_t k = 0; k < held; ++k )
+            state[ rng() % 256 ] = 0x80;
+    }
+
+    return out;
+}
+
+static void bench_lookup() {
+    constexpr size_t STATES = 4096;
+
+    Config::Settings settings{};
+
+    Config::set_defaults( settings );
+    Config::build_key_table( settings );
+
+    std::mt19937 rng( 13 );
+
+    // same result for single key binds
+    for( const auto &state : make_states( rng, STATES, 6 ) ) {
+        KeyState::pressed_mask_t pressed;
+
+        CHECK( KeyState::get_table_state( settings.m_key_table, state.data(), pressed ) == get_state_per_keybind( settings, state.data() ) );
+
+        for( size_t i = 0; i < 256; ++i )
+            CHECK( ( ( pressed[ i / 32 ] >> ( i % 32 ) ) & 1 ) == ( state[ i ] >> 7 ) );
+    }
+
+    for( const size_t held : { 0, 2, 8 } ) {
+        const auto states = make_states( rng, STATES, held );
+
+        const auto time = [ & ]( auto &&get_state ) {
+            return Test::time_ns( 50, [ & ]( size_t ) {
+                uint32_t sum = 0;
+
+                for( const auto &state : states )
+                    sum += get_state( settings, state.data() );
+
+                Test::keep( sum );
+            } ) / STATES;
+        };
+
+        const auto old_ns   = time( get_state_per_keybind );
+        const auto table_ns = time( get_state_table );
+
+        Test::report( ( "key state, per keybind, " + std::to_string( held ) + " keys held" ).c_str(), old_ns, "ns" );
+        Test::report( ( "key state, key table, " + std::to_string( held ) + " keys held" ).c_str(), table_ns, "ns" );
+    }
+}
+
+int main() {
+    test_parse();
+    test_key_table();
+    test_bind();
+    bench_lookup();
+
+    return Test::result();
+}
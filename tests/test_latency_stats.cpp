@@ -0,0 +1,207 @@
+#include "test.h"
+
+//
+// input latency histograms: bucket bounds, log-linear rounding and percentile extraction
+// also times adding a sample (the input hook's cost per series) and summarizing
+//
+
+using Latency::Histogram;
+using Latency::Summary;
+
+// bucket a value went in, through add() like the input hook
+static size_t bucket_of( uint64_t value ) {
+    Histogram           histogram;
+    Histogram::counts_t counts;
+
+    histogram.add( value );
+    histogram.get_counts( counts );
+
+    const auto it = std::find( counts.begin(), counts.end(), 1u );
+
+    return (size_t)( it - counts.begin() );
+}
+
+static void test_bounds() {
+    // small values are exact
+    for( uint32_t v = 0; v < Histogram::SUB_AMT; ++v ) {
+        CHECK( bucket_of( v ) == v );
+        CHECK( Histogram::get_bucket_min( v ) == v && Histogram::get_bucket_max( v ) == v );
+    }
+
+    // buckets are contiguous, cover every 32-bit value, and their bounds land in them
+    CHECK( Histogram::get_bucket_min( 0 ) == 0 );
+    CHECK( Histogram::get_bucket_max( Histogram::BUCKET_AMT - 1 ) == 0xFFFFFFFF );
+
+    for( size_t b = 0; b < Histogram::BUCKET_AMT; ++b ) {
+        const auto min = Histogram::get_bucket_min( b );
+        const auto max = Histogram::get_bucket_max( b );
+
+        CHECK( min <= max );
+
+        if( b + 1 < Histogram::BUCKET_AMT )
+            CHECK( Histogram::get_bucket_min( b + 1 ) == max + 1 );
+
+        CHECK( bucket_of( min ) == b );
+        CHECK( bucket_of( max ) == b );
+    }
+
+    // each power of 2 is SUB_AMT buckets, 16 - 31 are still exact, 32 - 63 are 2 wide
+    CHECK( bucket_of( 16 ) == 16 && bucket_of( 31 ) == 31 );
+    CHECK( bucket_of( 32 ) == 32 && bucket_of( 33 ) == 32 && bucket_of( 34 ) == 33 );
+    CHECK( Histogram::get_bucket_min( 48 ) == 64 && Histogram::get_bucket_max( 48 ) == 67 );
+
+    // values past 32 bits are clamped into the last bucket
+    CHECK( bucket_of( 0x100000000ull ) == Histogram::BUCKET_AMT - 1 );
+    CHECK( bucket_of( ~0ull ) == Histogram::BUCKET_AMT - 1 );
+}
+
+static void test_rounding() {
+    std::mt19937 rng( 15 );
+
+    double worst = 0.0;
+
+    for( size_t i = 0; i < 100000; ++i ) {
+        // spread over every magnitude
+        const auto v = (uint32_t)( rng() >> ( rng() % 32 ) );
+        const auto b = bucket_of( v );
+
+        const auto min = Histogram::get_bucket_min( b );
+        const auto max = Histogram::get_bucket_max( b );
+
+        CHECK( min <= v && v <= max );
+
+        // a value is reported as its bucket's max, never under it, and at most 1 / SUB_AMT over
+        if( v ) {
+            const auto error = (double)( max - v ) / (double)v;
+
+            CHECK( error < 1.0 / Histogram::SUB_AMT );
+
+            worst = std::max( worst, error );
+        }
+    }
+
+    Test::report( "worst rounding error", worst * 100.0, "%" );
+}
+
+static Summary summarize( const std::vector< uint64_t > &values ) {
+    Histogram           histogram;
+    Histogram::counts_t counts;
+
+    for( const auto v : values )
+        histogram.add( v );
+
+    histogram.get_counts( counts );
+
+    return Summary::from_counts( counts );
+}
+
+static void test_percentiles() {
+    // nothing
+    const auto empty = summarize( {} );
+
+    CHECK( empty.m_amt == 0 && empty.m_min == 0 && empty.m_p50 == 0 && empty.m_max == 0 );
+
+    // exact buckets, 10 samples: p50 is the 5th, p99 / p99.9 the 10th
+    const auto small = summarize( { 9, 0, 8, 1, 7, 2, 6, 3, 5, 4 } );
+
+    CHECK( small.m_amt == 10 );
+    CHECK( small.m_min == 0 && small.m_max == 9 );
+    CHECK( small.m_p50 == 4 );
+    CHECK( small.m_p99 == 9 && small.m_p999 == 9 );
+
+    // one sample
+    const auto one = summarize( { 1000 } );
+
+    CHECK( one.m_amt == 1 );
+    CHECK( one.m_min == Histogram::get_bucket_min( bucket_of( 1000 ) ) );
+    CHECK( one.m_p50 == Histogram::get_bucket_max( bucket_of( 1000 ) ) && one.m_p999 == one.m_p50 && one.m_max == one.m_p50 );
+
+    // 1000 samples, the tail sits exactly on the rank boundaries
+    // ranks are 500, 990 and 999, so 989 fast samples puts p99 in the slow bucket, 990 doesn't
+    std::vector< uint64_t > values( 990, 10 );
+
+    values.insert( values.end(), 9, 1000 );
+    values.push_back( 100000 );
+
+    auto tail = summarize( values );
+
+    CHECK( tail.m_amt == 1000 );
+    CHECK( tail.m_min == 10 && tail.m_p50 == 10 && tail.m_p99 == 10 );
+    CHECK( tail.m_p999 == Histogram::get_bucket_max( bucket_of( 1000 ) ) );
+    CHECK( tail.m_max == Histogram::get_bucket_max( bucket_of( 100000 ) ) );
+
+    values[ 0 ] = 1000;
+
+    tail = summarize( values );
+
+    CHECK( tail.m_p99 == Histogram::get_bucket_max( bucket_of( 1000 ) ) );
+
+    // random samples against exact percentiles, never under and at most one bucket width over
+    std::mt19937 rng( 16 );
+
+    for( size_t run = 0; run < 50; ++run ) {
+        std::vector< uint64_t > samples( 1 + rng() % 5000 );
+
+        for( auto &s : samples )
+            s = 1000 + rng() % ( 1 + rng() % 1000000 );
+
+        const auto summary = summarize( samples );
+
+        std::sort( samples.begin(), samples.end() );
+
+        const auto exact = [ & ]( uint64_t per_mille ) {
+            const auto rank = ( samples.size() * per_mille + 999 ) / 1000;
+
+            return samples[ std::max< uint64_t >( rank, 1 ) - 1 ];
+        };
+
+        const auto close = [ & ]( uint64_t reported, uint64_t value ) {
+            return reported == Histogram::get_bucket_max( bucket_of( value ) );
+        };
+
+        CHECK( summary.m_amt == samples.size() );
+        CHECK( summary.m_min == Histogram::get_bucket_min( bucket_of( samples.front() ) ) );
+        CHECK( close( summary.m_max, samples.back() ) );
+        CHECK( close( summary.m_p50, exact( 500 ) ) );
+        CHECK( close( summary.m_p99, exact( 990 ) ) );
+        CHECK( close( summary.m_p999, exact( 999 ) ) );
+    }
+}
+
+static void bench() {
+    constexpr size_t SAMPLES = 1 << 16;
+
+    std::mt19937 rng( 17 );
+
+    std::vector< uint64_t > values( SAMPLES );
+
+    for( auto &v : values )
+        v = 2000 + rng() % 50000;
+
+    Histogram histogram;
+
+    const auto add_ns = Test::time_ns( 20, [ & ]( size_t ) {
+        for( const auto v : values )
+            histogram.add( v );
+    } ) / SAMPLES;
+
+    Histogram::counts_t counts;
+
+    histogram.get_counts( counts );
+
+    const auto summary_ns = Test::time_ns( 1000, [ & ]( size_t ) {
+        Test::keep( Summary::from_counts( counts ) );
+    } );
+
+    Test::report( "Histogram::add", add_ns, "ns" );
+    Test::report( "Summary::from_counts", summary_ns / 1e3, "us" );
+}
+
+int main() {
+    test_bounds();
+    test_rounding();
+    test_percentiles();
+    bench();
+
+    return Test::result();
+}
@@ -0,0 +1,234 @@
+#include "test.h"
+
+//
+// compile-time perfect hash maps: lookups, the bounded seed search, and lookup speed against a switch and a linear search
+// the search has to stay under the compiler's constexpr step limit, random key sets up to MAX_KEYS are checked at run time
+//
+
+using namespace PerfectHash;
+
+// "key_00" .. "key_47", storage for the largest compile-time map
+static constexpr auto BIG_KEY_TEXT = []() {
+    std::array< std::array< char, 6 >, T::MAX_KEYS > out{};
+
+    for( size_t i = 0; i < out.size(); ++i )
+        out[ i ] = { 'k', 'e', 'y', '_', (char)( '0' + i / 10 ), (char)( '0' + i % 10 ) };
+
+    return out;
+}();
+
+static constexpr auto BIG_MAP = []() {
+    std::array< Entry< char, uint32_t >, T::MAX_KEYS > entries{};
+
+    for( size_t i = 0; i < entries.size(); ++i )
+        entries[ i ] = { std::string_view( BIG_KEY_TEXT[ i ].data(), BIG_KEY_TEXT[ i ].size() ), (uint32_t)i };
+
+    return Map< char, uint32_t, T::MAX_KEYS >( entries );
+}();
+
+static_assert( BIG_MAP.is_valid(), "a map with MAX_KEYS keys must build at compile time" );
+
+static constexpr auto FOLD_MAP = make_map< char, int, true >( {
+    { "true",  1 },
+    { "False", 0 },
+    { "on",    1 }
+} );
+
+static void test_find() {
+    // every key, nothing else
+    for( size_t i = 0; i < BIG_KEY_TEXT.size(); ++i ) {
+        const auto key   = std::string_view( BIG_KEY_TEXT[ i ].data(), BIG_KEY_TEXT[ i ].size() );
+        const auto value = BIG_MAP.find( key );
+
+        CHECK( value && *value == i );
+        CHECK( BIG_MAP.find( key, FNV1aHash::get_32( key ) ) == value );
+    }
+
+    CHECK( !BIG_MAP.find( "key_48" ) );
+    CHECK( !BIG_MAP.find( "key_0" ) );
+    CHECK( !BIG_MAP.find( "" ) );
+
+    // folded maps ignore case, the hash passed in must be folded too
+    CHECK( FOLD_MAP.find( "TRUE" ) && *FOLD_MAP.find( "TRUE" ) == 1 );
+    CHECK( FOLD_MAP.find( "false" ) && *FOLD_MAP.find( "false" ) == 0 );
+    CHECK( FOLD_MAP.find( "oN", FNV1aHash::get_32_fold( std::string_view( "oN" ) ) ) );
+    CHECK( !FOLD_MAP.find( "off" ) );
+}
+
+// n random keys, built at run time, the constructor is the same code the compiler runs
+template< size_t n > static void test_random_sets( std::mt19937 &rng ) {
+    constexpr size_t SETS = 200;
+
+    uint32_t worst_seed = 0;
+
+    for( size_t s = 0; s < SETS; ++s ) {
+        std::vector< std::string > keys;
+
+        for( size_t i = 0; i < n; ++i )
+            keys.push_back( "value_" + std::to_string( rng() % 100000 ) + "_" + std::to_string( i ) );
+
+        std::array< Entry< char, uint32_t >, n > entries{};
+
+        for( size_t i = 0; i < n; ++i )
+            entries[ i ] = { keys[ i ], (uint32_t)i };
+
+        const auto map = Map< char, uint32_t, n >( entries );
+
+        CHECK( map.is_valid() );
+
+        for( size_t i = 0; i < n; ++i )
+            CHECK( map.find( keys[ i ] ) && *map.find( keys[ i ] ) == i );
+
+        CHECK( !map.find( "value_" ) );
+
+        worst_seed = std::max( worst_seed, map.get_seed() );
+    }
+
+    const auto name = "seed search, " + std::to_string( n ) + " keys, worst of 200 sets";
+
+    Test::report( name.c_str(), worst_seed, "seeds" );
+}
+
+static void test_seed_search() {
+    std::mt19937 rng( 11 );
+
+    test_random_sets< 8 >( rng );
+    test_random_sets< Config::SCHEMA.size() >( rng );
+    test_random_sets< 32 >( rng );
+    test_random_sets< T::MAX_KEYS >( rng );
+
+    // duplicate keys never fit, the search gives up after MAX_TRIES instead of running every seed
+    const auto dup = Map< char, int, 3 >( { { { "a", 1 }, { "b", 2 }, { "a", 3 } } } );
+
+    CHECK( !dup.is_valid() );
+}
+
+//
+// lookup speed, schema field names plus as many unknown names
+//
+
+static constexpr auto FIELD_NAMES = []() {
+    std::array< Entry< wchar_t, int32_t >, Config::SCHEMA.size() > entries{};
+
+    for( size_t i = 0; i < Config::SCHEMA.size(); ++i )
+        entries[ i ] = { Config::SCHEMA[ i ].m_name, (int32_t)i };
+
+    return Map< wchar_t, int32_t, Config::SCHEMA.size() >( entries );
+}();
+
+static NOINLINE int32_t find_perfect( std::wstring_view key ) {
+    const auto index = FIELD_NAMES.find( key );
+
+    return index ? *index : -1;
+}
+
+// the reader hands out name hashes, config bind passes them in
+static NOINLINE int32_t find_perfect_hashed( std::wstring_view key, hash32_t hash ) {
+    const auto index = FIELD_NAMES.find( key, hash );
+
+    return index ? *index : -1;
+}
+
+// switch on the hash, then compare, how lookups were written before the perfect hash
+static NOINLINE int32_t find_switch( std::wstring_view key ) {
+    #define FIELD_CASE( name, index ) \
+        case (uint32_t)CT_HASH_32( L"" name ): return ( key == std::wstring_view( L"" name ) ) ? index : -1;
+
+    switch( (uint32_t)FNV1aHash::get_32( key ) ) {
+        FIELD_CASE( "rebind_keys", 0 )
+        FIELD_CASE( "signature_report", 1 )
+        FIELD_CASE( "hot_reload", 2 )
+        FIELD_CASE( "record_input", 3 )
+        FIELD_CASE( "record_raw_input", 4 )
+        FIELD_CASE( "replay_input", 5 )
+        FIELD_CASE( "replay_start_key", 6 )
+        FIELD_CASE( "replay_start_frame", 7 )
+        FIELD_CASE( "KEY_UP", 8 )
+        FIELD_CASE( "KEY_DOWN", 9 )
+        FIELD_CASE( "KEY_LEFT", 10 )
+        FIELD_CASE( "KEY_RIGHT", 11 )
+        FIELD_CASE( "KEY_START", 12 )
+        FIELD_CASE( "KEY_PAUSE", 13 )
+        FIELD_CASE( "KEY_SELECT", 14 )
+        FIELD_CASE( "KEY_RESTART", 15 )
+        FIELD_CASE( "KEY_BACK", 16 )
+        FIELD_CASE( "KEY_JUMP", 17 )
+        FIELD_CASE( "KEY_HOOK", 18 )
+        FIELD_CASE( "KEY_L", 19 )
+        FIELD_CASE( "KEY_R", 20 )
+        FIELD_CASE( "KEY_SKIP", 21 )
+
+        default: {
+            return -1;
+        }
+    }
+
+    #undef FIELD_CASE
+}
+
+static NOINLINE int32_t find_linear( std::wstring_view key ) {
+    for( size_t i = 0; i < Config::SCHEMA.size(); ++i ) {
+        if( Config::SCHEMA[ i ].m_name == key )
+            return (int32_t)i;
+    }
+
+    return -1;
+}
+
+static void bench_lookup() {
+    constexpr size_t LOOKUPS = 1 << 16;
+
+    std::vector< std::wstring > names;
+
+    for( const auto &f : Config::SCHEMA )
+        names.emplace_back( f.m_name );
+
+    // unknown names, some close to real ones
+    for( size_t i = 0; i < Config::SCHEMA.size(); ++i )
+        names.push_back( ( i % 2 ) ? L"KEY_PLUGIN_" + std::to_wstring( i ) : L"plugin_value" + std::to_wstring( i ) );
+
+    std::mt19937 rng( 12 );
+
+    std::vector< std::pair< std::wstring_view, hash32_t > > keys;
+
+    for( size_t i = 0; i < LOOKUPS; ++i ) {
+        const auto &name = names[ rng() % names.size() ];
+
+        keys.emplace_back( name, FNV1aHash::get_32( std::wstring_view( name ) ) );
+    }
+
+    // all agree
+    for( const auto &name : names ) {
+        const auto index = find_linear( name );
+
+        CHECK( find_perfect( name ) == index );
+        CHECK( find_perfect_hashed( name, FNV1aHash::get_32( std::wstring_view( name ) ) ) == index );
+        CHECK( find_switch( name ) == index );
+    }
+
+    const auto run = [ & ]( const char *name, auto &&find ) {
+        const auto ns = Test::time_ns( 20, [ & ]( size_t ) {
+            int32_t sum = 0;
+
+            for( const auto &[ key, hash ] : keys )
+                sum += find( key, hash );
+
+            Test::keep( sum );
+        } );
+
+        Test::report( name, ns / LOOKUPS, "ns/lookup" );
+    };
+
+    run( "field lookup, perfect hash", []( std::wstring_view key, hash32_t ) { return find_perfect( key ); } );
+    run( "field lookup, perfect hash, hash given", []( std::wstring_view key, hash32_t hash ) { return find_perfect_hashed( key, hash ); } );
+    run( "field lookup, switch on hash", []( std::wstring_view key, hash32_t ) { return find_switch( key ); } );
+    run( "field lookup, linear search", []( std::wstring_view key, hash32_t ) { return find_linear( key ); } );
+}
+
+int main() {
+    test_find();
+    test_seed_search();
+    bench_lookup();
+
+    return Test::result();
+}
@@ -0,0 +1,218 @@
+#include "test.h"
+#include "sig_report.h"
+
+#include <fstream>
+
+//
+// signature report on made up game builds
+// a minimal 32-bit PE with the UmiharaKawase signatures in its code section, a copy with a duplicate match and a broken file
+//
+
+// image layout
+constexpr uint32_t IMAGE_BASE   = 0x400000;
+constexpr uint32_t HEADERS_SIZE = 0x400;
+constexpr uint32_t CODE_RVA     = 0x1000;
+constexpr uint32_t CODE_SIZE    = 0x1000;
+constexpr uint32_t RDATA_RVA    = 0x2000;
+constexpr uint32_t RDATA_SIZE   = 0x200;
+
+// where the signatures are placed / resolve to
+constexpr uint32_t GAME_NAME_RVA     = CODE_RVA;
+constexpr uint32_t INPUT_HANDLER_RVA = CODE_RVA + 0x40;
+constexpr uint32_t KEY_LIST_RVA      = CODE_RVA + 0x80;
+constexpr uint32_t HANDLER_FUNC_RVA  = CODE_RVA + 0x100;
+constexpr uint32_t DUPE_KEY_LIST_RVA = CODE_RVA + 0x200;
+constexpr uint32_t NAME_STR_RVA      = RDATA_RVA;
+constexpr uint32_t KEYS_RVA          = RDATA_RVA + 0xB4;
+
+static const auto g_dir = std_fs::temp_directory_path() / "umi_test_sig_report";
+
+static void put_u32( std::vector< uint8_t > &file, size_t offset, uint32_t value ) {
+    std::memcpy( &file[ offset ], &value, sizeof( value ) );
+}
+
+static void put_bytes( std::vector< uint8_t > &file, size_t offset, std::initializer_list< uint8_t > bytes ) {
+    std::copy( bytes.begin(), bytes.end(), file.begin() + offset );
+}
+
+// file offset of a code / rdata RVA
+static size_t code_offset( uint32_t rva ) {
+    return HEADERS_SIZE + rva - CODE_RVA;
+}
+
+static size_t rdata_offset( uint32_t rva ) {
+    return HEADERS_SIZE + CODE_SIZE + rva - RDATA_RVA;
+}
+
+static std::vector< uint8_t > make_image( bool dupe_key_list ) {
+    std::vector< uint8_t > file( HEADERS_SIZE + CODE_SIZE + RDATA_SIZE, 0 );
+
+    // headers
+    IMAGE_DOS_HEADER dos{};
+    IMAGE_NT_HEADERS nt{};
+
+    dos.e_magic  = IMAGE_DOS_SIGNATURE;
+    dos.e_lfanew = 0x80;
+
+    nt.Signature                       = IMAGE_NT_SIGNATURE;
+    nt.FileHeader.Machine              = 0x14C;
+    nt.FileHeader.NumberOfSections     = 2;
+    nt.FileHeader.SizeOfOptionalHeader = sizeof( IMAGE_OPTIONAL_HEADER );
+    nt.OptionalHeader.Magic            = IMAGE_NT_OPTIONAL_HDR_MAGIC;
+    nt.OptionalHeader.SizeOfCode       = CODE_SIZE;
+    nt.OptionalHeader.BaseOfCode       = CODE_RVA;
+    nt.OptionalHeader.ImageBase        = IMAGE_BASE;
+    nt.OptionalHeader.SizeOfImage      = RDATA_RVA + 0x1000;
+    nt.OptionalHeader.SizeOfHeaders    = HEADERS_SIZE;
+
+    std::array< IMAGE_SECTION_HEADER, 2 > sections{};
+
+    sections[ 0 ].Misc.VirtualSize   = CODE_SIZE;
+    sections[ 0 ].VirtualAddress     = CODE_RVA;
+    sections[ 0 ].SizeOfRawData      = CODE_SIZE;
+    sections[ 0 ].PointerToRawData   = HEADERS_SIZE;
+    sections[ 1 ].Misc.VirtualSize   = RDATA_SIZE;
+    sections[ 1 ].VirtualAddress     = RDATA_RVA;
+    sections[ 1 ].SizeOfRawData      = RDATA_SIZE;
+    sections[ 1 ].PointerToRawData   = HEADERS_SIZE + CODE_SIZE;
+
+    std::memcpy( &file[ 0 ], &dos, sizeof( dos ) );
+    std::memcpy( &file[ dos.e_lfanew ], &nt, sizeof( nt ) );
+    std::memcpy( &file[ dos.e_lfanew + sizeof( nt ) ], sections.data(), sizeof( sections ) );
+
+    // code, int3 padding
+    std::fill( file.begin() + code_offset( CODE_RVA ), file.begin() + code_offset( CODE_RVA + CODE_SIZE ), 0xCC );
+
+    // movzx ecx, word ptr [edx + name]
+    put_bytes( file, code_offset( GAME_NAME_RVA ), { 0x0F, 0xB7, 0x8A, 0, 0, 0, 0, 0x66, 0x85, 0xC9, 0x75, 0xEA, 0x33, 0xC9, 0x66, 0x89, 0x0C, 0x46, 0xEB, 0x77 } );
+    put_u32( file, code_offset( GAME_NAME_RVA ) + 3, IMAGE_BASE + NAME_STR_RVA );
+
+    // call input handler
+    put_bytes( file, code_offset( INPUT_HANDLER_RVA ), { 0xE8, 0, 0, 0, 0, 0xB8, 0, 0, 0, 0, 0x8B, 0xFF } );
+    put_u32( file, code_offset( INPUT_HANDLER_RVA ) + 1, HANDLER_FUNC_RVA - ( INPUT_HANDLER_RVA + 5 ) );
+
+    put_bytes( file, code_offset( HANDLER_FUNC_RVA ), { 0xC3 } );
+
+    // mov eax, ...
+    // the key_list chain reads the pointer at the match itself, so its low byte is the mov opcode
+    static_assert( ( ( IMAGE_BASE + KEYS_RVA + 4 ) & 0xFF ) == 0xB8 );
+
+    for( const auto rva : { KEY_LIST_RVA, DUPE_KEY_LIST_RVA } ) {
+        if( rva == DUPE_KEY_LIST_RVA && !dupe_key_list )
+            continue;
+
+        put_bytes( file, code_offset( rva ), { 0xB8, 0, 0, 0, 0, 0x8D, 0x9B, 0, 0, 0, 0 } );
+        put_u32( file, code_offset( rva ), IMAGE_BASE + KEYS_RVA + 4 );
+    }
+
+    // game name, UTF-16
+    const std::u16string_view name = u"UmiharaKawase";
+
+    std::memcpy( &file[ rdata_offset( NAME_STR_RVA ) ], name.data(), name.size() * sizeof( char16_t ) );
+
+    return file;
+}
+
+static void write_file( const std_fs::path &path, const std::vector< uint8_t > &data ) {
+    std::ofstream( path, std::ios::binary ).write( (const char *)data.data(), (std::streamsize)data.size() );
+}
+
+static std::vector< std::string > read_lines( const std_fs::path &path ) {
+    std::ifstream            file( path );
+    std::vector< std::string > out;
+
+    for( std::string line; std::getline( file, line ); )
+        out.push_back( line );
+
+    return out;
+}
+
+// lines for a file, optionally only the ones containing str
+static size_t count_lines( const std::vector< std::string > &lines, std::string_view file, std::string_view str = {} ) {
+    const auto file_field = "\"file\":\"" + std::string( file ) + "\"";
+
+    return (size_t)std::count_if( lines.begin(), lines.end(),
+        [ & ]( const std::string &line ) {
+            return line.find( file_field ) != std::string::npos && line.find( str ) != std::string::npos;
+        }
+    );
+}
+
+static void test_report() {
+    const auto good  = g_dir / "kawase.exe";
+    const auto dupe  = g_dir / "sub" / "dupe.exe";
+    const auto bad   = g_dir / "bad.exe";
+    const auto odd   = g_dir / "odd\x01\"name.exe";
+    const auto notes = g_dir / "notes.txt";
+    const auto out   = g_dir / "report.json";
+
+    std_fs::remove_all( g_dir );
+    std_fs::create_directories( g_dir / "sub" );
+
+    write_file( good, make_image( false ) );
+    write_file( dupe, make_image( true ) );
+    write_file( bad, { 'M', 'Z', 0, 0 } );
+    write_file( odd, make_image( false ) );
+    write_file( notes, { 'x' } );
+
+    const auto start      = std::chrono::steady_clock::now();
+    const auto failed_amt = SigReport::run( g_dir, out );
+    const auto ms         = std::chrono::duration< double, std::milli >( std::chrono::steady_clock::now() - start ).count();
+
+    // not unique in dupe.exe, bad.exe isn't a PE file
+    CHECK( failed_amt == 2 );
+
+    const auto lines = read_lines( out );
+
+    // valid JSON strings: no control chars, quotes escaped
+    for( const auto &line : lines ) {
+        CHECK( line.front() == '{' && line.back() == '}' );
+        CHECK( std::none_of( line.begin(), line.end(), []( char c ) { return (uint8_t)c < 0x20; } ) );
+    }
+
+    const auto sig_amt = Signatures::get_all().size();
+
+    const auto good_str = good.string();
+    const auto dupe_str = dupe.string();
+    const auto bad_str  = bad.string();
+    const auto odd_str  = ( g_dir / "odd\\u0001\\\"name.exe" ).string();
+
+    // one game line + one per signature
+    CHECK( count_lines( lines, good_str ) == 1 + sig_amt );
+    CHECK( count_lines( lines, dupe_str ) == 1 + sig_amt );
+    CHECK( count_lines( lines, odd_str ) == 1 + sig_amt );
+    CHECK( count_lines( lines, bad_str, "\"error\":\"invalid PE file\"" ) == 1 );
+    CHECK( count_lines( lines, "notes.txt" ) == 0 );
+
+    // identified from the game name string
+    CHECK( count_lines( lines, good_str, "\"game\":0,\"batch_us\"" ) == 1 );
+
+    // resolved through the offset chains, the first match is reported
+    const auto key_list_line = []( bool unique ) {
+        return fmt::format( "\"sig\":\"key_list\",\"sig_game\":-1,\"for_game\":true,\"matches\":{},\"unique\":{},\"match_rva\":\"0x{:X}\",\"resolved_rva\":\"0x{:X}\"",
+            unique ? 1 : 2, unique, KEY_LIST_RVA, KEYS_RVA );
+    };
+
+    CHECK( count_lines( lines, good_str, "\"sig\":\"game_name\",\"sig_game\":-1,\"for_game\":true,\"matches\":1,\"unique\":true,\"match_rva\":\"0x1000\",\"resolved_rva\":\"0x2000\"" ) == 1 );
+    CHECK( count_lines( lines, good_str, "\"sig\":\"input_handler\",\"sig_game\":-1,\"for_game\":true,\"matches\":1,\"unique\":true,\"match_rva\":\"0x1040\",\"resolved_rva\":\"0x1100\"" ) == 1 );
+    CHECK( count_lines( lines, good_str, key_list_line( true ) ) == 1 );
+    CHECK( count_lines( lines, dupe_str, key_list_line( false ) ) == 1 );
+
+    // other games' signatures don't count
+    CHECK( count_lines( lines, good_str, "\"for_game\":false" ) == count_lines( lines, good_str, "\"sig_game\":" ) - 3 );
+
+    Test::report( "report, 4 builds", ms, "ms" );
+
+    std_fs::remove_all( g_dir );
+}
+
+static void test_bad_dir() {
+    CHECK( SigReport::run( g_dir / "missing", g_dir / "report.json" ) == -1 );
+}
+
+int main() {
+    test_report();
+    test_bad_dir();
+
+    return Test::result();
+}
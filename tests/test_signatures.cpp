@@ -0,0 +1,133 @@
+#include "test.h"
+#include "signatures.h"
+#include "pattern_scan.h"
+#include "ext_pattern.h"
+
+//
+// merged signatures against the per-game signatures they replaced
+// every instance of an old pattern must be found at the same address and resolve to the same result
+//
+
+using namespace Signatures;
+
+// the per-game signatures before they were merged
+static const std::vector< Signature > g_old_signatures = {
+    { SIG_INPUT_HANDLER, UMI_GAME_KAWASE, "input_handler", "E8 ? ? ? ? B8 ? ? ? ? 8B FF", { { { STEP_FOLLOW_REL, 0 } } }, 1 },
+    { SIG_KEY_LIST, UMI_GAME_KAWASE, "key_list", "B8 ? ? ? ? 8D 9B ? ? ? ?", { { { STEP_DEREF, 0 }, { STEP_ADD, -4 } } }, 2 },
+
+    { SIG_INPUT_HANDLER, UMI_GAME_KAWASE_SHUN, "input_handler", "E8 ? ? ? ? FF 35 ? ? ? ? 8B 35 ? ? ? ?", { { { STEP_FOLLOW_REL, 0 } } }, 1 },
+    { SIG_KEY_LIST, UMI_GAME_KAWASE_SHUN, "key_list", "B8 ? ? ? ? EB 08", { { { STEP_DEREF, 0 }, { STEP_ADD, -4 } } }, 2 },
+
+    { SIG_INPUT_HANDLER, UMI_GAME_SAYONARA_KAWASE, "input_handler", "E8 ? ? ? ? FF 35 ? ? ? ? 8B 35 ? ? ? ?", { { { STEP_FOLLOW_REL, 0 } } }, 1 },
+    { SIG_KEY_LIST, UMI_GAME_SAYONARA_KAWASE, "key_list", "89 86 ? ? ? ? B8 ? ? ? ? EB 08", { { { STEP_ADD, 7 }, { STEP_DEREF, 0 }, { STEP_ADD, -4 } } }, 3 }
+};
+
+// bytes matching a pattern, wildcards are random
+static std::vector< uint8_t > make_instance( std::mt19937 &rng, const PatternScan::Build::Pattern &pattern ) {
+    std::vector< uint8_t > out;
+
+    for( auto it = pattern.cbegin(); it != pattern.cend(); ++it )
+        out.push_back( it->is_wildcard() ? (uint8_t)rng() : it->get_byte() );
+
+    return out;
+}
+
+static void test_old_instances() {
+    std::mt19937 rng( 12 );
+
+    for( const auto &old : g_old_signatures ) {
+        const auto sig = get( old.m_game_id, old.m_id );
+
+        CHECK( sig != nullptr );
+
+        if( !sig )
+            continue;
+
+        const auto pattern = PatternScan::Build::Pattern( old.m_pattern );
+
+        for( size_t iter = 0; iter < 500; ++iter ) {
+            // int3 padding around a single instance
+            std::vector< uint8_t > data( 256, 0xCC );
+
+            const auto pos      = rng() % ( data.size() - pattern.size() );
+            const auto instance = make_instance( rng, pattern );
+
+            std::copy( instance.begin(), instance.end(), data.begin() + pos );
+
+            const auto start     = (uintptr_t)data.data();
+            const auto old_match = PatternScan::find( start, data.size(), old.m_pattern );
+            const auto match     = PatternScan::find( start, data.size(), sig->m_pattern );
+
+            CHECK( old_match == start + pos );
+            CHECK( match == old_match );
+
+            // same offset chain result
+            // note: dereferenced pointers are only compared, never read
+            CHECK( resolve_chain( *sig, match ) == resolve_chain( old, old_match ) );
+        }
+    }
+}
+
+static void test_table() {
+    // every game has every signature
+    for( const auto game_id : { UMI_GAME_KAWASE, UMI_GAME_KAWASE_SHUN, UMI_GAME_SAYONARA_KAWASE } ) {
+        for( const auto id : { SIG_GAME_NAME, SIG_INPUT_HANDLER, SIG_KEY_LIST } )
+            CHECK( get( game_id, id ) != nullptr );
+    }
+
+    // one input handler for all games, the key list is shared by all but Sayonara
+    CHECK( get( UMI_GAME_KAWASE, SIG_INPUT_HANDLER ) == get( UMI_GAME_SAYONARA_KAWASE, SIG_INPUT_HANDLER ) );
+    CHECK( get( UMI_GAME_KAWASE, SIG_KEY_LIST ) == get( UMI_GAME_KAWASE_SHUN, SIG_KEY_LIST ) );
+    CHECK( get( UMI_GAME_KAWASE, SIG_KEY_LIST ) != get( UMI_GAME_SAYONARA_KAWASE, SIG_KEY_LIST ) );
+
+    // every pattern parses
+    for( const auto &s : get_all() ) {
+        const auto valid = PatternScan::Build::ExtPattern::is_extended( s.m_pattern ) ? (bool)PatternScan::Build::ExtPattern( s.m_pattern ) : (bool)PatternScan::Build::Pattern( s.m_pattern );
+
+        CHECK( valid );
+    }
+}
+
+static void bench_scan() {
+    constexpr size_t SIZE = 8 << 20;
+
+    std::mt19937           rng( 13 );
+    std::vector< uint8_t > data( SIZE );
+
+    // no call / mov opcodes, so every scan covers the whole buffer
+    for( auto &b : data ) {
+        b = (uint8_t)rng();
+
+        if( b == 0xE8 || b == 0xB8 )
+            b = 0xCC;
+    }
+
+    // what init_thread scans for UmiharaKawase, merged vs the old pattern
+    for( const auto &old : { g_old_signatures[ 0 ], g_old_signatures[ 1 ] } ) {
+        const auto sig = get( old.m_game_id, old.m_id );
+
+        CHECK( !PatternScan::find( (uintptr_t)data.data(), SIZE, sig->m_pattern ) );
+
+        const auto old_ns = Test::time_ns( 1, [ & ]( size_t ) {
+            Test::keep( PatternScan::find( (uintptr_t)data.data(), SIZE, old.m_pattern ) );
+        } );
+
+        const auto ns = Test::time_ns( 1, [ & ]( size_t ) {
+            Test::keep( PatternScan::find( (uintptr_t)data.data(), SIZE, sig->m_pattern ) );
+        } );
+
+        const auto old_name = "8 MiB scan, " + std::string( old.m_name ) + ", per-game";
+        const auto name     = "8 MiB scan, " + std::string( old.m_name ) + ", merged";
+
+        Test::report( old_name.c_str(), old_ns / 1e6, "ms" );
+        Test::report( name.c_str(), ns / 1e6, "ms" );
+    }
+}
+
+int main() {
+    test_old_instances();
+    test_table();
+    bench_scan();
+
+    return Test::result();
+}
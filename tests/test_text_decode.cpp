@@ -0,0 +1,264 @@
+#include "test.h"
+#include "text_decode.h"
+#include "ini_reader.h"
+
+//
+// text decoding: BOM detection, UTF-16LE / BE, invalid UTF-8, and non-ASCII text surviving the whitespace strip
+// also times decoding 1 MiB of text in each encoding
+//
+
+using namespace TextDecode;
+
+using bytes_t = std::vector< uint8_t >;
+
+static std::wstring decode_wide( const bytes_t &bytes, Encoding encoding ) {
+    std::vector< wchar_t > out;
+
+    decode( bytes.data(), bytes.size(), encoding, out );
+
+    return std::wstring( out.data(), out.size() );
+}
+
+static std::string decode_narrow( const bytes_t &bytes, Encoding encoding ) {
+    std::vector< char > out;
+
+    decode( bytes.data(), bytes.size(), encoding, out );
+
+    return std::string( out.data(), out.size() );
+}
+
+// UTF-16 code units to bytes
+static bytes_t utf16_bytes( std::u16string_view str, bool big_endian ) {
+    bytes_t out;
+
+    for( const auto c : str ) {
+        const auto hi = (uint8_t)( c >> 8 );
+        const auto lo = (uint8_t)c;
+
+        out.push_back( big_endian ? hi : lo );
+        out.push_back( big_endian ? lo : hi );
+    }
+
+    return out;
+}
+
+static bool detected( const bytes_t &bytes, Encoding encoding, size_t bom_size ) {
+    const auto d = detect( bytes.data(), bytes.size() );
+
+    return d.m_encoding == encoding && d.m_bom_size == bom_size;
+}
+
+static void test_detect() {
+    // BOMs
+    CHECK( detected( { 0xEF, 0xBB, 0xBF, '[' }, ENC_UTF8, 3 ) );
+    CHECK( detected( { 0xFF, 0xFE, '[', 0 }, ENC_UTF16LE, 2 ) );
+    CHECK( detected( { 0xFE, 0xFF, 0, '[' }, ENC_UTF16BE, 2 ) );
+
+    // no BOM, guessed from the first code unit
+    CHECK( detected( { '[', 0, 's', 0 }, ENC_UTF16LE, 0 ) );
+    CHECK( detected( { 0, '[', 0, 's' }, ENC_UTF16BE, 0 ) );
+    CHECK( detected( { '[', 's' }, ENC_UTF8, 0 ) );
+
+    // too short for anything but UTF-8
+    CHECK( detected( {}, ENC_UTF8, 0 ) );
+    CHECK( detected( { 0xFF }, ENC_UTF8, 0 ) );
+    CHECK( detected( { 0xEF, 0xBB }, ENC_UTF8, 0 ) );
+}
+
+static void test_utf16() {
+    const auto str = std::u16string( u"k\u00E9y=\u3042\U0001F600" );
+
+    for( const auto big_endian : { false, true } ) {
+        const auto encoding = big_endian ? ENC_UTF16BE : ENC_UTF16LE;
+        const auto bytes    = utf16_bytes( str, big_endian );
+
+        // wide output keeps the code units, surrogate pairs included
+        const auto wide = decode_wide( bytes, encoding );
+
+        CHECK( wide.size() == str.size() );
+        CHECK( std::equal( wide.begin(), wide.end(), str.begin(), []( wchar_t a, char16_t b ) { return (uint32_t)a == (uint32_t)b; } ) );
+
+        // narrow output is UTF-8
+        CHECK( decode_narrow( bytes, encoding ) == "k\xC3\xA9y=\xE3\x81\x82\xF0\x9F\x98\x80" );
+
+        // an odd trailing byte is dropped
+        auto odd = bytes;
+
+        odd.push_back( 'x' );
+
+        CHECK( decode_wide( odd, encoding ) == wide );
+
+        // newline is found in either byte order, the offset is in bytes
+        const auto lines = utf16_bytes( u"ab\ncd", big_endian );
+
+        CHECK( find_newline( lines.data(), lines.size(), encoding ) == 4 );
+        CHECK( find_newline( bytes.data(), bytes.size(), encoding ) == bytes.size() );
+
+        // unpaired surrogates become replacement chars when converting to UTF-8
+        CHECK( decode_narrow( utf16_bytes( u"\xD800x\xDC00", big_endian ), encoding ) == "\xEF\xBF\xBDx\xEF\xBF\xBD" );
+
+        // and back
+        bytes_t encoded;
+
+        encode( std::string_view( "k\xC3\xA9y=\xE3\x81\x82\xF0\x9F\x98\x80" ), encoding, encoded );
+
+        CHECK( encoded == bytes );
+    }
+}
+
+static void test_utf8() {
+    const auto wide = []( std::string_view bytes ) {
+        return decode_wide( bytes_t( bytes.begin(), bytes.end() ), ENC_UTF8 );
+    };
+
+    // valid 1 - 4 byte sequences, code points above U+FFFF become surrogate pairs
+    CHECK( wide( "a\xC3\xA9\xE3\x81\x82\xF0\x9F\x98\x80" ) == L"a\xE9\x3042\xD83D\xDE00" );
+
+    // ASCII around a multi-byte sequence
+    CHECK( wide( "abcdefghijklmnopq\xC3\xA9r" ) == L"abcdefghijklmnopq\xE9r" );
+
+    // invalid sequences are replaced one byte at a time
+    CHECK( wide( "\x80" "a" ) == L"\xFFFD" L"a" );                    // lone continuation byte
+    CHECK( wide( "\xFF" "a" ) == L"\xFFFD" L"a" );                    // not a lead byte
+    CHECK( wide( "\xC3" "a" ) == L"\xFFFD" L"a" );                    // missing continuation
+    CHECK( wide( "\xE3\x81" ) == L"\xFFFD\xFFFD" );                   // truncated at the end
+    CHECK( wide( "\xC0\xAF" ) == L"\xFFFD\xFFFD" );                   // overlong '/'
+    CHECK( wide( "\xE0\x80\xAF" ) == L"\xFFFD\xFFFD\xFFFD" );          // overlong, 3 bytes
+    CHECK( wide( "\xED\xA0\x80" ) == L"\xFFFD\xFFFD\xFFFD" );          // surrogate
+    CHECK( wide( "\xF4\x90\x80\x80" ) == L"\xFFFD\xFFFD\xFFFD\xFFFD" ); // above U+10FFFF
+
+    // the narrow path copies UTF-8 as is, invalid bytes included
+    CHECK( decode_narrow( { 0x80, 'a' }, ENC_UTF8 ) == "\x80" "a" );
+
+    // appends
+    std::vector< wchar_t > out = { L'x' };
+
+    decode( (const uint8_t *)"yz", 2, ENC_UTF8, out );
+
+    CHECK( std::wstring( out.data(), out.size() ) == L"xyz" );
+}
+
+// whole file through the reader, in each encoding
+static void test_reader() {
+    const auto path = std_fs::temp_directory_path() / "umi_test_text_decode.ini";
+
+    // U+0120 / U+0109 have the low byte of a space / tab, U+3000 / U+200A are unicode spaces
+    // only ASCII whitespace is stripped, everything else is part of the name / value
+    const auto text = std::u16string( u" [s\u0120] \r\n a = \u0109x\u3000y\u200A \r\nb=\u00E9\r\n" );
+
+    const auto write = [ & ]( const bytes_t &bom, const bytes_t &body ) {
+        std::ofstream file( path, std::ios::binary );
+
+        file.write( (const char *)bom.data(), (std::streamsize)bom.size() );
+        file.write( (const char *)body.data(), (std::streamsize)body.size() );
+    };
+
+    bytes_t utf8;
+
+    encode( std::wstring( text.begin(), text.end() ), ENC_UTF8, utf8 );
+
+    for( size_t i = 0; i < 5; ++i ) {
+        if( i == 0 ) write( {}, utf8 );
+        if( i == 1 ) write( { 0xEF, 0xBB, 0xBF }, utf8 );
+        if( i == 2 ) write( { 0xFF, 0xFE }, utf16_bytes( text, false ) );
+        if( i == 3 ) write( { 0xFE, 0xFF }, utf16_bytes( text, true ) );
+        if( i == 4 ) write( {}, utf16_bytes( text, false ) );
+
+        INIReader reader( path.wstring() );
+
+        std::vector< std::pair< std::wstring, std::wstring > > values;
+
+        CHECK( reader.for_each( [ & ]( const INIReader::Event &e ) {
+            CHECK( e.m_section == L"s\u0120" );
+
+            values.emplace_back( e.m_value->get_value_name(), e.m_value->get_str() );
+
+            return true;
+        } ) );
+
+        CHECK( values.size() == 2 );
+
+        if( values.size() != 2 )
+            continue;
+
+        CHECK( values[ 0 ].first == L"a" && values[ 0 ].second == L"\u0109x\u3000y\u200A" );
+        CHECK( values[ 1 ].first == L"b" && values[ 1 ].second == L"\u00E9" );
+    }
+
+    std_fs::remove( path );
+
+    // the C locale set, nothing else
+    for( uint32_t c = 0; c < 0x10000; ++c )
+        CHECK( INIParser::is_space( c ) == ( c == ' ' || c == '\t' || c == '\n' || c == '\v' || c == '\f' || c == '\r' ) );
+}
+
+static void bench_decode() {
+    constexpr size_t SIZE = 1 << 20;
+
+    std::mt19937 rng( 7 );
+
+    // INI-like ASCII, and Japanese text (3 byte sequences) with ASCII in between
+    std::string ascii, mixed;
+
+    while( ascii.size() < SIZE )
+        ascii += "KEY_" + std::to_string( rng() % 1000 ) + " = 0x" + std::to_string( rng() % 100 ) + "\r\n";
+
+    while( mixed.size() < SIZE )
+        mixed += ( rng() % 2 ) ? "\xE3\x81\x82\xE3\x81\x84 = " : "key = \xE6\x97\xA5\r\n";
+
+    bytes_t utf16le, utf16be;
+
+    encode( std::string_view( ascii ), ENC_UTF16LE, utf16le );
+    encode( std::string_view( ascii ), ENC_UTF16BE, utf16be );
+
+    const auto ascii_bytes = bytes_t( ascii.begin(), ascii.end() );
+    const auto mixed_bytes = bytes_t( mixed.begin(), mixed.end() );
+
+    const std::array< std::tuple< const char *, const bytes_t *, Encoding >, 4 > cases = { {
+        { "decode UTF-8, ASCII",    &ascii_bytes, ENC_UTF8    },
+        { "decode UTF-8, Japanese", &mixed_bytes, ENC_UTF8    },
+        { "decode UTF-16LE",        &utf16le,     ENC_UTF16LE },
+        { "decode UTF-16BE",        &utf16be,     ENC_UTF16BE }
+    } };
+
+    std::vector< wchar_t > out;
+
+    out.reserve( SIZE * 2 );
+
+    for( const auto &[ name, bytes, encoding ] : cases ) {
+        const auto ns = Test::time_ns( 10, [ & ]( size_t ) {
+            out.clear();
+
+            decode( bytes->data(), bytes->size(), encoding, out );
+
+            Test::keep( out.size() );
+        } );
+
+        const auto report_name = std::string( name ) + ", to wchar_t";
+
+        Test::report( report_name.c_str(), (double)bytes->size() / ns * 1e9 / ( 1 << 20 ), "MiB/s" );
+    }
+
+    // the whitespace strip every line goes through, 1 MiB of decoded ASCII
+    std::vector< wchar_t > wide;
+
+    decode( ascii_bytes.data(), ascii_bytes.size(), ENC_UTF8, wide );
+
+    const auto strip_ns = Test::time_ns( 10, [ & ]( size_t ) {
+        auto copy = wide;
+
+        Test::keep( std::remove_if( copy.begin(), copy.end(), []( wchar_t c ) { return INIParser::is_space( (uint32_t)c ); } ) );
+    } );
+
+    Test::report( "whitespace strip, 1 Mi chars", strip_ns / 1e6, "ms" );
+}
+
+int main() {
+    test_detect();
+    test_utf16();
+    test_utf8();
+    test_reader();
+    bench_decode();
+
+    return Test::result();
+}
@@ -0,0 +1,30 @@
+#include "sig_report.h"
+
+//
+// headless signature health report
+// usage: umi_sig_report <builds dir> <report file>
+// maps every .exe under the builds dir and writes one JSON object per line, see SigReport::run
+// exits with 0 if every signature for each detected game resolved and was unique
+//
+
+int main( int argc, char **argv ) {
+    if( argc != 3 ) {
+        std::fprintf( stderr, "usage: %s <builds dir> <report file>\n", argv[ 0 ] );
+
+        return 2;
+    }
+
+    const auto start      = std::chrono::steady_clock::now();
+    const auto failed_amt = SigReport::run( argv[ 1 ], argv[ 2 ] );
+    const auto ms         = std::chrono::duration< double, std::milli >( std::chrono::steady_clock::now() - start ).count();
+
+    if( failed_amt < 0 ) {
+        std::fprintf( stderr, "failed to read \"%s\" or write \"%s\"\n", argv[ 1 ], argv[ 2 ] );
+
+        return 2;
+    }
+
+    std::printf( "%d failed signature(s), %.1f ms\n", failed_amt, ms );
+
+    return failed_amt ? 1 : 0;
+}